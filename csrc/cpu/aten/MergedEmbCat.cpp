@@ -2,6 +2,8 @@
 #include <ATen/Tensor.h>
 #include <torch/all.h>
 
+#include <cmath>
+
 namespace torch_ipex {
 namespace cpu {
 
@@ -9,6 +11,7 @@ using namespace at;
 
 DEFINE_DISPATCH(merged_embeddingbag_cat_fw_stub);
 DEFINE_DISPATCH(qmerged_embeddingbag_cat_fw_stub);
+DEFINE_DISPATCH(rowwise_qmerged_embeddingbag_cat_fw_stub);
 
 Tensor merged_embeddingbag_cat_forward(
     const TensorList& weights,
@@ -30,6 +33,66 @@ Tensor dil_qmerged_embeddingbag_cat(
   return qmerged_embeddingbag_cat_fw_stub(
       kCPU, qweights, indices, offsets, qdense, o_scale);
 }
+
+/**
+ * Quantize an embedding table row by row into the fused layout consumed by
+ * rowwise_qmerged_embeddingbag_cat_forward. Each output row is
+ * [packed values | fp32 scale | fp32 bias] stored as uint8, and
+ * value ~= q * scale + bias with q in [0, 2^bits - 1]. For 4 bits two values
+ * share one byte, low nibble first.
+ */
+Tensor rowwise_quantize_embedding_weight(const Tensor& weight, int64_t bits) {
+  TORCH_CHECK(
+      bits == 4 || bits == 8,
+      "row-wise quantized embedding only supports 4 or 8 bits, got ",
+      bits);
+  TORCH_CHECK(weight.dim() == 2, "expect a 2D embedding weight");
+  auto w = weight.to(at::kFloat).contiguous();
+  const int64_t num_rows = w.size(0);
+  const int64_t emb_dim = w.size(1);
+  const int64_t packed_bytes = bits == 4 ? (emb_dim + 1) / 2 : emb_dim;
+  const int64_t row_bytes = packed_bytes + 2 * sizeof(float);
+  const float levels = float((1 << bits) - 1);
+  Tensor output =
+      at::zeros({num_rows, row_bytes}, w.options().dtype(at::kByte));
+  const float* w_ptr = w.data_ptr<float>();
+  uint8_t* o_ptr = output.data_ptr<uint8_t>();
+  at::parallel_for(0, num_rows, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; ++r) {
+      const float* src = w_ptr + r * emb_dim;
+      uint8_t* dst = o_ptr + r * row_bytes;
+      float min_v = src[0], max_v = src[0];
+      for (int64_t d = 1; d < emb_dim; ++d) {
+        min_v = std::min(min_v, src[d]);
+        max_v = std::max(max_v, src[d]);
+      }
+      const float scale = (max_v - min_v) / levels;
+      const float inv_scale = scale == 0.f ? 0.f : 1.f / scale;
+      for (int64_t d = 0; d < emb_dim; ++d) {
+        float q = std::nearbyint((src[d] - min_v) * inv_scale);
+        uint8_t v = uint8_t(std::min(std::max(q, 0.f), levels));
+        if (bits == 8) {
+          dst[d] = v;
+        } else {
+          dst[d / 2] |= v << ((d & 1) * 4);
+        }
+      }
+      memcpy(dst + packed_bytes, &scale, sizeof(float));
+      memcpy(dst + packed_bytes + sizeof(float), &min_v, sizeof(float));
+    }
+  });
+  return output;
+}
+
+Tensor rowwise_qmerged_embeddingbag_cat_forward(
+    const TensorList& qweights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense,
+    IntArrayRef weight_bits) {
+  return rowwise_qmerged_embeddingbag_cat_fw_stub(
+      kCPU, qweights, indices, offsets, dense, weight_bits);
+}
 } // namespace cpu
 } // namespace torch_ipex
 
@@ -42,6 +105,18 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       "merged_embeddingbag_cat_forward",
       c10::DispatchKey::CPU,
       torch_ipex::cpu::merged_embeddingbag_cat_forward);
+  m.def(
+      "rowwise_quantize_embedding_weight(Tensor weight, int bits) -> Tensor");
+  m.impl(
+      "rowwise_quantize_embedding_weight",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::rowwise_quantize_embedding_weight);
+  m.def(
+      "rowwise_qmerged_embeddingbag_cat_forward(Tensor[] qweights, Tensor[] indices, Tensor[] offsets, Tensor dense, int[] weight_bits) -> Tensor");
+  m.impl(
+      "rowwise_qmerged_embeddingbag_cat_forward",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::rowwise_qmerged_embeddingbag_cat_forward);
 }
 
 } // namespace
\ No newline at end of file
@@ -17,6 +17,15 @@ Tensor dil_qmerged_embeddingbag_cat(
     int64_t o_zp,
     at::ScalarType odtype);
 
+Tensor rowwise_quantize_embedding_weight(const Tensor& weight, int64_t bits);
+
+Tensor rowwise_qmerged_embeddingbag_cat_forward(
+    const TensorList& qweights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense,
+    IntArrayRef weight_bits);
+
 namespace {
 
 Tensor merged_embedding_cat_fw_impl(
@@ -32,6 +41,13 @@ Tensor qmerged_embedding_cat_fw_impl(
     const Tensor& qdense,
     double o_scale);
 
+Tensor rowwise_qmerged_embedding_cat_fw_impl(
+    const TensorList& qweights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense,
+    IntArrayRef weight_bits);
+
 } // namespace
 
 using merged_embeddingbag_cat_fw_fn = Tensor (*)(
@@ -47,6 +63,13 @@ using qmerged_embeddingbag_cat_fw_fn = Tensor (*)(
     const Tensor&,
     double o_scale);
 
+using rowwise_qmerged_embeddingbag_cat_fw_fn = Tensor (*)(
+    const TensorList&,
+    const TensorList&,
+    const TensorList&,
+    const Tensor&,
+    IntArrayRef);
+
 DECLARE_DISPATCH(
     merged_embeddingbag_cat_fw_fn,
     merged_embeddingbag_cat_fw_stub);
@@ -55,5 +78,9 @@ DECLARE_DISPATCH(
     qmerged_embeddingbag_cat_fw_fn,
     qmerged_embeddingbag_cat_fw_stub);
 
+DECLARE_DISPATCH(
+    rowwise_qmerged_embeddingbag_cat_fw_fn,
+    rowwise_qmerged_embeddingbag_cat_fw_stub);
+
 } // namespace cpu
 } // namespace torch_ipex
\ No newline at end of file
@@ -87,6 +87,13 @@ std::vector<Tensor> merged_embeddingbag_forward_cpu_kernel_impl(
     const int64_t pooling_mode,
     const bool include_last_offsets);
 
+std::vector<Tensor> merged_embeddingbag_dedup_forward_cpu_kernel_impl(
+    const std::vector<Tensor>& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const int64_t pooling_mode,
+    const bool include_last_offsets);
+
 std::vector<Tensor> merged_embeddingbag_backward_cpu_kernel_impl(
     const TensorList& grad_outs_,
     const TensorList& weights,
@@ -129,6 +136,9 @@ using merged_embeddingbag_forward_cpu_kernel_fn = std::vector<Tensor> (*)(
 DECLARE_DISPATCH(
     merged_embeddingbag_forward_cpu_kernel_fn,
     merged_embeddingbag_forward_cpu_kernel_stub);
+DECLARE_DISPATCH(
+    merged_embeddingbag_forward_cpu_kernel_fn,
+    merged_embeddingbag_dedup_forward_cpu_kernel_stub);
 
 using merged_embeddingbag_backward_cpu_kernel_fn = std::vector<Tensor> (*)(
     const TensorList&,
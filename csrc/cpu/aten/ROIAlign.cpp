@@ -12,6 +12,7 @@ namespace cpu {
 
 DEFINE_DISPATCH(roi_align_forward_kernel_stub);
 DEFINE_DISPATCH(roi_align_backward_kernel_stub);
+DEFINE_DISPATCH(multi_level_roi_align_kernel_stub);
 
 at::Tensor ROIAlign_forward_impl(
     const at::Tensor& input,
@@ -38,6 +39,35 @@ at::Tensor ROIAlign_forward_impl(
       aligned);
 }
 
+at::Tensor multi_level_roi_align(
+    at::TensorList features,
+    const at::Tensor& rois,
+    at::ArrayRef<double> spatial_scales,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    int64_t canonical_scale,
+    int64_t canonical_level) {
+#if defined(IPEX_DISP_OP)
+  printf("torch_ipex::multi_level_roi_align\n");
+#endif
+  RECORD_FUNCTION(
+      "torch_ipex::multi_level_roi_align", c10::ArrayRef<c10::IValue>({}));
+
+  return multi_level_roi_align_kernel_stub(
+      kCPU,
+      features.vec(),
+      rois,
+      spatial_scales.vec(),
+      pooled_height,
+      pooled_width,
+      sampling_ratio,
+      aligned,
+      canonical_scale,
+      canonical_level);
+}
+
 at::Tensor ROIAlign_backward_impl(
     const at::Tensor& grad,
     const at::Tensor& rois,
@@ -293,6 +323,12 @@ IPEX_TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       "ROIAlign_backward",
       c10::DispatchKey::CPU,
       torch_ipex::cpu::ROIAlign_backward_impl);
+  m.def(
+      "multi_level_roi_align(Tensor[] features, Tensor rois, float[] spatial_scales, int pooled_height, int pooled_width, int sampling_ratio, bool aligned, int canonical_scale=224, int canonical_level=4) -> Tensor");
+  m.impl(
+      "multi_level_roi_align",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::multi_level_roi_align);
 }
 
 IPEX_TORCH_LIBRARY_FRAGMENT(torchvision, m) {
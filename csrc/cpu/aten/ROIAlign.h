@@ -16,6 +16,21 @@ at::Tensor ROIAlign_forward_impl(
     int64_t sampling_ratio,
     bool aligned);
 
+// Inference only RoIAlign over the levels of a feature pyramid (FPN). Each
+// ROI is pooled from the level given by Eqn.(1) of the FPN paper. The output
+// is (num_rois, channels, pooled_height, pooled_width) contiguous, i.e. the
+// flattened input layout of the box head.
+at::Tensor multi_level_roi_align(
+    at::TensorList features,
+    const at::Tensor& rois,
+    at::ArrayRef<double> spatial_scales,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    int64_t canonical_scale,
+    int64_t canonical_level);
+
 at::Tensor ROIAlign_backward_impl(
     const at::Tensor& grad,
     const at::Tensor& rois,
@@ -211,6 +226,17 @@ at::Tensor roi_align_backward_kernel_impl(
     bool aligned,
     bool is_channels_last);
 
+at::Tensor multi_level_roi_align_kernel_impl(
+    const std::vector<at::Tensor>& features,
+    const at::Tensor& rois,
+    const std::vector<double>& spatial_scales,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    int64_t canonical_scale,
+    int64_t canonical_level);
+
 } // namespace
 
 using roi_align_forward_kernel_fn = at::Tensor (*)(
@@ -238,5 +264,19 @@ using roi_align_backward_kernel_fn = at::Tensor (*)(
     bool);
 DECLARE_DISPATCH(roi_align_backward_kernel_fn, roi_align_backward_kernel_stub);
 
+using multi_level_roi_align_kernel_fn = at::Tensor (*)(
+    const std::vector<at::Tensor>&,
+    const at::Tensor&,
+    const std::vector<double>&,
+    int64_t,
+    int64_t,
+    int64_t,
+    bool,
+    int64_t,
+    int64_t);
+DECLARE_DISPATCH(
+    multi_level_roi_align_kernel_fn,
+    multi_level_roi_align_kernel_stub);
+
 } // namespace cpu
 } // namespace torch_ipex
\ No newline at end of file
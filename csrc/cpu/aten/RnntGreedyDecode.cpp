@@ -0,0 +1,200 @@
+#include "RnntGreedyDecode.h"
+#include <ATen/ATen.h>
+#include <ATen/record_function.h>
+#include <c10/util/Exception.h>
+#include <torch/all.h>
+#include "RNN.h"
+#include "RnntEmbedding.h"
+#include "UpdateBatch.h"
+
+namespace torch_ipex {
+namespace cpu {
+
+/*
+  rnnt_greedy_decode: the batched greedy decoder of RNN-T as one op. Each loop
+  runs the prediction network (rnnt_embedding + ipex_lstm), the joint network,
+  the argmax over the vocabulary and rnnt_update_batch, until every sample has
+  consumed all its valid time steps. There is no Python control flow and no
+  per-symbol dispatcher overhead inside the loop.
+
+  x: the encoder output already projected by the encoder side linear of the
+    joint network, [batch_size, time_step, joint_n_hidden], f32 or bf16.
+    A transposed view of a [time_step, batch_size, joint_n_hidden] tensor is
+    used without copy.
+  out_lens: valid time step of x, [batch_size]
+  embedding_table: weight of the embedding of the prediction network
+  lstm_params: flattened weights of the LSTM of the prediction network, in
+    the order of torch.nn.LSTM._flat_weights
+  joint_pred_weight, joint_pred_bias: prediction side linear of the joint
+    network
+  joint_weight, joint_bias: the last linear of the joint network,
+    logits = linear(relu(f + g))
+
+  Returns (label_tensor, label_len): the labels of sample i are
+  label_tensor[i, 1 : label_len[i] + 1].
+*/
+std::tuple<at::Tensor, at::Tensor> rnnt_greedy_decode(
+    const at::Tensor& x,
+    const at::Tensor& out_lens,
+    const at::Tensor& embedding_table,
+    std::vector<at::Tensor> lstm_params,
+    bool lstm_has_biases,
+    int64_t lstm_num_layers,
+    const at::Tensor& joint_pred_weight,
+    const c10::optional<at::Tensor>& joint_pred_bias,
+    const at::Tensor& joint_weight,
+    const c10::optional<at::Tensor>& joint_bias,
+    int64_t max_symbols,
+    int64_t blank_id,
+    int64_t _SOS) {
+#if defined(IPEX_DISP_OP)
+  printf("IPEX::rnnt_greedy_decode\n");
+#endif
+  RECORD_FUNCTION("IPEX::rnnt_greedy_decode", c10::ArrayRef<c10::IValue>({}));
+
+  TORCH_CHECK(
+      x.dim() == 3,
+      "rnnt_greedy_decode: x should be [batch_size, time_step, feature_size]");
+  TORCH_CHECK(
+      x.scalar_type() == at::kFloat || x.scalar_type() == at::kBFloat16,
+      "rnnt_greedy_decode: only support x to be float or bf16 tensor");
+  TORCH_CHECK(
+      out_lens.dim() == 1 && out_lens.size(0) == x.size(0),
+      "rnnt_greedy_decode: out_lens should be [batch_size]");
+  TORCH_CHECK(
+      lstm_num_layers > 0 &&
+          static_cast<int64_t>(lstm_params.size()) ==
+              lstm_num_layers * (lstm_has_biases ? 4 : 2),
+      "rnnt_greedy_decode: unexpected number of lstm_params");
+  TORCH_CHECK(max_symbols > 0, "rnnt_greedy_decode: max_symbols should be > 0");
+
+  at::NoGradGuard no_grad;
+  int64_t batch_size = x.size(0);
+  int64_t embedding_dim = embedding_table.size(1);
+  // weight_hh_l0: [4 * hidden_size, hidden_size]
+  int64_t hidden_size = lstm_params[1].size(1);
+
+  auto out_lens_ = out_lens.to(at::kInt).contiguous();
+  int64_t max_len = batch_size > 0 ? out_lens_.max().item<int64_t>() : 0;
+  TORCH_CHECK(
+      batch_size > 0 && max_len > 0,
+      "rnnt_greedy_decode: expect non-empty batch and out_lens");
+  TORCH_CHECK(
+      max_len <= x.size(1),
+      "rnnt_greedy_decode: out_lens exceeds the time steps of x");
+
+  // rnnt_update_batch fetches the feature of the next time step from x in
+  // [time_step, batch_size, feature_size] memory layout. It also uses
+  // max_len * max_symbols as the row stride of label_tensor, one label short
+  // when a sample emits max_symbols labels at each of its time steps, so one
+  // padding time step is added to max_len.
+  at::Tensor x_tbf = x.transpose(0, 1);
+  if (x_tbf.size(0) == max_len) {
+    x_tbf = at::cat(
+        {x_tbf, at::zeros({1, batch_size, x.size(2)}, x.options())}, 0);
+  }
+  at::Tensor x_ = x_tbf.contiguous().transpose(0, 1);
+  int64_t padded_len = max_len + 1;
+
+  auto int_opts = x.options().dtype(at::kInt);
+  auto long_opts = x.options().dtype(at::kLong);
+  // column 0 holds _SOS, the labels start from column 1
+  at::Tensor label_tensor =
+      at::full({batch_size, padded_len * max_symbols}, _SOS, long_opts);
+  at::Tensor label_col = at::zeros({batch_size}, int_opts);
+  at::Tensor f = x_.select(1, 0).clone(at::MemoryFormat::Contiguous);
+
+  at::Tensor symbols_added = at::zeros({batch_size}, int_opts);
+  at::Tensor time_idxs = at::zeros({batch_size}, int_opts);
+  at::Tensor blankness = at::zeros({batch_size}, int_opts);
+  at::Tensor blankvec = at::zeros({batch_size}, int_opts);
+  at::Tensor not_blank = at::zeros({batch_size}, int_opts);
+  at::Tensor label_to_put = at::zeros({batch_size}, long_opts);
+  at::Tensor label_for_next_loop = at::full({batch_size}, _SOS, long_opts);
+  at::Tensor hidden_0 =
+      at::zeros({lstm_num_layers, batch_size, hidden_size}, x.options());
+  at::Tensor hidden_1 = at::zeros_like(hidden_0);
+  at::Tensor embedding_out =
+      at::empty({batch_size, 1, embedding_dim}, embedding_table.options());
+
+  while (true) {
+    // prediction network: g, hidden_prime = pred(label_for_next_loop, hidden)
+    rnnt_embedding_kernel_stub(
+        kCPU,
+        embedding_table,
+        label_for_next_loop,
+        embedding_out,
+        _SOS,
+        batch_size,
+        embedding_dim);
+    auto lstm_out = torch_ipex::ipex_lstm(
+        embedding_out,
+        {hidden_0, hidden_1},
+        lstm_params,
+        lstm_has_biases,
+        lstm_num_layers,
+        /*dropout_p*/ 0.,
+        /*train*/ false,
+        /*bidirectional*/ false,
+        /*batch_first*/ true);
+    auto g = at::linear(
+        std::get<0>(lstm_out).squeeze(1), joint_pred_weight, joint_pred_bias);
+    auto hidden_prime_0 =
+        std::get<1>(lstm_out).to(hidden_0.scalar_type()).contiguous();
+    auto hidden_prime_1 =
+        std::get<2>(lstm_out).to(hidden_1.scalar_type()).contiguous();
+
+    // joint network and greedy search, log_softmax is skipped since it
+    // doesn't change the argmax
+    auto logits = at::linear(at::relu_(f + g), joint_weight, joint_bias);
+    auto k = logits.argmax(1);
+
+    bool finished = rnnt_update_batch_kernel_stub(
+        kCPU,
+        k,
+        out_lens_,
+        label_col,
+        symbols_added,
+        time_idxs,
+        blankness,
+        blankvec,
+        not_blank,
+        label_to_put,
+        label_tensor,
+        label_for_next_loop,
+        hidden_0,
+        hidden_1,
+        hidden_prime_0,
+        hidden_prime_1,
+        x_,
+        f,
+        max_symbols,
+        blank_id,
+        batch_size,
+        _SOS,
+        padded_len);
+    if (finished == BatchStatus::Finished)
+      break;
+  }
+  return std::make_tuple(label_tensor, label_col.to(at::kLong));
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "rnnt_greedy_decode(Tensor x, Tensor out_lens, Tensor embedding_table, "
+      "Tensor[] lstm_params, bool lstm_has_biases, int lstm_num_layers, "
+      "Tensor joint_pred_weight, Tensor? joint_pred_bias, Tensor "
+      "joint_weight, Tensor? joint_bias, int max_symbols, int blank_id, "
+      "int _SOS=-1) -> (Tensor, Tensor)");
+  m.impl(
+      "rnnt_greedy_decode",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::rnnt_greedy_decode);
+}
+
+} // namespace
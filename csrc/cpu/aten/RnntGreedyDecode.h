@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+
+#include <vector>
+
+namespace torch_ipex {
+namespace cpu {
+
+std::tuple<at::Tensor, at::Tensor> rnnt_greedy_decode(
+    const at::Tensor& x,
+    const at::Tensor& out_lens,
+    const at::Tensor& embedding_table,
+    std::vector<at::Tensor> lstm_params,
+    bool lstm_has_biases,
+    int64_t lstm_num_layers,
+    const at::Tensor& joint_pred_weight,
+    const c10::optional<at::Tensor>& joint_pred_bias,
+    const at::Tensor& joint_weight,
+    const c10::optional<at::Tensor>& joint_bias,
+    int64_t max_symbols,
+    int64_t blank_id,
+    int64_t _SOS);
+
+} // namespace cpu
+} // namespace torch_ipex
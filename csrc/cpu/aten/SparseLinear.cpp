@@ -0,0 +1,310 @@
+#include "SparseLinear.h"
+
+#include <ATen/Parallel.h>
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace torch_ipex {
+namespace cpu {
+
+DEFINE_DISPATCH(sparse_linear_block_kernel_stub);
+DEFINE_DISPATCH(sparse_linear_two_four_kernel_stub);
+
+SparseLinearFormat sparse_linear_format_from_string(const std::string& format) {
+  if (format == "block") {
+    return SparseLinearFormat::BLOCK;
+  }
+  TORCH_CHECK(
+      format == "2:4",
+      "sparse_linear: unknown sparse format ",
+      format,
+      ", expected block or 2:4");
+  return SparseLinearFormat::TWO_FOUR;
+}
+
+const char* sparse_linear_format_to_string(SparseLinearFormat format) {
+  switch (format) {
+    case SparseLinearFormat::BLOCK:
+      return "block";
+    case SparseLinearFormat::TWO_FOUR:
+      return "2:4";
+  }
+  return "unknown";
+}
+
+static void check_sparse_linear_weight(const at::Tensor& weight) {
+  TORCH_CHECK(
+      weight.dim() == 2, "sparse_linear: expected a 2D weight of the linear");
+  TORCH_CHECK(
+      weight.scalar_type() == at::kFloat ||
+          weight.scalar_type() == at::kBFloat16,
+      "sparse_linear: only float and bfloat16 weights are supported, got ",
+      weight.scalar_type());
+}
+
+template <typename T>
+static bool block_has_nonzero(
+    const T* weight,
+    int64_t N,
+    int64_t K,
+    int64_t nb,
+    int64_t kb) {
+  int64_t n_end = std::min((nb + 1) * SPARSE_BLOCK_N, N);
+  int64_t k_end = std::min((kb + 1) * SPARSE_BLOCK_K, K);
+  for (int64_t n = nb * SPARSE_BLOCK_N; n < n_end; n++) {
+    for (int64_t k = kb * SPARSE_BLOCK_K; k < k_end; k++) {
+      if (static_cast<float>(weight[n * K + k]) != 0.f) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+double get_block_sparsity(const at::Tensor& weight) {
+  check_sparse_linear_weight(weight);
+  auto weight_ = weight.contiguous();
+  int64_t N = weight_.size(0);
+  int64_t K = weight_.size(1);
+  int64_t out_blocks = at::divup(N, SPARSE_BLOCK_N);
+  int64_t in_blocks = at::divup(K, SPARSE_BLOCK_K);
+  if (out_blocks * in_blocks == 0) {
+    return 0;
+  }
+  std::vector<int64_t> zero_blocks(out_blocks, 0);
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::kBFloat16, weight_.scalar_type(), "get_block_sparsity", [&] {
+        const scalar_t* w = weight_.data_ptr<scalar_t>();
+        at::parallel_for(0, out_blocks, 1, [&](int64_t begin, int64_t end) {
+          for (const auto nb : c10::irange(begin, end)) {
+            for (const auto kb : c10::irange(in_blocks)) {
+              if (!block_has_nonzero(w, N, K, nb, kb)) {
+                zero_blocks[nb]++;
+              }
+            }
+          }
+        });
+      });
+  int64_t num_zero_blocks =
+      std::accumulate(zero_blocks.begin(), zero_blocks.end(), int64_t(0));
+  return static_cast<double>(num_zero_blocks) / (out_blocks * in_blocks);
+}
+
+bool is_two_four_sparse(const at::Tensor& weight) {
+  check_sparse_linear_weight(weight);
+  if (weight.size(1) % 4 != 0) {
+    return false;
+  }
+  // the nonzeros of every group of 4 inputs
+  auto nonzeros = weight.ne(0).reshape({weight.size(0), -1, 4}).sum(-1);
+  return nonzeros.le(2).all().item<bool>();
+}
+
+template <typename T>
+static std::vector<at::Tensor> pack_block(const at::Tensor& weight) {
+  int64_t N = weight.size(0);
+  int64_t K = weight.size(1);
+  int64_t out_blocks = at::divup(N, SPARSE_BLOCK_N);
+  int64_t in_blocks = at::divup(K, SPARSE_BLOCK_K);
+  const T* w = weight.data_ptr<T>();
+
+  auto row_ptr = at::empty({out_blocks + 1}, at::kLong);
+  auto row_ptr_data = row_ptr.data_ptr<int64_t>();
+  std::vector<int32_t> block_cols;
+  for (const auto nb : c10::irange(out_blocks)) {
+    row_ptr_data[nb] = block_cols.size();
+    for (const auto kb : c10::irange(in_blocks)) {
+      if (block_has_nonzero(w, N, K, nb, kb)) {
+        block_cols.push_back(kb);
+      }
+    }
+  }
+  int64_t nnz_blocks = block_cols.size();
+  row_ptr_data[out_blocks] = nnz_blocks;
+
+  auto indices = at::empty({nnz_blocks}, at::kInt);
+  std::copy(block_cols.begin(), block_cols.end(), indices.data_ptr<int32_t>());
+  // the outputs past N and the inputs past K of the last blocks are zeros
+  auto values = at::zeros(
+      {nnz_blocks, SPARSE_BLOCK_K, SPARSE_BLOCK_N}, weight.options());
+  auto v = values.data_ptr<T>();
+  at::parallel_for(0, out_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (const auto nb : c10::irange(begin, end)) {
+      int64_t n_end = std::min((nb + 1) * SPARSE_BLOCK_N, N);
+      for (int64_t j = row_ptr_data[nb]; j < row_ptr_data[nb + 1]; j++) {
+        int64_t kb = block_cols[j];
+        int64_t k_end = std::min((kb + 1) * SPARSE_BLOCK_K, K);
+        T* blk = v + j * SPARSE_BLOCK_K * SPARSE_BLOCK_N;
+        for (int64_t n = nb * SPARSE_BLOCK_N; n < n_end; n++) {
+          for (int64_t k = kb * SPARSE_BLOCK_K; k < k_end; k++) {
+            blk[(k % SPARSE_BLOCK_K) * SPARSE_BLOCK_N + n % SPARSE_BLOCK_N] =
+                w[n * K + k];
+          }
+        }
+      }
+    }
+  });
+  return {values, indices, row_ptr};
+}
+
+template <typename T>
+static std::vector<at::Tensor> pack_two_four(const at::Tensor& weight) {
+  int64_t N = weight.size(0);
+  int64_t K = weight.size(1);
+  int64_t out_blocks = at::divup(N, SPARSE_BLOCK_N);
+  const T* w = weight.data_ptr<T>();
+
+  // the slots of the groups with less than 2 nonzeros and the outputs past N
+  // are zeros
+  auto values =
+      at::zeros({out_blocks, K / 2, SPARSE_BLOCK_N}, weight.options());
+  auto indices = at::zeros({out_blocks, K / 2, SPARSE_BLOCK_N}, at::kByte);
+  auto v = values.data_ptr<T>();
+  auto idx = indices.data_ptr<uint8_t>();
+  at::parallel_for(0, N, 1, [&](int64_t begin, int64_t end) {
+    for (const auto n : c10::irange(begin, end)) {
+      int64_t nb = n / SPARSE_BLOCK_N;
+      int64_t lane = n % SPARSE_BLOCK_N;
+      for (int64_t g = 0; g < K / 4; g++) {
+        int64_t slot = 0;
+        for (int64_t i = 0; i < 4 && slot < 2; i++) {
+          T value = w[n * K + g * 4 + i];
+          if (static_cast<float>(value) != 0.f) {
+            int64_t offset =
+                (nb * (K / 2) + g * 2 + slot) * SPARSE_BLOCK_N + lane;
+            v[offset] = value;
+            idx[offset] = i;
+            slot++;
+          }
+        }
+      }
+    }
+  });
+  return {values, indices, at::Tensor()};
+}
+
+std::vector<at::Tensor> sparse_linear_pack(
+    const at::Tensor& weight,
+    SparseLinearFormat format) {
+  check_sparse_linear_weight(weight);
+  auto weight_ = weight.contiguous();
+  if (format == SparseLinearFormat::TWO_FOUR) {
+    TORCH_CHECK(
+        is_two_four_sparse(weight_),
+        "sparse_linear: the weight is not 2:4 sparse, every 4 consecutive "
+        "input features need at most 2 nonzeros");
+  }
+  std::vector<at::Tensor> packed;
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::kBFloat16, weight_.scalar_type(), "sparse_linear_pack", [&] {
+        packed = format == SparseLinearFormat::BLOCK
+            ? pack_block<scalar_t>(weight_)
+            : pack_two_four<scalar_t>(weight_);
+      });
+  return packed;
+}
+
+template <typename T>
+static void unpack_block(
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    at::Tensor& weight) {
+  int64_t N = weight.size(0);
+  int64_t K = weight.size(1);
+  const T* v = values.data_ptr<T>();
+  const int32_t* cols = indices.data_ptr<int32_t>();
+  const int64_t* row_ptr_data = row_ptr.data_ptr<int64_t>();
+  T* w = weight.data_ptr<T>();
+  for (const auto nb : c10::irange(row_ptr.numel() - 1)) {
+    int64_t n_end = std::min((nb + 1) * SPARSE_BLOCK_N, N);
+    for (int64_t j = row_ptr_data[nb]; j < row_ptr_data[nb + 1]; j++) {
+      int64_t kb = cols[j];
+      int64_t k_end = std::min((kb + 1) * SPARSE_BLOCK_K, K);
+      const T* blk = v + j * SPARSE_BLOCK_K * SPARSE_BLOCK_N;
+      for (int64_t n = nb * SPARSE_BLOCK_N; n < n_end; n++) {
+        for (int64_t k = kb * SPARSE_BLOCK_K; k < k_end; k++) {
+          w[n * K + k] =
+              blk[(k % SPARSE_BLOCK_K) * SPARSE_BLOCK_N + n % SPARSE_BLOCK_N];
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+static void unpack_two_four(
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    at::Tensor& weight) {
+  int64_t N = weight.size(0);
+  int64_t K = weight.size(1);
+  const T* v = values.data_ptr<T>();
+  const uint8_t* idx = indices.data_ptr<uint8_t>();
+  T* w = weight.data_ptr<T>();
+  for (const auto n : c10::irange(N)) {
+    int64_t nb = n / SPARSE_BLOCK_N;
+    int64_t lane = n % SPARSE_BLOCK_N;
+    for (int64_t s = 0; s < K / 2; s++) {
+      int64_t offset = (nb * (K / 2) + s) * SPARSE_BLOCK_N + lane;
+      if (static_cast<float>(v[offset]) != 0.f) {
+        w[n * K + (s / 2) * 4 + idx[offset]] = v[offset];
+      }
+    }
+  }
+}
+
+at::Tensor sparse_linear_unpack(
+    SparseLinearFormat format,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    int64_t out_features,
+    int64_t in_features) {
+  auto weight = at::zeros({out_features, in_features}, values.options());
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::kBFloat16, values.scalar_type(), "sparse_linear_unpack", [&] {
+        if (format == SparseLinearFormat::BLOCK) {
+          unpack_block<scalar_t>(values, indices, row_ptr, weight);
+        } else {
+          unpack_two_four<scalar_t>(values, indices, weight);
+        }
+      });
+  return weight;
+}
+
+at::Tensor sparse_linear_forward(
+    const at::Tensor& input,
+    SparseLinearFormat format,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    const at::Tensor& bias,
+    int64_t out_features) {
+  TORCH_CHECK(
+      input.scalar_type() == values.scalar_type(),
+      "sparse_linear: expected the input of ",
+      values.scalar_type(),
+      " as the weight, but got ",
+      input.scalar_type());
+  int64_t K = input.size(-1);
+  // the kernels read the input in float, it is converted once here instead
+  // of for every output block
+  auto input_ = input.reshape({-1, K}).to(at::kFloat).contiguous();
+  auto output_sizes = input.sizes().vec();
+  output_sizes.back() = out_features;
+  auto output = at::empty({input_.size(0), out_features}, input.options());
+  if (format == SparseLinearFormat::BLOCK) {
+    sparse_linear_block_kernel_stub(
+        kCPU, input_, values, indices, row_ptr, bias, output);
+  } else {
+    sparse_linear_two_four_kernel_stub(
+        kCPU, input_, values, indices, bias, output);
+  }
+  return output.view(output_sizes);
+}
+
+} // namespace cpu
+} // namespace torch_ipex
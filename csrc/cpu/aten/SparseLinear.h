@@ -0,0 +1,117 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <dyndisp/DispatchStub.h>
+
+#include <string>
+#include <vector>
+
+namespace torch_ipex {
+namespace cpu {
+
+// Packed sparse weights of the linear, [out_features, in_features]:
+//
+// block: BCSR of blocks of SPARSE_BLOCK_N output x SPARSE_BLOCK_K input
+// features, the blocking of the TPP linear (BrgemmTPP with bk 16, bc 64).
+// Only the blocks with a nonzero are stored, as [K][N] so a row of the block
+// is one vector of the outputs.
+//   values:  [nnz blocks, SPARSE_BLOCK_K, SPARSE_BLOCK_N]
+//   indices: int32 [nnz blocks], the block column (input block) of each block
+//   row_ptr: int64 [out blocks + 1], the blocks of output block nb are
+//            row_ptr[nb] to row_ptr[nb + 1]
+//
+// 2:4: at most 2 nonzeros in every 4 consecutive input features, the two
+// slots of each group are stored with their position in the group for each
+// of the SPARSE_BLOCK_N outputs of a block.
+//   values:  [out blocks, in_features / 2, SPARSE_BLOCK_N]
+//   indices: uint8 [out blocks, in_features / 2, SPARSE_BLOCK_N], 0 to 3
+//
+// The output features are padded up to SPARSE_BLOCK_N with zeros, the input
+// features of the last block are not padded.
+constexpr int64_t SPARSE_BLOCK_N = 16;
+constexpr int64_t SPARSE_BLOCK_K = 64;
+
+enum class SparseLinearFormat : int64_t {
+  BLOCK = 0,
+  TWO_FOUR = 1,
+};
+
+SparseLinearFormat sparse_linear_format_from_string(const std::string& format);
+const char* sparse_linear_format_to_string(SparseLinearFormat format);
+
+// The fraction of the SPARSE_BLOCK_N x SPARSE_BLOCK_K blocks of the weight
+// that are all zeros.
+double get_block_sparsity(const at::Tensor& weight);
+
+// Whether every 4 consecutive input features of the weight have at most 2
+// nonzeros.
+bool is_two_four_sparse(const at::Tensor& weight);
+
+// {values, indices, row_ptr}, row_ptr is undefined for 2:4.
+std::vector<at::Tensor> sparse_linear_pack(
+    const at::Tensor& weight,
+    SparseLinearFormat format);
+
+// The dense [out_features, in_features] weight of the packed one.
+at::Tensor sparse_linear_unpack(
+    SparseLinearFormat format,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    int64_t out_features,
+    int64_t in_features);
+
+// input: [..., in_features] of the dtype of the values, bias: float
+// [padded out_features] or undefined.
+at::Tensor sparse_linear_forward(
+    const at::Tensor& input,
+    SparseLinearFormat format,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    const at::Tensor& bias,
+    int64_t out_features);
+
+namespace {
+
+void sparse_linear_block_kernel_impl(
+    const at::Tensor& input,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    const at::Tensor& bias,
+    at::Tensor& output);
+
+void sparse_linear_two_four_kernel_impl(
+    const at::Tensor& input,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& bias,
+    at::Tensor& output);
+
+} // namespace
+
+using sparse_linear_block_kernel_fn = void (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    at::Tensor&);
+
+using sparse_linear_two_four_kernel_fn = void (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    at::Tensor&);
+
+DECLARE_DISPATCH(
+    sparse_linear_block_kernel_fn,
+    sparse_linear_block_kernel_stub);
+DECLARE_DISPATCH(
+    sparse_linear_two_four_kernel_fn,
+    sparse_linear_two_four_kernel_stub);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -13,7 +13,7 @@ namespace cpu {
 
 namespace {
 
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
 template <typename T, typename T1>
 void AddLayerNormKernelImpl(
     const at::Tensor& a,
@@ -66,7 +66,7 @@ at::Tensor add_layer_norm_kernel_impl(
     const c10::optional<at::Tensor>& weight_opt,
     const c10::optional<at::Tensor>& bias_opt,
     float eps) {
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
   c10::MaybeOwned<Tensor> weight_maybe_owned =
       at::borrow_from_optional_tensor(weight_opt);
   const at::Tensor& weight = *weight_maybe_owned;
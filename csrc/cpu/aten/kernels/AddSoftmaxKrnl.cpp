@@ -6,7 +6,7 @@ namespace cpu {
 
 namespace {
 
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
 using namespace torch_ipex::cpu::kernel;
 
 inline int64_t _calc_element_offset(
@@ -245,7 +245,7 @@ at::Tensor div_add_softmax_kernel_impl(
     at::Tensor& a,
     const at::Tensor& b,
     const float& dim_per_head) {
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
   if (a.scalar_type() == at::kFloat && b.scalar_type() == at::kFloat) {
     return dil_div_add_softmax<float>(a, b, dim_per_head);
   } else if (
@@ -262,7 +262,7 @@ at::Tensor div_add_softmax_kernel_impl(
 at::Tensor& add_softmax_inplace_kernel_impl(
     at::Tensor& a,
     const at::Tensor& b) {
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
   if (a.scalar_type() == at::kFloat && b.scalar_type() == at::kFloat) {
     return dil_add_softmax_(a, b);
   }
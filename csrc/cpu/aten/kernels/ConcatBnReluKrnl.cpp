@@ -8,7 +8,7 @@ namespace cpu {
 
 namespace {
 
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
 //  All the fusion conditions have been applied before calling this kernel.
 //  Please refer ../../jit/cpu/passes/graph_rewrite.cpp for details.
 template <typename T>
@@ -90,7 +90,7 @@ at::Tensor concat_bn_relu_kernel_impl(
       }
     }
   }
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
   if (tensor_check) {
     at::Tensor output;
     if (a[0].scalar_type() == at::kBFloat16) {
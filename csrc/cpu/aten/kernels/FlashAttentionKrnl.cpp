@@ -14,7 +14,7 @@ namespace {
 const int64_t qsplit_size = 384;
 const int64_t kvsplit_size = 512;
 
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
 using namespace torch_ipex::cpu::kernel;
 
 template <typename scalar_t>
@@ -193,7 +193,7 @@ at::Tensor flash_attention_kernel_impl(
       attention_mask.size(1) == 1,
       "Attetntion mask size(1) != 1 for ipex::flash_attention_kernel_impl");
 
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
   int64_t batchSize = query.size(0);
   int64_t qSize = query.size(1);
   int64_t kvSize = value.size(1);
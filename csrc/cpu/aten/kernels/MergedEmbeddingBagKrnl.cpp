@@ -599,8 +599,190 @@ std::vector<Tensor> merged_embeddingbag_forward_cpu_kernel_impl(
   return outputs;
 }
 
+// Build the unique row list of one table (in first-occurrence order) and
+// the inverse map from every position in `indices` to its unique slot.
+// A linear probing hash table keeps the pre-pass O(n).
+template <typename index_t>
+int64_t dedup_indices(
+    const index_t* indices,
+    const int64_t n,
+    index_t* unique,
+    index_t* inverse) {
+  int64_t capacity = 16;
+  int shift = 60;
+  while (capacity < 2 * n) {
+    capacity <<= 1;
+    shift--;
+  }
+  const int64_t mask = capacity - 1;
+  std::vector<index_t> keys(capacity, -1);
+  std::vector<index_t> slots(capacity);
+  int64_t n_unique = 0;
+  for (int64_t j = 0; j < n; ++j) {
+    const index_t key = indices[j];
+    // fibonacci hashing spreads the (often dense) row ids over the table
+    int64_t h = (uint64_t(key) * 0x9E3779B97F4A7C15ULL) >> shift;
+    while (keys[h] != -1 && keys[h] != key) {
+      h = (h + 1) & mask;
+    }
+    if (keys[h] == -1) {
+      keys[h] = key;
+      slots[h] = n_unique;
+      unique[n_unique++] = key;
+    }
+    inverse[j] = slots[h];
+  }
+  return n_unique;
+}
+
+template <typename data_t, typename index_t>
+inline void gather_unique_rows(
+    const int64_t u_begin,
+    const int64_t u_end,
+    const int64_t n_unique,
+    const int64_t emb_dim,
+    const index_t* unique,
+    const data_t* weight,
+    data_t* compact) {
+  // rows are scattered over the table, prefetch a few rows ahead so the
+  // copy does not stall on every row
+  constexpr int64_t prefetch_dist = 8;
+  const int64_t row_bytes = emb_dim * sizeof(data_t);
+  for (int64_t u = u_begin; u < u_end; ++u) {
+    if (u + prefetch_dist < n_unique) {
+      const char* next =
+          (const char*)&weight[unique[u + prefetch_dist] * emb_dim];
+      for (int64_t line = 0; line < row_bytes; line += 64) {
+        _mm_prefetch(next + line, _MM_HINT_T0);
+      }
+    }
+    memcpy(&compact[u * emb_dim], &weight[unique[u] * emb_dim], row_bytes);
+  }
+}
+
+std::vector<Tensor> merged_embeddingbag_dedup_forward_cpu_kernel_impl(
+    const std::vector<Tensor>& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const int64_t pooling_mode,
+    const bool include_last_offsets) {
+  RECORD_FUNCTION(__FUNCTION__, c10::ArrayRef<c10::IValue>({}));
+
+  int64_t num_emb = weights.size();
+
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb > 0);
+  int64_t batch_size = offsets[0].size(0);
+  if (include_last_offsets) {
+    batch_size -= 1;
+  }
+  int64_t emb_dim = weights[0].size(1);
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb == indices.size());
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb == offsets.size());
+
+  auto index_type = indices[0].scalar_type();
+  auto data_type = weights[0].scalar_type();
+
+  std::vector<int64_t> last_offsets(num_emb, -1);
+  std::vector<int64_t> n_unique(num_emb, 0);
+  std::vector<Tensor> outputs;
+  std::vector<Tensor> uniques;
+  std::vector<Tensor> inverses;
+
+  for (int i = 0; i < num_emb; i++) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        indices[i].is_contiguous() && indices[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        offsets[i].is_contiguous() && offsets[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        weights[i].is_contiguous() && weights[i].scalar_type() == data_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        weights[i].dim() == 2 && weights[i].size(1) == emb_dim);
+    // handle last offsets
+    last_offsets[i] = indices[i].numel();
+    outputs.emplace_back(empty({batch_size, emb_dim}, weights[i].options()));
+    uniques.emplace_back(empty_like(indices[i]));
+    inverses.emplace_back(empty_like(indices[i]));
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::kBFloat16,
+      at::kHalf,
+      weights[0].scalar_type(),
+      "merged_embeddingbag_dedup",
+      [&] {
+        AT_DISPATCH_INDEX_TYPES(
+            indices[0].scalar_type(), "merged_embeddingbag_dedup", [&] {
+              // 1. deduplicate indices of every table over the whole batch
+              at::parallel_for(0, num_emb, 1, [&](int64_t begin, int64_t end) {
+                for (int64_t m = begin; m < end; ++m) {
+                  n_unique[m] = dedup_indices<index_t>(
+                      indices[m].data_ptr<index_t>(),
+                      indices[m].numel(),
+                      uniques[m].data_ptr<index_t>(),
+                      inverses[m].data_ptr<index_t>());
+                }
+              });
+
+              // 2. gather every unique row once into a compact table
+              std::vector<Tensor> compacts;
+              int64_t max_unique = 0;
+              for (int i = 0; i < num_emb; i++) {
+                compacts.emplace_back(
+                    empty({n_unique[i], emb_dim}, weights[i].options()));
+                max_unique = std::max(max_unique, n_unique[i]);
+              }
+              constexpr int64_t u_block = 256;
+              const int64_t n_u_blocks = (max_unique - 1) / u_block + 1;
+#pragma omp parallel for collapse(2)
+              for (int64_t m = 0; m < num_emb; ++m) {
+                for (int64_t ub = 0; ub < n_u_blocks; ++ub) {
+                  const int64_t u_begin = ub * u_block;
+                  if (u_begin >= n_unique[m]) {
+                    continue;
+                  }
+                  gather_unique_rows(
+                      u_begin,
+                      std::min(n_unique[m], u_begin + u_block),
+                      n_unique[m],
+                      emb_dim,
+                      uniques[m].data_ptr<index_t>(),
+                      weights[m].data_ptr<scalar_t>(),
+                      compacts[m].data_ptr<scalar_t>());
+                }
+              }
+
+              // 3. pool the bags from the cache resident compact tables
+              scalar_t* compacts_ptr[num_emb];
+              scalar_t* outputs_ptr[num_emb];
+              index_t* inverses_ptr[num_emb];
+              index_t* offsets_ptr[num_emb];
+              for (int i = 0; i < num_emb; i++) {
+                compacts_ptr[i] = compacts[i].data_ptr<scalar_t>();
+                outputs_ptr[i] = outputs[i].data_ptr<scalar_t>();
+                inverses_ptr[i] = inverses[i].data_ptr<index_t>();
+                offsets_ptr[i] = offsets[i].data_ptr<index_t>();
+              }
+              merged_embeddingbag<scalar_t, index_t>(
+                  outputs_ptr,
+                  compacts_ptr,
+                  inverses_ptr,
+                  offsets_ptr,
+                  batch_size,
+                  num_emb,
+                  emb_dim,
+                  last_offsets,
+                  pooling_mode);
+            });
+      });
+
+  return outputs;
+}
+
 } // anonymous namespace
 
+REGISTER_DISPATCH(
+    merged_embeddingbag_dedup_forward_cpu_kernel_stub,
+    &merged_embeddingbag_dedup_forward_cpu_kernel_impl);
 REGISTER_DISPATCH(
     merged_embeddingbag_forward_cpu_kernel_stub,
     &merged_embeddingbag_forward_cpu_kernel_impl);
@@ -1,5 +1,6 @@
 // Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec/vec.h>
 #include <c10/util/Exception.h>
 #include <immintrin.h>
 #include <torch/csrc/autograd/function.h>
@@ -380,6 +381,71 @@ std::vector<at::Tensor> remove_empty(
   return valid_candidate;
 }
 
+// Per thread scratch of batch_score_nms_kernel, reused across classes and
+// calls to avoid allocating tensors inside the parallel loop.
+template <typename scalar_t>
+struct BatchScoreNmsScratch {
+  // (score, box index) of the boxes above the score threshold
+  std::vector<std::pair<scalar_t, int64_t>> candidates;
+  // Coordinates and areas of the kept boxes (SoA for the vectorized IoU)
+  std::vector<scalar_t> x1, y1, x2, y2, areas;
+
+  void reserve(int64_t ndets, int64_t max_output) {
+    candidates.reserve(ndets);
+    x1.resize(max_output);
+    y1.resize(max_output);
+    x2.resize(max_output);
+    y2.resize(max_output);
+    areas.resize(max_output);
+  }
+};
+
+// Whether the box overlaps (IoU >= threshold) any of the num_kept kept boxes.
+// IoU is calculated with bias = 0 as SSD-Resnet34.
+template <typename scalar_t>
+inline bool overlap_kept_boxes(
+    const BatchScoreNmsScratch<scalar_t>& kept,
+    int64_t num_kept,
+    const scalar_t* box,
+    scalar_t area,
+    float threshold) {
+  using Vec = at::vec::Vectorized<scalar_t>;
+  const Vec zero_vec(scalar_t(0));
+  const Vec threshold_vec(scalar_t{threshold});
+  const Vec bx1(box[0]), by1(box[1]), bx2(box[2]), by2(box[3]);
+  const Vec barea(area);
+  constexpr int64_t kVecSize = Vec::size();
+  constexpr int kAllZeroMask = (1 << kVecSize) - 1;
+  int64_t d = 0;
+  for (; d <= num_kept - kVecSize; d += kVecSize) {
+    auto xx1 = at::vec::maximum(bx1, Vec::loadu(kept.x1.data() + d));
+    auto yy1 = at::vec::maximum(by1, Vec::loadu(kept.y1.data() + d));
+    auto xx2 = at::vec::minimum(bx2, Vec::loadu(kept.x2.data() + d));
+    auto yy2 = at::vec::minimum(by2, Vec::loadu(kept.y2.data() + d));
+    auto w = at::vec::maximum(zero_vec, xx2 - xx1);
+    auto h = at::vec::maximum(zero_vec, yy2 - yy1);
+    auto inter = w * h;
+    auto ovr = inter / (barea + Vec::loadu(kept.areas.data() + d) - inter);
+    if ((ovr >= threshold_vec).zero_mask() != kAllZeroMask) {
+      return true;
+    }
+  }
+  for (; d < num_kept; d++) {
+    auto xx1 = std::max(box[0], kept.x1[d]);
+    auto yy1 = std::max(box[1], kept.y1[d]);
+    auto xx2 = std::min(box[2], kept.x2[d]);
+    auto yy2 = std::min(box[3], kept.y2[d]);
+    auto w = std::max(scalar_t(0), xx2 - xx1);
+    auto h = std::max(scalar_t(0), yy2 - yy1);
+    auto inter = w * h;
+    auto ovr = inter / (area + kept.areas[d] - inter);
+    if (ovr >= threshold) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <typename scalar_t>
 std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor>
 batch_score_nms_kernel(
@@ -395,111 +461,147 @@ batch_score_nms_kernel(
   auto nbatch = batch_scores.size(0); // number of batches
   auto ndets = batch_scores.size(1); // number of boxes
   auto nscore = batch_scores.size(2); // number of labels
+  constexpr float score_threshold = 0.05;
 
+  auto dets_t = batch_dets.contiguous();
+  auto scores_t = batch_scores.contiguous();
+  const scalar_t* dets = dets_t.data_ptr<scalar_t>();
+  const scalar_t* scores = scores_t.data_ptr<scalar_t>();
+
+  // Step1: per (batch, label) top max_output candidates + NMS. The kept boxes
+  // of each (batch, label) are written to its max_output slots.
   auto nbatch_x_nscore =
       nbatch * nscore; // (number of batches) * (number of labels)
-  std::vector<at::Tensor> bboxes_out(nbatch_x_nscore);
-  std::vector<at::Tensor> scores_out(nbatch_x_nscore);
-  std::vector<at::Tensor> labels_out(nbatch_x_nscore);
-
-#ifdef _OPENMP
-#if (_OPENMP >= 201307)
-#pragma omp parallel for simd schedule( \
-    static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
-#else
-#pragma omp parallel for schedule( \
-    static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
-#endif
-#endif
-  // skip background (i = 0)
-  for (int index = 0; index < nbatch_x_nscore; index++) {
-    // Parallel in the dimentaion of: batch * nscore
-    auto bs = index / nscore;
-    auto i = index % nscore;
-
-    // skip background (i = 0)
-    if (i == 0) {
-      continue;
-    }
-
-    at::Tensor dets = batch_dets[bs].squeeze(
-        0); // dets for boxes per image: (num_bbox, 4); For example: (15130, 4)
-    at::Tensor scores =
-        batch_scores[bs].squeeze(0); // scores for boxes per image: (num_bbox,
-                                     // 81); For example: (15130, 81)
-
-    at::Tensor score = scores.slice(1, i, i + 1)
-                           .squeeze(1); // score for boxes per image per class:
-                                        // (num_bbox); For example: (15130)
+  std::vector<int64_t> kept_idx(nbatch_x_nscore * max_output);
+  std::vector<scalar_t> kept_score(nbatch_x_nscore * max_output);
+  std::vector<int64_t> kept_num(nbatch_x_nscore, 0);
+
+  at::parallel_for(0, nbatch_x_nscore, 1, [&](int64_t begin, int64_t end) {
+    thread_local BatchScoreNmsScratch<scalar_t> scratch;
+    scratch.reserve(ndets, max_output);
+    for (int64_t index = begin; index < end; index++) {
+      // Parallel in the dimentaion of: batch * nscore
+      auto bs = index / nscore;
+      auto i = index % nscore;
+      // skip background (i = 0)
+      if (i == 0) {
+        continue;
+      }
 
-    at::Tensor mask_index = at::nonzero(score > 0.05).squeeze(1);
-    at::Tensor bboxes = at::index_select(dets, /*dim*/ 0, mask_index);
-    score = at::index_select(score, /*dim*/ 0, mask_index);
+      const scalar_t* score = scores + bs * ndets * nscore + i;
+      const scalar_t* bboxes = dets + bs * ndets * 4;
+      auto& candidates = scratch.candidates;
+      candidates.clear();
+      for (int64_t d = 0; d < ndets; d++) {
+        if (score[d * nscore] > score_threshold) {
+          candidates.emplace_back(score[d * nscore], d);
+        }
+      }
+      if (candidates.empty()) {
+        continue;
+      }
 
-    if (score.size(0) == 0) {
-      continue;
+      // select max_output highest' score and bboxes without a full sort
+      int64_t k = std::min<int64_t>(max_output, candidates.size());
+      std::partial_sort(
+          candidates.begin(),
+          candidates.begin() + k,
+          candidates.end(),
+          [](const auto& left, const auto& right) {
+            return left.first > right.first ||
+                (left.first == right.first && left.second < right.second);
+          });
+
+      // Greedy NMS: a candidate is kept if it doesn't overlap any box kept
+      // before it, which only needs the IoU against the (<= max_output) kept
+      // boxes.
+      int64_t num_kept = 0;
+      int64_t* out_idx = kept_idx.data() + index * max_output;
+      scalar_t* out_score = kept_score.data() + index * max_output;
+      for (int64_t c = 0; c < k; c++) {
+        const scalar_t* box = bboxes + candidates[c].second * 4;
+        scalar_t area = (box[2] - box[0]) * (box[3] - box[1]);
+        if (overlap_kept_boxes(scratch, num_kept, box, area, threshold)) {
+          continue;
+        }
+        scratch.x1[num_kept] = box[0];
+        scratch.y1[num_kept] = box[1];
+        scratch.x2[num_kept] = box[2];
+        scratch.y2[num_kept] = box[3];
+        scratch.areas[num_kept] = area;
+        out_idx[num_kept] = candidates[c].second;
+        out_score[num_kept] = candidates[c].first;
+        num_kept++;
+      }
+      kept_num[index] = num_kept;
     }
+  });
 
-    at::Tensor score_sliced, score_idx_sorted;
-    // select max_output highest' score and bboxes
-    std::tie(score_sliced, score_idx_sorted) = at::topk(
-        score, (max_output > score.size(0)) ? score.size(0) : max_output, 0);
-    at::Tensor bboxes_sliced =
-        at::index_select(bboxes, /*dim*/ 0, score_idx_sorted);
-
-    at::Tensor keep = nms_cpu_kernel<scalar_t, /*sorted*/ true>(
-        bboxes_sliced, score_sliced, threshold, /*bias*/ 0);
+  // Step2: per batch, select the top max_output of all labels, ordered by
+  // ascending score (ties keep the label order).
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> selected(nbatch);
+  at::parallel_for(0, nbatch, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t bs = begin; bs < end; bs++) {
+      // (label, slot) of the kept boxes in label order
+      auto& batch_selected = selected[bs];
+      for (int64_t i = 1; i < nscore; i++) {
+        for (int64_t n = 0; n < kept_num[bs * nscore + i]; n++) {
+          batch_selected.emplace_back(i, n);
+        }
+      }
+      auto score_of = [&](const std::pair<int64_t, int64_t>& entry) {
+        return kept_score[(bs * nscore + entry.first) * max_output +
+                          entry.second];
+      };
+      // Equivalent to a stable ascending sort and taking the tail.
+      auto descending = [&](const auto& left, const auto& right) {
+        auto left_score = score_of(left);
+        auto right_score = score_of(right);
+        return left_score > right_score ||
+            (left_score == right_score && left > right);
+      };
+      int64_t num_selected =
+          std::min<int64_t>(max_output, batch_selected.size());
+      std::partial_sort(
+          batch_selected.begin(),
+          batch_selected.begin() + num_selected,
+          batch_selected.end(),
+          descending);
+      batch_selected.resize(num_selected);
+      std::reverse(batch_selected.begin(), batch_selected.end());
+    }
+  });
 
-    bboxes_out[index] = at::index_select(bboxes_sliced, /*dim*/ 0, keep);
-    scores_out[index] = at::index_select(score_sliced, /*dim*/ 0, keep);
-    // TODO optimize the fill_
-    labels_out[index] = at::empty({keep.sizes()}).fill_(i);
-  }
-
-  std::vector<at::Tensor> output_bboxes_(nbatch);
-  std::vector<at::Tensor> output_labels_(nbatch);
-  std::vector<at::Tensor> output_scores_(nbatch);
-  std::vector<at::Tensor> output_length_(nbatch);
-#ifdef _OPENMP
-#if (_OPENMP >= 201307)
-#pragma omp parallel for simd schedule( \
-    static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
-#else
-#pragma omp parallel for schedule( \
-    static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
-#endif
-#endif
-  for (int bs = 0; bs < nbatch; bs++) {
-    // Post process the tensors to get the top max_output(number) for each
-    // Batchsize
-    std::vector<at::Tensor> valid_bboxes_out =
-        remove_empty(bboxes_out, bs * nscore, (bs + 1) * nscore);
-    std::vector<at::Tensor> valid_scores_out =
-        remove_empty(scores_out, bs * nscore, (bs + 1) * nscore);
-    std::vector<at::Tensor> valid_labels_out =
-        remove_empty(labels_out, bs * nscore, (bs + 1) * nscore);
-
-    at::Tensor bboxes_out_ = at::cat(valid_bboxes_out, 0);
-    at::Tensor labels_out_ = at::cat(valid_labels_out, 0);
-    at::Tensor scores_out_ = at::cat(valid_scores_out, 0);
-
-    std::tuple<at::Tensor, at::Tensor> sort_result = scores_out_.sort(0);
-    at::Tensor max_ids = std::get<1>(sort_result);
-    max_ids = max_ids.slice(
-        /*dim*/ 0,
-        /*start*/
-        std::max(max_ids.size(0) - max_output, static_cast<int64_t>(0)),
-        /*end*/ max_ids.size(0));
-    output_bboxes_[bs] = bboxes_out_.index_select(/*dim*/ 0, /*index*/ max_ids);
-    output_labels_[bs] = labels_out_.index_select(/*dim*/ 0, /*index*/ max_ids);
-    output_scores_[bs] = scores_out_.index_select(/*dim*/ 0, /*index*/ max_ids);
-    output_length_[bs] = torch::tensor(max_ids.size(0), {torch::kInt32});
+  // Step3: write the batched outputs
+  std::vector<int64_t> offsets(nbatch + 1, 0);
+  for (int64_t bs = 0; bs < nbatch; bs++) {
+    offsets[bs + 1] = offsets[bs] + selected[bs].size();
   }
+  auto output_bboxes = at::empty({offsets[nbatch], 4}, dets_t.options());
+  auto output_labels = at::empty({offsets[nbatch]}, at::kFloat);
+  auto output_scores = at::empty({offsets[nbatch]}, scores_t.options());
+  auto output_length = at::empty({nbatch}, at::kInt);
+  scalar_t* bboxes_ptr = output_bboxes.data_ptr<scalar_t>();
+  float* labels_ptr = output_labels.data_ptr<float>();
+  scalar_t* scores_ptr = output_scores.data_ptr<scalar_t>();
+  int32_t* length_ptr = output_length.data_ptr<int32_t>();
+  at::parallel_for(0, nbatch, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t bs = begin; bs < end; bs++) {
+      length_ptr[bs] = selected[bs].size();
+      for (size_t n = 0; n < selected[bs].size(); n++) {
+        int64_t out = offsets[bs] + n;
+        int64_t label = selected[bs][n].first;
+        int64_t slot =
+            (bs * nscore + label) * max_output + selected[bs][n].second;
+        const scalar_t* box = dets + (bs * ndets + kept_idx[slot]) * 4;
+        std::copy(box, box + 4, bboxes_ptr + out * 4);
+        labels_ptr[out] = label;
+        scores_ptr[out] = kept_score[slot];
+      }
+    }
+  });
   return std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor>(
-      at::cat(output_bboxes_),
-      at::cat(output_labels_),
-      at::cat(output_scores_),
-      at::stack(output_length_));
+      output_bboxes, output_labels, output_scores, output_length);
 }
 
 template <typename scalar_t>
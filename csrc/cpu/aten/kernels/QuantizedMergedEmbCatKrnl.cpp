@@ -470,8 +470,231 @@ Tensor qmerged_embedding_cat_fw_impl(
   return output;
 }
 
+// Row-wise quantized tables store one fused row per embedding:
+//   [packed values | fp32 scale | fp32 bias]
+// where value = q * scale + bias. 8-bit rows hold one uint8 per element,
+// 4-bit rows hold two elements per byte (low nibble first).
+inline int64_t rowwise_packed_bytes(int64_t emb_dim, int64_t bits) {
+  return bits == 4 ? (emb_dim + 1) / 2 : emb_dim;
+}
+
+inline int64_t rowwise_row_bytes(int64_t emb_dim, int64_t bits) {
+  return rowwise_packed_bytes(emb_dim, bits) + 2 * sizeof(float);
+}
+
+template <int64_t bits>
+inline void rowwise_dequant_accumulate(
+    const uint8_t* row,
+    const int64_t emb_dim,
+    float* acc) {
+  const uint8_t* q = row;
+  float scale, bias;
+  memcpy(&scale, row + rowwise_packed_bytes(emb_dim, bits), sizeof(float));
+  memcpy(
+      &bias,
+      row + rowwise_packed_bytes(emb_dim, bits) + sizeof(float),
+      sizeof(float));
+  int64_t d = 0;
+#if defined(CPU_CAPABILITY_AVX512)
+  __m512 scale_v = _mm512_set1_ps(scale);
+  __m512 bias_v = _mm512_set1_ps(bias);
+  for (; d + 16 <= emb_dim; d += 16) {
+    __m128i q8;
+    if (bits == 8) {
+      q8 = _mm_loadu_si128((const __m128i*)(q + d));
+    } else {
+      // widen 8 bytes to 16-bit lanes, then place the high nibble in the
+      // upper byte so the byte order matches the element order
+      __m128i w =
+          _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)(q + d / 2)));
+      __m128i lo = _mm_and_si128(w, _mm_set1_epi16(0x0F));
+      __m128i hi = _mm_srli_epi16(w, 4);
+      q8 = _mm_or_si128(lo, _mm_slli_epi16(hi, 8));
+    }
+    __m512 f = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(q8));
+    __m512 a = _mm512_loadu_ps(acc + d);
+    a = _mm512_add_ps(a, _mm512_fmadd_ps(f, scale_v, bias_v));
+    _mm512_storeu_ps(acc + d, a);
+  }
+#endif
+  for (; d < emb_dim; ++d) {
+    int32_t v = bits == 8 ? q[d] : (q[d / 2] >> ((d & 1) * 4)) & 0x0F;
+    acc[d] += v * scale + bias;
+  }
+}
+
+template <typename data_t, typename index_t>
+inline void rowwise_qembeddingbag_kern(
+    const int64_t bs_begin,
+    const int64_t bs_end,
+    const int64_t num_emb,
+    const int64_t emb_dim,
+    const int64_t bits,
+    const index_t last_offset,
+    const index_t* indices,
+    const index_t* offsets,
+    const uint8_t* weight,
+    float* acc,
+    data_t* result) {
+  const int64_t row_bytes = rowwise_row_bytes(emb_dim, bits);
+  for (int64_t b = bs_begin; b < bs_end; ++b) {
+    int64_t start_idx = offsets[b];
+    int64_t end_idx =
+        ((b + 1) == bs_end && last_offset != -1) ? last_offset : offsets[b + 1];
+    kernel::zero_ker(acc, emb_dim);
+    for (int64_t j = start_idx; j < end_idx; ++j) {
+      const uint8_t* row = &weight[indices[j] * row_bytes];
+      if (bits == 8) {
+        rowwise_dequant_accumulate<8>(row, emb_dim, acc);
+      } else {
+        rowwise_dequant_accumulate<4>(row, emb_dim, acc);
+      }
+    }
+    kernel::move_ker(result, acc, emb_dim);
+    result += (num_emb + 1) * emb_dim;
+  }
+}
+
+template <typename data_t, typename index_t>
+void rowwise_qembeddingbagcat(
+    data_t* o_ptr,
+    uint8_t** w_ptr,
+    index_t** indices_ptr,
+    index_t** offsets_ptr,
+    data_t* d_ptr,
+    int64_t num_batch,
+    int64_t num_emb,
+    int64_t emb_dim,
+    const std::vector<int64_t>& last_offsets,
+    const std::vector<int64_t>& weight_bits) {
+  constexpr int64_t b_block = 128;
+  const int64_t n_b_blocks = (num_batch - 1) / b_block + 1;
+#pragma omp parallel
+  {
+    std::vector<float> acc(emb_dim);
+#pragma omp for collapse(2)
+    for (int64_t b = 0; b < n_b_blocks; ++b) {
+      for (int64_t n = 0; n < (num_emb + 1); ++n) {
+        const int64_t bs_begin = b * b_block;
+        const int64_t bs_end = std::min(num_batch, (b + 1) * b_block);
+        data_t* r =
+            &o_ptr[b * b_block * (num_emb + 1) * emb_dim + n * emb_dim];
+        if (n == 0) {
+          const data_t* dense = &d_ptr[b * b_block * emb_dim];
+          for (int64_t i = bs_begin; i < bs_end; ++i) {
+            memcpy(r, dense, emb_dim * sizeof(data_t));
+            r += (num_emb + 1) * emb_dim;
+            dense += emb_dim;
+          }
+        } else {
+          const int64_t m = n - 1;
+          // avoid offsets not include last batch
+          const index_t last_offset =
+              bs_end == num_batch ? last_offsets[m] : -1;
+          rowwise_qembeddingbag_kern(
+              bs_begin,
+              bs_end,
+              num_emb,
+              emb_dim,
+              weight_bits[m],
+              last_offset,
+              indices_ptr[m],
+              offsets_ptr[m],
+              w_ptr[m],
+              acc.data(),
+              r);
+        }
+      }
+    }
+  }
+}
+
+Tensor rowwise_qmerged_embedding_cat_fw_impl(
+    const TensorList& qweights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense,
+    IntArrayRef weight_bits) {
+  RECORD_FUNCTION(__FUNCTION__, c10::ArrayRef<c10::IValue>({}));
+  int64_t batch_size = dense.size(0);
+  int64_t emb_dim = dense.size(1);
+  int64_t num_emb = qweights.size();
+
+  TORCH_CHECK(num_emb > 0, "expect at least one embedding table");
+  TORCH_CHECK(
+      num_emb == indices.size() && num_emb == offsets.size() &&
+          num_emb == weight_bits.size(),
+      "expect weights, indices, offsets and weight_bits have same length");
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(dense.dim() == 2 && dense.is_contiguous());
+
+  auto index_type = indices[0].scalar_type();
+  std::vector<int64_t> last_offsets(num_emb, -1);
+  std::vector<int64_t> bits(weight_bits.begin(), weight_bits.end());
+
+  for (int i = 0; i < num_emb; i++) {
+    TORCH_CHECK(
+        bits[i] == 4 || bits[i] == 8,
+        "row-wise quantized embedding only supports 4 or 8 bits, got ",
+        bits[i]);
+    TORCH_CHECK(
+        qweights[i].scalar_type() == at::kByte && qweights[i].dim() == 2 &&
+            qweights[i].size(1) == rowwise_row_bytes(emb_dim, bits[i]),
+        "table ",
+        i,
+        " is not a ",
+        bits[i],
+        "-bit row-wise quantized table with embedding_dim ",
+        emb_dim);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        indices[i].is_contiguous() && indices[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        offsets[i].is_contiguous() && offsets[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(qweights[i].is_contiguous());
+    // handle last offsets
+    last_offsets[i] = indices[i].numel();
+  }
+
+  Tensor output = empty({batch_size, (num_emb + 1) * emb_dim}, dense.options());
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::kBFloat16,
+      at::kHalf,
+      dense.scalar_type(),
+      "rowwise_qmerged_embeddingbag_cat",
+      [&] {
+        AT_DISPATCH_INDEX_TYPES(
+            index_type, "rowwise_qmerged_embeddingbag_cat", [&] {
+              scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+              uint8_t* qweights_ptr[num_emb];
+              index_t* indices_ptr[num_emb];
+              index_t* offsets_ptr[num_emb];
+              for (int i = 0; i < num_emb; i++) {
+                qweights_ptr[i] = qweights[i].data_ptr<uint8_t>();
+                indices_ptr[i] = indices[i].data_ptr<index_t>();
+                offsets_ptr[i] = offsets[i].data_ptr<index_t>();
+              }
+              rowwise_qembeddingbagcat<scalar_t, index_t>(
+                  output.data_ptr<scalar_t>(),
+                  qweights_ptr,
+                  indices_ptr,
+                  offsets_ptr,
+                  dense_ptr,
+                  batch_size,
+                  num_emb,
+                  emb_dim,
+                  last_offsets,
+                  bits);
+            });
+      });
+  return output;
+}
+
 } // anonymous namespace
 
+REGISTER_DISPATCH(
+    rowwise_qmerged_embeddingbag_cat_fw_stub,
+    &rowwise_qmerged_embedding_cat_fw_impl);
+
 REGISTER_DISPATCH(
     qmerged_embeddingbag_cat_fw_stub,
     &qmerged_embedding_cat_fw_impl);
@@ -784,6 +784,279 @@ at::Tensor roi_align_backward_kernel_impl(
   return grad_input;
 }
 
+// sum[0:channels] += w1 * in1 + w2 * in2 + w3 * in3 + w4 * in4, where the
+// inputs are the channels-last pixels of the 4 interpolation points.
+template <typename T, typename ACC_T>
+inline void bilinear_accumulate_channels(
+    ACC_T* sum,
+    const T* in1,
+    const T* in2,
+    const T* in3,
+    const T* in4,
+    const PreCalc<ACC_T>& pc,
+    int64_t channels) {
+  using Vec = at::vec::Vectorized<T>;
+  const Vec w1_vec(pc.w1), w2_vec(pc.w2), w3_vec(pc.w3), w4_vec(pc.w4);
+  int64_t d = 0;
+  for (; d < channels - (channels % Vec::size()); d += Vec::size()) {
+    Vec sum_vec = Vec::loadu(sum + d);
+    sum_vec = at::vec::fmadd(w1_vec, Vec::loadu(in1 + d), sum_vec);
+    sum_vec = at::vec::fmadd(w2_vec, Vec::loadu(in2 + d), sum_vec);
+    sum_vec = at::vec::fmadd(w3_vec, Vec::loadu(in3 + d), sum_vec);
+    sum_vec = at::vec::fmadd(w4_vec, Vec::loadu(in4 + d), sum_vec);
+    sum_vec.store(sum + d);
+  }
+  for (; d < channels; d++) {
+    sum[d] += pc.w1 * in1[d] + pc.w2 * in2[d] + pc.w3 * in3[d] +
+        pc.w4 * in4[d];
+  }
+}
+
+template <>
+inline void bilinear_accumulate_channels<at::BFloat16, float>(
+    float* sum,
+    const at::BFloat16* in1,
+    const at::BFloat16* in2,
+    const at::BFloat16* in3,
+    const at::BFloat16* in4,
+    const PreCalc<float>& pc,
+    int64_t channels) {
+  using bVec = at::vec::Vectorized<at::BFloat16>;
+  using fVec = at::vec::Vectorized<float>;
+  const fVec w1_fvec(pc.w1), w2_fvec(pc.w2), w3_fvec(pc.w3), w4_fvec(pc.w4);
+  int64_t d = 0;
+  for (; d < channels - (channels % bVec::size()); d += bVec::size()) {
+    fVec sum_fvec0 = fVec::loadu(sum + d);
+    fVec sum_fvec1 = fVec::loadu(sum + d + fVec::size());
+    const at::BFloat16* ins[4] = {in1 + d, in2 + d, in3 + d, in4 + d};
+    const fVec weights[4] = {w1_fvec, w2_fvec, w3_fvec, w4_fvec};
+    for (int k = 0; k < 4; k++) {
+      fVec in_fvec0, in_fvec1;
+      std::tie(in_fvec0, in_fvec1) =
+          convert_bfloat16_float(bVec::loadu(ins[k]));
+      sum_fvec0 = at::vec::fmadd(weights[k], in_fvec0, sum_fvec0);
+      sum_fvec1 = at::vec::fmadd(weights[k], in_fvec1, sum_fvec1);
+    }
+    sum_fvec0.store(sum + d);
+    sum_fvec1.store(sum + d + fVec::size());
+  }
+  for (; d < channels; d++) {
+    sum[d] += pc.w1 * static_cast<float>(in1[d]) +
+        pc.w2 * static_cast<float>(in2[d]) +
+        pc.w3 * static_cast<float>(in3[d]) +
+        pc.w4 * static_cast<float>(in4[d]);
+  }
+}
+
+// FPN level of the ROI, Eqn.(1) of https://arxiv.org/abs/1612.03144, the same
+// as torchvision LevelMapper: floor(k0 + log2(sqrt(area) / s0) + eps).
+template <typename ACC_T>
+inline int64_t map_roi_to_level(
+    const ACC_T* roi,
+    int64_t k_min,
+    int64_t k_max,
+    int64_t canonical_scale,
+    int64_t canonical_level) {
+  ACC_T area = (roi[3] - roi[1]) * (roi[4] - roi[2]);
+  if (!(area > 0)) {
+    return 0;
+  }
+  ACC_T level = std::floor(
+      canonical_level + std::log2(std::sqrt(area) / canonical_scale) +
+      static_cast<ACC_T>(1e-6));
+  level = std::min<ACC_T>(std::max<ACC_T>(level, k_min), k_max);
+  return static_cast<int64_t>(level) - k_min;
+}
+
+template <typename T, typename ACC_T>
+void multi_level_roi_align_forward_kernel_body(
+    int64_t n_rois,
+    const std::vector<const T*>& inputs,
+    const std::vector<int64_t>& heights,
+    const std::vector<int64_t>& widths,
+    const std::vector<double>& spatial_scales,
+    int64_t channels,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    int64_t k_min,
+    int64_t k_max,
+    int64_t canonical_scale,
+    int64_t canonical_level,
+    const ACC_T* rois,
+    T* output) {
+  int64_t pooled_size = pooled_height * pooled_width;
+  at::parallel_for(0, n_rois, 1, [&](int64_t begin, int64_t end) {
+    // Thread local buffers reused across ROIs: the interpolation weights,
+    // shared by all the channels, and the channels-last pooled sums.
+    thread_local std::vector<PreCalc<ACC_T>> pre_calc;
+    thread_local std::vector<ACC_T> sum;
+    sum.resize(pooled_size * channels);
+    for (int64_t n = begin; n < end; n++) {
+      const ACC_T* offset_rois = rois + n * 5;
+      int64_t roi_batch_ind = offset_rois[0];
+      int64_t level = map_roi_to_level(
+          offset_rois, k_min, k_max, canonical_scale, canonical_level);
+      int64_t height = heights[level];
+      int64_t width = widths[level];
+      ACC_T spatial_scale = spatial_scales[level];
+
+      // Do not using rounding; this implementation detail is critical
+      ACC_T offset = aligned ? (ACC_T)0.5 : (ACC_T)0.0;
+      ACC_T roi_start_w = offset_rois[1] * spatial_scale - offset;
+      ACC_T roi_start_h = offset_rois[2] * spatial_scale - offset;
+      ACC_T roi_end_w = offset_rois[3] * spatial_scale - offset;
+      ACC_T roi_end_h = offset_rois[4] * spatial_scale - offset;
+
+      ACC_T roi_width = roi_end_w - roi_start_w;
+      ACC_T roi_height = roi_end_h - roi_start_h;
+      if (!aligned) {
+        // Force malformed ROIs to be 1x1
+        roi_width = std::max(roi_width, (ACC_T)1.);
+        roi_height = std::max(roi_height, (ACC_T)1.);
+      }
+
+      ACC_T bin_size_h =
+          static_cast<ACC_T>(roi_height) / static_cast<ACC_T>(pooled_height);
+      ACC_T bin_size_w =
+          static_cast<ACC_T>(roi_width) / static_cast<ACC_T>(pooled_width);
+
+      int64_t roi_bin_grid_h = (sampling_ratio > 0)
+          ? sampling_ratio
+          : ceil(roi_height / pooled_height);
+      int64_t roi_bin_grid_w = (sampling_ratio > 0)
+          ? sampling_ratio
+          : ceil(roi_width / pooled_width);
+      const ACC_T count = std::max(roi_bin_grid_h * roi_bin_grid_w, (int64_t)1);
+
+      pre_calc.resize(roi_bin_grid_h * roi_bin_grid_w * pooled_size);
+      pre_calc_for_bilinear_interpolate(
+          height,
+          width,
+          pooled_height,
+          pooled_width,
+          roi_start_h,
+          roi_start_w,
+          bin_size_h,
+          bin_size_w,
+          roi_bin_grid_h,
+          roi_bin_grid_w,
+          pre_calc);
+
+      // Accumulate all the bins over the channels-last input
+      const T* input =
+          inputs[level] + roi_batch_ind * height * width * channels;
+      std::fill(sum.begin(), sum.end(), ACC_T(0));
+      int64_t pre_calc_index = 0;
+      for (int64_t bin = 0; bin < pooled_size; bin++) {
+        ACC_T* bin_sum = sum.data() + bin * channels;
+        for (int64_t i = 0; i < roi_bin_grid_h * roi_bin_grid_w; i++) {
+          const PreCalc<ACC_T>& pc = pre_calc[pre_calc_index++];
+          bilinear_accumulate_channels<T, ACC_T>(
+              bin_sum,
+              input + pc.pos1 * channels,
+              input + pc.pos2 * channels,
+              input + pc.pos3 * channels,
+              input + pc.pos4 * channels,
+              pc,
+              channels);
+        }
+      }
+
+      // Average and write to the (channels, pooled_height, pooled_width)
+      // layout of the box head input.
+      T* out = output + n * channels * pooled_size;
+      for (int64_t c = 0; c < channels; c++) {
+        for (int64_t bin = 0; bin < pooled_size; bin++) {
+          out[c * pooled_size + bin] =
+              static_cast<T>(sum[bin * channels + c] / count);
+        }
+      }
+    } // for n
+  });
+}
+
+at::Tensor multi_level_roi_align_kernel_impl(
+    const std::vector<at::Tensor>& features,
+    const at::Tensor& rois,
+    const std::vector<double>& spatial_scales,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    int64_t canonical_scale,
+    int64_t canonical_level) {
+  TORCH_CHECK(
+      !features.empty() && features.size() == spatial_scales.size(),
+      "multi_level_roi_align: expect one spatial scale per feature level");
+  TORCH_CHECK(rois.device().is_cpu(), "rois must be a CPU tensor");
+  TORCH_CHECK(
+      rois.dim() == 2 && rois.size(1) == 5,
+      "rois must have shape as Tensor[K, 5]");
+  auto channels = features[0].size(1);
+  auto scalar_type = features[0].scalar_type();
+  std::vector<at::Tensor> features_;
+  std::vector<int64_t> heights, widths;
+  for (const auto& feature : features) {
+    TORCH_CHECK(feature.device().is_cpu(), "input must be a CPU tensor");
+    TORCH_CHECK(
+        feature.dim() == 4 && feature.size(1) == channels &&
+            feature.scalar_type() == scalar_type,
+        "multi_level_roi_align: all feature levels should be 4D with the "
+        "same channels and dtype");
+    // Vectorize over the channels
+    features_.emplace_back(feature.contiguous(at::MemoryFormat::ChannelsLast));
+    heights.emplace_back(feature.size(2));
+    widths.emplace_back(feature.size(3));
+  }
+  // Levels are given from the finest, e.g. scales 1/4 ... 1/32 -> k 2 ... 5
+  int64_t k_min = std::lround(-std::log2(spatial_scales.front()));
+  int64_t k_max = std::lround(-std::log2(spatial_scales.back()));
+  TORCH_CHECK(
+      k_max - k_min + 1 == static_cast<int64_t>(features.size()),
+      "multi_level_roi_align: spatial_scales should be consecutive powers of "
+      "2 from the finest level");
+
+  auto num_rois = rois.size(0);
+  at::Tensor output = at::empty(
+      {num_rois, channels, pooled_height, pooled_width}, features[0].options());
+  if (output.numel() == 0)
+    return output;
+
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16,
+      scalar_type,
+      "multi_level_roi_align_kernel_impl",
+      [&] {
+        using accscalar_t = typename AccType<scalar_t>::type;
+        auto rois_ = rois.contiguous().to(
+            c10::CppTypeToScalarType<accscalar_t>::value);
+        std::vector<const scalar_t*> inputs;
+        for (const auto& feature : features_) {
+          inputs.emplace_back(feature.data_ptr<scalar_t>());
+        }
+        multi_level_roi_align_forward_kernel_body<scalar_t, accscalar_t>(
+            num_rois,
+            inputs,
+            heights,
+            widths,
+            spatial_scales,
+            channels,
+            pooled_height,
+            pooled_width,
+            sampling_ratio,
+            aligned,
+            k_min,
+            k_max,
+            canonical_scale,
+            canonical_level,
+            rois_.data_ptr<accscalar_t>(),
+            output.data_ptr<scalar_t>());
+      });
+  return output;
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(
@@ -792,6 +1065,9 @@ REGISTER_DISPATCH(
 REGISTER_DISPATCH(
     roi_align_backward_kernel_stub,
     &roi_align_backward_kernel_impl);
+REGISTER_DISPATCH(
+    multi_level_roi_align_kernel_stub,
+    &multi_level_roi_align_kernel_impl);
 
 } // namespace cpu
 } // namespace torch_ipex
@@ -0,0 +1,213 @@
+#include <aten/SparseLinear.h>
+
+#include <ATen/Parallel.h>
+#include <c10/util/irange.h>
+#include <type_traits>
+#include "vec/vec.h"
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
+// Calls f with the number of rows as a compile time constant, so that the
+// accumulators of the kernels stay in registers.
+template <typename F>
+inline void dispatch_rows(int64_t rows, const F& f) {
+  static_assert(
+      kernel::SPARSE_LINEAR_ROWS == 4,
+      "dispatch_rows handles up to 4 rows");
+  switch (rows) {
+    case 4:
+      f(std::integral_constant<int, 4>());
+      break;
+    case 3:
+      f(std::integral_constant<int, 3>());
+      break;
+    case 2:
+      f(std::integral_constant<int, 2>());
+      break;
+    default:
+      f(std::integral_constant<int, 1>());
+  }
+}
+
+// The tasks are the output blocks times the groups of rows, the consecutive
+// tasks of a thread share the output block so its stored weights are read
+// from the cache for all the rows.
+template <typename F>
+inline void parallel_for_blocks(
+    int64_t out_blocks,
+    int64_t M,
+    int64_t N,
+    const F& f) {
+  const int64_t row_blocks = at::divup(M, kernel::SPARSE_LINEAR_ROWS);
+  at::parallel_for(
+      0, out_blocks * row_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (const auto task : c10::irange(begin, end)) {
+          int64_t nb = task / row_blocks;
+          int64_t m = task % row_blocks * kernel::SPARSE_LINEAR_ROWS;
+          int64_t rows = std::min<int64_t>(kernel::SPARSE_LINEAR_ROWS, M - m);
+          int64_t n_valid = std::min(SPARSE_BLOCK_N, N - nb * SPARSE_BLOCK_N);
+          f(nb, m, rows, n_valid);
+        }
+      });
+}
+
+template <typename T>
+void sparse_linear_block_kernel(
+    const at::Tensor& input,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    const at::Tensor& bias,
+    at::Tensor& output) {
+  const int64_t M = input.size(0);
+  const int64_t K = input.size(1);
+  const int64_t N = output.size(1);
+  const float* x = input.data_ptr<float>();
+  const T* v = values.data_ptr<T>();
+  const int32_t* cols = indices.data_ptr<int32_t>();
+  const int64_t* row_ptr_data = row_ptr.data_ptr<int64_t>();
+  const float* b = bias.defined() ? bias.data_ptr<float>() : nullptr;
+  T* out = output.data_ptr<T>();
+  parallel_for_blocks(
+      row_ptr.numel() - 1,
+      M,
+      N,
+      [&](int64_t nb, int64_t m, int64_t rows, int64_t n_valid) {
+        dispatch_rows(rows, [&](auto ROWS) {
+          kernel::_sparse_linear_block_rows<T, decltype(ROWS)::value>(
+              x + m * K,
+              K,
+              K,
+              v,
+              cols,
+              row_ptr_data[nb],
+              row_ptr_data[nb + 1],
+              SPARSE_BLOCK_K,
+              b ? b + nb * SPARSE_BLOCK_N : nullptr,
+              out + m * N + nb * SPARSE_BLOCK_N,
+              N,
+              n_valid);
+        });
+      });
+}
+
+template <typename T>
+void sparse_linear_two_four_kernel(
+    const at::Tensor& input,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& bias,
+    at::Tensor& output) {
+  const int64_t M = input.size(0);
+  const int64_t K = input.size(1);
+  const int64_t N = output.size(1);
+  const float* x = input.data_ptr<float>();
+  const T* v = values.data_ptr<T>();
+  const uint8_t* idx = indices.data_ptr<uint8_t>();
+  const float* b = bias.defined() ? bias.data_ptr<float>() : nullptr;
+  T* out = output.data_ptr<T>();
+  // the stored slots of an output block
+  const int64_t block_size = K / 2 * SPARSE_BLOCK_N;
+  parallel_for_blocks(
+      values.size(0),
+      M,
+      N,
+      [&](int64_t nb, int64_t m, int64_t rows, int64_t n_valid) {
+        dispatch_rows(rows, [&](auto ROWS) {
+          kernel::_sparse_linear_two_four_rows<T, decltype(ROWS)::value>(
+              x + m * K,
+              K,
+              K,
+              v + nb * block_size,
+              idx + nb * block_size,
+              b ? b + nb * SPARSE_BLOCK_N : nullptr,
+              out + m * N + nb * SPARSE_BLOCK_N,
+              N,
+              n_valid);
+        });
+      });
+}
+#else
+// Computes the linear with the dense weight when the kernels are not built
+// for the ISA.
+void sparse_linear_reference(
+    SparseLinearFormat format,
+    const at::Tensor& input,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    const at::Tensor& bias,
+    at::Tensor& output) {
+  const int64_t N = output.size(1);
+  auto weight = sparse_linear_unpack(
+      format, values, indices, row_ptr, N, input.size(1));
+  auto bias_ = bias.defined() ? bias.narrow(0, 0, N) : at::Tensor();
+  output.copy_(at::linear(input, weight.to(at::kFloat), bias_));
+}
+#endif
+
+void sparse_linear_block_kernel_impl(
+    const at::Tensor& input,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& row_ptr,
+    const at::Tensor& bias,
+    at::Tensor& output) {
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
+  if (values.scalar_type() == at::kFloat) {
+    sparse_linear_block_kernel<float>(
+        input, values, indices, row_ptr, bias, output);
+  } else if (values.scalar_type() == at::kBFloat16) {
+    sparse_linear_block_kernel<at::BFloat16>(
+        input, values, indices, row_ptr, bias, output);
+  } else {
+    TORCH_CHECK(false, "sparse_linear: unsupported weight type");
+  }
+#else
+  sparse_linear_reference(
+      SparseLinearFormat::BLOCK, input, values, indices, row_ptr, bias, output);
+#endif
+}
+
+void sparse_linear_two_four_kernel_impl(
+    const at::Tensor& input,
+    const at::Tensor& values,
+    const at::Tensor& indices,
+    const at::Tensor& bias,
+    at::Tensor& output) {
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
+  if (values.scalar_type() == at::kFloat) {
+    sparse_linear_two_four_kernel<float>(input, values, indices, bias, output);
+  } else if (values.scalar_type() == at::kBFloat16) {
+    sparse_linear_two_four_kernel<at::BFloat16>(
+        input, values, indices, bias, output);
+  } else {
+    TORCH_CHECK(false, "sparse_linear: unsupported weight type");
+  }
+#else
+  sparse_linear_reference(
+      SparseLinearFormat::TWO_FOUR,
+      input,
+      values,
+      indices,
+      at::Tensor(),
+      bias,
+      output);
+#endif
+}
+
+} // namespace
+
+REGISTER_DISPATCH(
+    sparse_linear_block_kernel_stub,
+    &sparse_linear_block_kernel_impl);
+REGISTER_DISPATCH(
+    sparse_linear_two_four_kernel_stub,
+    &sparse_linear_two_four_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
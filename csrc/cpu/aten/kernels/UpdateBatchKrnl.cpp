@@ -18,7 +18,7 @@ namespace {
 
 using namespace torch_ipex::cpu::kernel;
 
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
 
 template <typename T>
 inline void update_hidden_kernel(
@@ -223,7 +223,7 @@ bool rnnt_update_batch_kernel_impl(
     int64_t batch_size,
     int64_t _SOS,
     int64_t max_len) {
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
   update_batch_kernel(
       k,
       out_lens,
@@ -24,7 +24,8 @@ void adam_fused_step_kernel(
     double beta2_double,
     double learning_rate_double,
     double weight_decay_double,
-    double eps_double) {
+    double eps_double,
+    double grad_scale) {
   scalar_t* param_data = param.data_ptr<scalar_t>();
   scalar_t* exp_avg_data = exp_avg.data_ptr<scalar_t>();
   scalar_t* exp_avg_sq_data = exp_avg_sq.data_ptr<scalar_t>();
@@ -63,8 +64,8 @@ void adam_fused_step_kernel(
         int64_t d = 0;
         for (; d < size - (size % Vec::size()); d += Vec::size()) {
           Vec param_vec = Vec::loadu(param_ptr + d);
-          Vec grad_vec =
-              Vec::loadu(grad_ptr + d) + param_vec * Vec(weight_decay);
+          Vec grad_vec = Vec::loadu(grad_ptr + d) * Vec(scalar_t(grad_scale)) +
+              param_vec * Vec(weight_decay);
           Vec exp_avg_vec = Vec::loadu(exp_avg_ptr + d) * Vec(beta1) +
               grad_vec * Vec(exp_avg_grad_coefficient);
           Vec exp_avg_sq_vec = Vec::loadu(exp_avg_sq_ptr + d) * Vec(beta2) +
@@ -88,7 +89,8 @@ void adam_fused_step_kernel(
           param_vec.store(param_ptr + d);
         }
         for (; d < size; d++) {
-          scalar_t grad_val = grad_ptr[d] + param_ptr[d] * weight_decay;
+          scalar_t grad_val = grad_ptr[d] * scalar_t(grad_scale) +
+              param_ptr[d] * weight_decay;
           exp_avg_ptr[d] =
               exp_avg_ptr[d] * beta1 + grad_val * exp_avg_grad_coefficient;
           exp_avg_sq_ptr[d] = exp_avg_sq_ptr[d] * beta2 +
@@ -121,7 +123,8 @@ void adam_fused_step_kernel<at::BFloat16, at::BFloat16>(
     double beta2_double,
     double learning_rate_double,
     double weight_decay_double,
-    double eps_double) {
+    double eps_double,
+    double grad_scale) {
   TORCH_CHECK(
       param.scalar_type() == at::kBFloat16,
       "adam_fused_step_kernel: expect param to be at::BFloat16");
@@ -184,6 +187,8 @@ void adam_fused_step_kernel<at::BFloat16, at::BFloat16>(
           bVec grad_bvec = bVec::loadu(grad_ptr + d);
           fVec grad_fvec, grad_fvec2;
           std::tie(grad_fvec, grad_fvec2) = convert_bfloat16_float(grad_bvec);
+          grad_fvec = grad_fvec * fVec(float(grad_scale));
+          grad_fvec2 = grad_fvec2 * fVec(float(grad_scale));
           // load param vec
           bVec param_bvec = bVec::loadu(param_ptr + d);
           bVec param2_bvec = bVec::loadu(param2_ptr + d);
@@ -241,7 +246,8 @@ void adam_fused_step_kernel<at::BFloat16, at::BFloat16>(
         for (; d < size; d++) {
           float param_val =
               at::vec::pack_bfloat16_float(param_ptr[d], param2_ptr[d]);
-          float grad_val = float(grad_ptr[d]) + param_val * weight_decay;
+          float grad_val = float(grad_ptr[d]) * float(grad_scale) +
+              param_val * weight_decay;
           exp_avg_ptr[d] =
               exp_avg_ptr[d] * beta1 + grad_val * exp_avg_grad_coefficient;
           exp_avg_sq_ptr[d] = exp_avg_sq_ptr[d] * beta2 +
@@ -276,7 +282,8 @@ void adam_fused_step_kernel<float, at::BFloat16>(
     double beta2_double,
     double learning_rate_double,
     double weight_decay_double,
-    double eps_double) {
+    double eps_double,
+    double grad_scale) {
   TORCH_CHECK(
       param.scalar_type() == at::kFloat,
       "adam_fused_step_kernel: expect param to be at::Float");
@@ -339,6 +346,8 @@ void adam_fused_step_kernel<float, at::BFloat16>(
           bVec grad_bvec = bVec::loadu(grad_ptr + d);
           fVec grad_fvec, grad_fvec2;
           std::tie(grad_fvec, grad_fvec2) = convert_bfloat16_float(grad_bvec);
+          grad_fvec = grad_fvec * fVec(float(grad_scale));
+          grad_fvec2 = grad_fvec2 * fVec(float(grad_scale));
           // load param vec
           fVec param_fvec = fVec::loadu(param_ptr + d);
           fVec param_fvec2 = fVec::loadu(param_ptr + d + fVec::size());
@@ -392,7 +401,8 @@ void adam_fused_step_kernel<float, at::BFloat16>(
           param2_bvec.store(param2_ptr + d);
         }
         for (; d < size; d++) {
-          float grad_val = float(grad_ptr[d]) + param_ptr[d] * weight_decay;
+          float grad_val = float(grad_ptr[d]) * float(grad_scale) +
+              param_ptr[d] * weight_decay;
           exp_avg_ptr[d] =
               exp_avg_ptr[d] * beta1 + grad_val * exp_avg_grad_coefficient;
           exp_avg_sq_ptr[d] = exp_avg_sq_ptr[d] * beta2 +
@@ -425,7 +435,8 @@ void adam_fused_step_kernel_impl(
     double beta2,
     double learning_rate,
     double weight_decay,
-    double eps) {
+    double eps,
+    double grad_scale) {
   auto param = param_.contiguous();
   auto exp_avg = exp_avg_.contiguous();
   auto exp_avg_sq = exp_avg_sq_.contiguous();
@@ -449,7 +460,8 @@ void adam_fused_step_kernel_impl(
         beta2,
         learning_rate,
         weight_decay,
-        eps);
+        eps,
+        grad_scale);
   } else if (at::ScalarType::Double == grad_dtype) {
     adam_fused_step_kernel<double, double>(
         param,
@@ -464,7 +476,8 @@ void adam_fused_step_kernel_impl(
         beta2,
         learning_rate,
         weight_decay,
-        eps);
+        eps,
+        grad_scale);
   } else if (
       at::ScalarType::BFloat16 == grad_dtype &&
       at::ScalarType::BFloat16 == param_dtype) {
@@ -481,7 +494,8 @@ void adam_fused_step_kernel_impl(
         beta2,
         learning_rate,
         weight_decay,
-        eps);
+        eps,
+        grad_scale);
   } else if (
       at::ScalarType::BFloat16 == grad_dtype &&
       at::ScalarType::Float == param_dtype) {
@@ -498,7 +512,8 @@ void adam_fused_step_kernel_impl(
         beta2,
         learning_rate,
         weight_decay,
-        eps);
+        eps,
+        grad_scale);
   } else {
     TORCH_CHECK(false, "expect bfloat16 or float or double param");
   }
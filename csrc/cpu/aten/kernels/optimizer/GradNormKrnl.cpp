@@ -0,0 +1,109 @@
+#include <ATen/Parallel.h>
+#include <aten/optimizer/optimizer.h>
+#include "vec/vec.h"
+
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+#include <array>
+#include <numeric>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+using namespace at::vec;
+
+template <typename scalar_t>
+inline scalar_t acc_vec(const Vectorized<scalar_t>& v) {
+  std::array<scalar_t, Vectorized<scalar_t>::size()> arr;
+  v.store(arr.data());
+  return std::accumulate(arr.cbegin(), arr.cend(), scalar_t(0));
+}
+
+// inf and nan propagate through the squares, so the sum of squares is
+// non-finite iff the gradient has inf/nan (or its norm overflows float)
+template <typename scalar_t>
+double grad_norm_sq_kernel(const at::Tensor& grad) {
+  using Vec = Vectorized<scalar_t>;
+  const scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  int64_t grain_size = 2048;
+
+  return at::parallel_reduce(
+      0,
+      grad.numel(),
+      grain_size,
+      0.0,
+      [&](int64_t begin, int64_t end, double ident) {
+        const scalar_t* grad_ptr = grad_data + begin;
+        const int64_t size = end - begin;
+        Vec sum_vec = Vec(scalar_t(0));
+        scalar_t sum_val = scalar_t(0);
+        int64_t d = 0;
+        for (; d < size - (size % Vec::size()); d += Vec::size()) {
+          Vec grad_vec = Vec::loadu(grad_ptr + d);
+          sum_vec = sum_vec + grad_vec * grad_vec;
+        }
+        for (; d < size; d++) {
+          sum_val += grad_ptr[d] * grad_ptr[d];
+        }
+        return ident + double(sum_val + acc_vec(sum_vec));
+      },
+      std::plus<double>());
+}
+
+template <>
+double grad_norm_sq_kernel<at::BFloat16>(const at::Tensor& grad) {
+  using bVec = Vectorized<at::BFloat16>;
+  using fVec = Vectorized<float>;
+  const at::BFloat16* grad_data = grad.data_ptr<at::BFloat16>();
+  int64_t grain_size = 2048;
+
+  return at::parallel_reduce(
+      0,
+      grad.numel(),
+      grain_size,
+      0.0,
+      [&](int64_t begin, int64_t end, double ident) {
+        const at::BFloat16* grad_ptr = grad_data + begin;
+        const int64_t size = end - begin;
+        fVec sum_fvec = fVec(0.f);
+        float sum_val = 0.f;
+        int64_t d = 0;
+        for (; d < size - (size % bVec::size()); d += bVec::size()) {
+          fVec grad_fvec, grad_fvec2;
+          std::tie(grad_fvec, grad_fvec2) =
+              convert_bfloat16_float(bVec::loadu(grad_ptr + d));
+          sum_fvec = sum_fvec + grad_fvec * grad_fvec;
+          sum_fvec = sum_fvec + grad_fvec2 * grad_fvec2;
+        }
+        for (; d < size; d++) {
+          float grad_val = float(grad_ptr[d]);
+          sum_val += grad_val * grad_val;
+        }
+        return ident + double(sum_val + acc_vec(sum_fvec));
+      },
+      std::plus<double>());
+}
+
+double grad_norm_sq_kernel_impl(const at::Tensor& grad_) {
+  auto grad = grad_.contiguous();
+  auto grad_dtype = grad.scalar_type();
+  if (at::ScalarType::Float == grad_dtype) {
+    return grad_norm_sq_kernel<float>(grad);
+  } else if (at::ScalarType::Double == grad_dtype) {
+    return grad_norm_sq_kernel<double>(grad);
+  }
+  TORCH_CHECK(
+      at::ScalarType::BFloat16 == grad_dtype,
+      "expect bfloat16 or float or double grad");
+  return grad_norm_sq_kernel<at::BFloat16>(grad);
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(grad_norm_sq_kernel_stub, &grad_norm_sq_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,667 @@
+#include <aten/optimizer/optimizer.h>
+#include "vec/vec.h"
+
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+using namespace at::vec;
+using fVec = at::vec::Vectorized<float>;
+
+// Optimizer states are quantized in blocks of kQuantizedStateBlockSize
+// elements, each with its own absmax. A block is dequantized into float
+// buffers that stay in L1, updated, then requantized, so the fp32 states are
+// never written to memory.
+//
+// The first moment is signed and roughly uniform inside a block, it is
+// quantized linearly to int8. The second moment spans many orders of
+// magnitude, it is quantized to uint8 codes with a 5-bit exponent and a
+// 3-bit mantissa relative to the block absmax: code 0 is 0, code c > 0 is
+// 2^(e - 31) * (8 + m) / 15 with e = c >> 3 and m = c & 7, so that code 255
+// is exactly the absmax.
+struct DynamicExponentCode {
+  float values[256];
+  // midpoints between consecutive values, for round to nearest
+  float bounds[255];
+
+  DynamicExponentCode() {
+    values[0] = 0.f;
+    for (int c = 1; c < 256; c++) {
+      values[c] = std::ldexp((8.f + (c & 7)) / 15.f, (c >> 3) - 31);
+    }
+    for (int c = 0; c < 255; c++) {
+      bounds[c] = 0.5f * (values[c] + values[c + 1]);
+    }
+  }
+
+  inline uint8_t encode(float x) const {
+    return std::upper_bound(bounds, bounds + 255, x) - bounds;
+  }
+};
+
+const DynamicExponentCode& dynamic_exponent_code() {
+  static DynamicExponentCode code;
+  return code;
+}
+
+inline float acc_vec(const fVec& v) {
+  std::array<float, fVec::size()> arr;
+  v.store(arr.data());
+  return std::accumulate(arr.cbegin(), arr.cend(), 0.f);
+}
+
+inline float max_vec(const fVec& v) {
+  std::array<float, fVec::size()> arr;
+  v.store(arr.data());
+  return *std::max_element(arr.cbegin(), arr.cend());
+}
+
+inline float block_absmax(const float* in, int64_t n) {
+  fVec max_fvec = fVec(0.f);
+  int64_t d = 0;
+  for (; d < n - (n % fVec::size()); d += fVec::size()) {
+    max_fvec = maximum(max_fvec, fVec::loadu(in + d).abs());
+  }
+  float max_val = max_vec(max_fvec);
+  for (; d < n; d++) {
+    max_val = std::max(max_val, std::abs(in[d]));
+  }
+  return max_val;
+}
+
+inline void dequantize_linear_block(
+    const int8_t* q,
+    float absmax,
+    float* out,
+    int64_t n) {
+  float scale = absmax / 127.f;
+  for (int64_t d = 0; d < n; d++) {
+    out[d] = float(q[d]) * scale;
+  }
+}
+
+// returns the new absmax of the block
+inline float quantize_linear_block(const float* in, int8_t* q, int64_t n) {
+  float absmax = block_absmax(in, n);
+  float inv_scale = absmax > 0.f ? 127.f / absmax : 0.f;
+  for (int64_t d = 0; d < n; d++) {
+    q[d] = static_cast<int8_t>(std::nearbyint(in[d] * inv_scale));
+  }
+  return absmax;
+}
+
+inline void dequantize_dynamic_block(
+    const uint8_t* q,
+    float absmax,
+    float* out,
+    int64_t n) {
+  const float* values = dynamic_exponent_code().values;
+  for (int64_t d = 0; d < n; d++) {
+    out[d] = values[q[d]] * absmax;
+  }
+}
+
+// returns the new absmax of the block, inputs are non-negative
+inline float quantize_dynamic_block(const float* in, uint8_t* q, int64_t n) {
+  const auto& code = dynamic_exponent_code();
+  float absmax = block_absmax(in, n);
+  float inv_absmax = absmax > 0.f ? 1.f / absmax : 0.f;
+  for (int64_t d = 0; d < n; d++) {
+    q[d] = code.encode(in[d] * inv_absmax);
+  }
+  return absmax;
+}
+
+// fp32 params, param2 is empty or the bf16 copy of param
+inline void load_param_block(
+    const float* param,
+    const at::BFloat16* param2,
+    float* out,
+    int64_t n) {
+  std::copy(param, param + n, out);
+}
+
+inline void store_param_block(
+    float* param,
+    at::BFloat16* param2,
+    const float* in,
+    int64_t n) {
+  std::copy(in, in + n, param);
+  if (param2 != nullptr) {
+    for (int64_t d = 0; d < n; d++) {
+      param2[d] = at::BFloat16(in[d]);
+    }
+  }
+}
+
+// bf16 params, param2 is the trail of the fp32 master weight
+inline void load_param_block(
+    const at::BFloat16* param,
+    const at::BFloat16* param2,
+    float* out,
+    int64_t n) {
+  for (int64_t d = 0; d < n; d++) {
+    out[d] = at::vec::pack_bfloat16_float(param[d], param2[d]);
+  }
+}
+
+inline void store_param_block(
+    at::BFloat16* param,
+    at::BFloat16* param2,
+    const float* in,
+    int64_t n) {
+  for (int64_t d = 0; d < n; d++) {
+    std::tie(param[d], param2[d]) = at::vec::unpack_float_bfloat16(in[d]);
+  }
+}
+
+template <typename grad_t>
+inline void load_grad_block(const grad_t* grad, float* out, int64_t n) {
+  for (int64_t d = 0; d < n; d++) {
+    out[d] = float(grad[d]);
+  }
+}
+
+struct block_buffers {
+  float param[kQuantizedStateBlockSize];
+  float grad[kQuantizedStateBlockSize];
+  float exp_avg[kQuantizedStateBlockSize];
+  float exp_avg_sq[kQuantizedStateBlockSize];
+};
+
+// updates exp_avg and exp_avg_sq of a block with grad, in place
+inline void update_moments_block(
+    block_buffers& buf,
+    int64_t n,
+    float beta1,
+    float beta2) {
+  float exp_avg_grad_coefficient = 1 - beta1;
+  float exp_avg_sq_grad_coefficient = 1 - beta2;
+  int64_t d = 0;
+  for (; d < n - (n % fVec::size()); d += fVec::size()) {
+    fVec grad_fvec = fVec::loadu(buf.grad + d);
+    fVec exp_avg_fvec = fVec::loadu(buf.exp_avg + d) * fVec(beta1) +
+        grad_fvec * fVec(exp_avg_grad_coefficient);
+    fVec exp_avg_sq_fvec = fVec::loadu(buf.exp_avg_sq + d) * fVec(beta2) +
+        grad_fvec * grad_fvec * fVec(exp_avg_sq_grad_coefficient);
+    exp_avg_fvec.store(buf.exp_avg + d);
+    exp_avg_sq_fvec.store(buf.exp_avg_sq + d);
+  }
+  for (; d < n; d++) {
+    float grad_val = buf.grad[d];
+    buf.exp_avg[d] =
+        buf.exp_avg[d] * beta1 + grad_val * exp_avg_grad_coefficient;
+    buf.exp_avg_sq[d] = buf.exp_avg_sq[d] * beta2 +
+        grad_val * grad_val * exp_avg_sq_grad_coefficient;
+  }
+}
+
+// requantizes the moments of a block, the buffers are updated with the
+// quantized values so that every later use sees what is stored
+inline void requantize_moments_block(
+    block_buffers& buf,
+    int64_t n,
+    int8_t* exp_avg,
+    float& exp_avg_absmax,
+    uint8_t* exp_avg_sq,
+    float& exp_avg_sq_absmax) {
+  exp_avg_absmax = quantize_linear_block(buf.exp_avg, exp_avg, n);
+  exp_avg_sq_absmax = quantize_dynamic_block(buf.exp_avg_sq, exp_avg_sq, n);
+  dequantize_linear_block(exp_avg, exp_avg_absmax, buf.exp_avg, n);
+  dequantize_dynamic_block(exp_avg_sq, exp_avg_sq_absmax, buf.exp_avg_sq, n);
+}
+
+template <typename param_t, typename grad_t>
+void adam_fused_step_8bit_kernel(
+    const at::Tensor& param,
+    const at::Tensor& exp_avg,
+    const at::Tensor& exp_avg_absmax,
+    const at::Tensor& exp_avg_sq,
+    const at::Tensor& exp_avg_sq_absmax,
+    const at::Tensor& grad,
+    const at::Tensor& param2,
+    double step,
+    double beta1_double,
+    double beta2_double,
+    double learning_rate_double,
+    double weight_decay_double,
+    double eps_double) {
+  param_t* param_data = param.data_ptr<param_t>();
+  grad_t* grad_data = grad.data_ptr<grad_t>();
+  at::BFloat16* param2_data =
+      param2.numel() ? param2.data_ptr<at::BFloat16>() : nullptr;
+  int8_t* exp_avg_data = exp_avg.data_ptr<int8_t>();
+  float* exp_avg_absmax_data = exp_avg_absmax.data_ptr<float>();
+  uint8_t* exp_avg_sq_data = exp_avg_sq.data_ptr<uint8_t>();
+  float* exp_avg_sq_absmax_data = exp_avg_sq_absmax.data_ptr<float>();
+
+  float bias_correction1 = 1 - std::pow(beta1_double, step);
+  float step_size = learning_rate_double / bias_correction1;
+  float bias_correction2 = 1 - std::pow(beta2_double, step);
+
+  float beta1 = float(beta1_double);
+  float beta2 = float(beta2_double);
+  float weight_decay = float(weight_decay_double);
+  float eps = float(eps_double);
+
+  int64_t numel = param.numel();
+  int64_t num_blocks = exp_avg_absmax.numel();
+  // 512 elements, as the fp32 kernels
+  int64_t grain_size = 512 / kQuantizedStateBlockSize;
+
+  at::parallel_for(0, num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    block_buffers buf;
+    for (int64_t b = begin; b < end; b++) {
+      int64_t offset = b * kQuantizedStateBlockSize;
+      int64_t n = std::min(kQuantizedStateBlockSize, numel - offset);
+      at::BFloat16* param2_ptr = param2_data ? param2_data + offset : nullptr;
+
+      load_param_block(param_data + offset, param2_ptr, buf.param, n);
+      load_grad_block(grad_data + offset, buf.grad, n);
+      dequantize_linear_block(
+          exp_avg_data + offset, exp_avg_absmax_data[b], buf.exp_avg, n);
+      dequantize_dynamic_block(
+          exp_avg_sq_data + offset,
+          exp_avg_sq_absmax_data[b],
+          buf.exp_avg_sq,
+          n);
+
+      // weight decay
+      int64_t d = 0;
+      for (; d < n - (n % fVec::size()); d += fVec::size()) {
+        fVec grad_fvec = fVec::loadu(buf.grad + d) +
+            fVec::loadu(buf.param + d) * fVec(weight_decay);
+        grad_fvec.store(buf.grad + d);
+      }
+      for (; d < n; d++) {
+        buf.grad[d] += buf.param[d] * weight_decay;
+      }
+
+      update_moments_block(buf, n, beta1, beta2);
+      requantize_moments_block(
+          buf,
+          n,
+          exp_avg_data + offset,
+          exp_avg_absmax_data[b],
+          exp_avg_sq_data + offset,
+          exp_avg_sq_absmax_data[b]);
+
+      // update param
+      d = 0;
+      for (; d < n - (n % fVec::size()); d += fVec::size()) {
+        fVec denom_fvec =
+            (fVec::loadu(buf.exp_avg_sq + d) / fVec(bias_correction2)).sqrt() +
+            fVec(eps);
+        fVec param_fvec = fVec::loadu(buf.param + d) -
+            fVec(step_size) * fVec::loadu(buf.exp_avg + d) / denom_fvec;
+        param_fvec.store(buf.param + d);
+      }
+      for (; d < n; d++) {
+        float denom_val = std::sqrt(buf.exp_avg_sq[d] / bias_correction2) + eps;
+        buf.param[d] -= step_size * buf.exp_avg[d] / denom_val;
+      }
+      store_param_block(param_data + offset, param2_ptr, buf.param, n);
+    }
+  });
+}
+
+// Lamb with quantized states in two passes over the blocks. The first pass
+// updates the moments and accumulates the norms of the param and of the adam
+// step, the second recomputes the adam step from the stored moments, which
+// avoids a float workspace of the size of the param.
+template <typename param_t, typename grad_t>
+void lamb_fused_step_8bit_kernel(
+    const at::Tensor& param,
+    const at::Tensor& exp_avg,
+    const at::Tensor& exp_avg_absmax,
+    const at::Tensor& exp_avg_sq,
+    const at::Tensor& exp_avg_sq_absmax,
+    const at::Tensor& grad,
+    const at::Tensor& param2,
+    int64_t step,
+    double beta1_double,
+    double beta2_double,
+    double learning_rate,
+    double weight_decay_double,
+    double eps_double) {
+  param_t* param_data = param.data_ptr<param_t>();
+  grad_t* grad_data = grad.data_ptr<grad_t>();
+  at::BFloat16* param2_data =
+      param2.numel() ? param2.data_ptr<at::BFloat16>() : nullptr;
+  int8_t* exp_avg_data = exp_avg.data_ptr<int8_t>();
+  float* exp_avg_absmax_data = exp_avg_absmax.data_ptr<float>();
+  uint8_t* exp_avg_sq_data = exp_avg_sq.data_ptr<uint8_t>();
+  float* exp_avg_sq_absmax_data = exp_avg_sq_absmax.data_ptr<float>();
+
+  float bias_correction1 = 1 - std::pow(beta1_double, step);
+  float bias_correction2 = 1 - std::pow(beta2_double, step);
+
+  float beta1 = float(beta1_double);
+  float beta2 = float(beta2_double);
+  float weight_decay = float(weight_decay_double);
+  float eps = float(eps_double);
+
+  int64_t numel = param.numel();
+  int64_t num_blocks = exp_avg_absmax.numel();
+  int64_t grain_size = 512 / kQuantizedStateBlockSize;
+
+  // adam step of a block from the dequantized moments, stored in buf.grad
+  auto adam_step_block = [&](block_buffers& buf, int64_t n) {
+    int64_t d = 0;
+    for (; d < n - (n % fVec::size()); d += fVec::size()) {
+      fVec adam_step_fvec = fVec::loadu(buf.exp_avg + d) /
+              fVec(bias_correction1) /
+              ((fVec::loadu(buf.exp_avg_sq + d) / fVec(bias_correction2))
+                   .sqrt() +
+               fVec(eps)) +
+          fVec::loadu(buf.param + d) * fVec(weight_decay);
+      adam_step_fvec.store(buf.grad + d);
+    }
+    for (; d < n; d++) {
+      buf.grad[d] = (buf.exp_avg[d] / bias_correction1) /
+              (std::sqrt(buf.exp_avg_sq[d] / bias_correction2) + eps) +
+          buf.param[d] * weight_decay;
+    }
+  };
+
+  int num_threads = at::get_num_threads();
+  std::vector<float> param_norm_acc(num_threads, 0.f);
+  std::vector<float> rtw_norm_acc(num_threads, 0.f);
+
+  at::parallel_for(0, num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    int tid = at::get_thread_num();
+    block_buffers buf;
+    fVec sum1_fvec = fVec(0.f);
+    fVec sum2_fvec = fVec(0.f);
+    float sum1_val = 0.f;
+    float sum2_val = 0.f;
+    for (int64_t b = begin; b < end; b++) {
+      int64_t offset = b * kQuantizedStateBlockSize;
+      int64_t n = std::min(kQuantizedStateBlockSize, numel - offset);
+      at::BFloat16* param2_ptr = param2_data ? param2_data + offset : nullptr;
+
+      load_param_block(param_data + offset, param2_ptr, buf.param, n);
+      load_grad_block(grad_data + offset, buf.grad, n);
+      dequantize_linear_block(
+          exp_avg_data + offset, exp_avg_absmax_data[b], buf.exp_avg, n);
+      dequantize_dynamic_block(
+          exp_avg_sq_data + offset,
+          exp_avg_sq_absmax_data[b],
+          buf.exp_avg_sq,
+          n);
+      update_moments_block(buf, n, beta1, beta2);
+      requantize_moments_block(
+          buf,
+          n,
+          exp_avg_data + offset,
+          exp_avg_absmax_data[b],
+          exp_avg_sq_data + offset,
+          exp_avg_sq_absmax_data[b]);
+      adam_step_block(buf, n);
+
+      int64_t d = 0;
+      for (; d < n - (n % fVec::size()); d += fVec::size()) {
+        fVec param_fvec = fVec::loadu(buf.param + d);
+        fVec adam_step_fvec = fVec::loadu(buf.grad + d);
+        sum1_fvec += param_fvec * param_fvec;
+        sum2_fvec += adam_step_fvec * adam_step_fvec;
+      }
+      for (; d < n; d++) {
+        sum1_val += buf.param[d] * buf.param[d];
+        sum2_val += buf.grad[d] * buf.grad[d];
+      }
+    }
+    param_norm_acc[tid] += sum1_val + acc_vec(sum1_fvec);
+    rtw_norm_acc[tid] += sum2_val + acc_vec(sum2_fvec);
+  });
+
+  float param_norm_sum = 0.f;
+  float rtw_norm_sum = 0.f;
+  for (int64_t tid = 0; tid < num_threads; tid++) {
+    param_norm_sum += param_norm_acc[tid];
+    rtw_norm_sum += rtw_norm_acc[tid];
+  }
+  float true_ratio = std::sqrt(param_norm_sum) / std::sqrt(rtw_norm_sum);
+  float step_size = float(learning_rate * true_ratio);
+
+  at::parallel_for(0, num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    block_buffers buf;
+    for (int64_t b = begin; b < end; b++) {
+      int64_t offset = b * kQuantizedStateBlockSize;
+      int64_t n = std::min(kQuantizedStateBlockSize, numel - offset);
+      at::BFloat16* param2_ptr = param2_data ? param2_data + offset : nullptr;
+
+      load_param_block(param_data + offset, param2_ptr, buf.param, n);
+      dequantize_linear_block(
+          exp_avg_data + offset, exp_avg_absmax_data[b], buf.exp_avg, n);
+      dequantize_dynamic_block(
+          exp_avg_sq_data + offset,
+          exp_avg_sq_absmax_data[b],
+          buf.exp_avg_sq,
+          n);
+      adam_step_block(buf, n);
+
+      int64_t d = 0;
+      for (; d < n - (n % fVec::size()); d += fVec::size()) {
+        fVec param_fvec = fVec::loadu(buf.param + d) -
+            fVec::loadu(buf.grad + d) * fVec(step_size);
+        param_fvec.store(buf.param + d);
+      }
+      for (; d < n; d++) {
+        buf.param[d] -= buf.grad[d] * step_size;
+      }
+      store_param_block(param_data + offset, param2_ptr, buf.param, n);
+    }
+  });
+}
+
+void check_quantized_states(
+    const at::Tensor& param,
+    const at::Tensor& param2,
+    const at::Tensor& grad) {
+  auto param_dtype = param.scalar_type();
+  auto grad_dtype = grad.scalar_type();
+  TORCH_CHECK(
+      (param_dtype == at::kFloat && grad_dtype == at::kFloat) ||
+          (param_dtype == at::kFloat && grad_dtype == at::kBFloat16) ||
+          (param_dtype == at::kBFloat16 && grad_dtype == at::kBFloat16),
+      "quantized optimizer states expect float or bfloat16 param and grad, "
+      "got param ",
+      param_dtype,
+      " and grad ",
+      grad_dtype);
+  TORCH_CHECK(
+      param2.numel() == 0 || param2.scalar_type() == at::kBFloat16,
+      "quantized optimizer states expect param2 to be at::BFloat16");
+  TORCH_CHECK(
+      param_dtype == at::kFloat || param2.numel() != 0,
+      "quantized optimizer states expect the trail of bfloat16 param");
+}
+
+template <typename F>
+void dispatch_quantized_state_step(
+    const at::Tensor& param,
+    const at::Tensor& grad,
+    const F& f) {
+  if (param.scalar_type() == at::kBFloat16) {
+    f(at::BFloat16(), at::BFloat16());
+  } else if (grad.scalar_type() == at::kBFloat16) {
+    f(float(), at::BFloat16());
+  } else {
+    f(float(), float());
+  }
+}
+
+void adam_fused_step_8bit_kernel_impl(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg,
+    const at::Tensor& exp_avg_absmax,
+    const at::Tensor& exp_avg_sq,
+    const at::Tensor& exp_avg_sq_absmax,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    double step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps) {
+  check_quantized_states(param_, param2_, grad_);
+  auto param = param_.contiguous();
+  auto grad = grad_.contiguous();
+  auto param2 = param2_.contiguous();
+
+  dispatch_quantized_state_step(param, grad, [&](auto param_t, auto grad_t) {
+    adam_fused_step_8bit_kernel<decltype(param_t), decltype(grad_t)>(
+        param,
+        exp_avg,
+        exp_avg_absmax,
+        exp_avg_sq,
+        exp_avg_sq_absmax,
+        grad,
+        param2,
+        step,
+        beta1,
+        beta2,
+        learning_rate,
+        weight_decay,
+        eps);
+  });
+
+  if (!param_.is_contiguous()) {
+    param_.copy_(param);
+  }
+  if (!param2_.is_contiguous()) {
+    param2_.copy_(param2);
+  }
+}
+
+void lamb_fused_step_8bit_kernel_impl(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg,
+    const at::Tensor& exp_avg_absmax,
+    const at::Tensor& exp_avg_sq,
+    const at::Tensor& exp_avg_sq_absmax,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    int64_t step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps) {
+  check_quantized_states(param_, param2_, grad_);
+  auto param = param_.contiguous();
+  auto grad = grad_.contiguous();
+  auto param2 = param2_.contiguous();
+
+  dispatch_quantized_state_step(param, grad, [&](auto param_t, auto grad_t) {
+    lamb_fused_step_8bit_kernel<decltype(param_t), decltype(grad_t)>(
+        param,
+        exp_avg,
+        exp_avg_absmax,
+        exp_avg_sq,
+        exp_avg_sq_absmax,
+        grad,
+        param2,
+        step,
+        beta1,
+        beta2,
+        learning_rate,
+        weight_decay,
+        eps);
+  });
+
+  if (!param_.is_contiguous()) {
+    param_.copy_(param);
+  }
+  if (!param2_.is_contiguous()) {
+    param2_.copy_(param2);
+  }
+}
+
+std::tuple<at::Tensor, at::Tensor> quantize_optimizer_state_kernel_impl(
+    const at::Tensor& state_,
+    bool dynamic_exponent) {
+  auto state = state_.contiguous().to(at::kFloat);
+  int64_t numel = state.numel();
+  int64_t num_blocks =
+      (numel + kQuantizedStateBlockSize - 1) / kQuantizedStateBlockSize;
+  auto q = at::empty({numel}, dynamic_exponent ? at::kByte : at::kChar);
+  auto absmax = at::empty({num_blocks}, at::kFloat);
+  const float* state_data = state.data_ptr<float>();
+  float* absmax_data = absmax.data_ptr<float>();
+
+  at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      int64_t offset = b * kQuantizedStateBlockSize;
+      int64_t n = std::min(kQuantizedStateBlockSize, numel - offset);
+      if (dynamic_exponent) {
+        absmax_data[b] = quantize_dynamic_block(
+            state_data + offset, q.data_ptr<uint8_t>() + offset, n);
+      } else {
+        absmax_data[b] = quantize_linear_block(
+            state_data + offset, q.data_ptr<int8_t>() + offset, n);
+      }
+    }
+  });
+  return std::make_tuple(q, absmax);
+}
+
+at::Tensor dequantize_optimizer_state_kernel_impl(
+    const at::Tensor& q,
+    const at::Tensor& absmax,
+    bool dynamic_exponent) {
+  int64_t numel = q.numel();
+  auto state = at::empty({numel}, at::kFloat);
+  float* state_data = state.data_ptr<float>();
+  const float* absmax_data = absmax.data_ptr<float>();
+
+  at::parallel_for(0, absmax.numel(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      int64_t offset = b * kQuantizedStateBlockSize;
+      int64_t n = std::min(kQuantizedStateBlockSize, numel - offset);
+      if (dynamic_exponent) {
+        dequantize_dynamic_block(
+            q.data_ptr<uint8_t>() + offset,
+            absmax_data[b],
+            state_data + offset,
+            n);
+      } else {
+        dequantize_linear_block(
+            q.data_ptr<int8_t>() + offset,
+            absmax_data[b],
+            state_data + offset,
+            n);
+      }
+    }
+  });
+  return state;
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(
+    adam_fused_step_8bit_kernel_stub,
+    &adam_fused_step_8bit_kernel_impl);
+REGISTER_DISPATCH(
+    lamb_fused_step_8bit_kernel_stub,
+    &lamb_fused_step_8bit_kernel_impl);
+REGISTER_DISPATCH(
+    quantize_optimizer_state_kernel_stub,
+    &quantize_optimizer_state_kernel_impl);
+REGISTER_DISPATCH(
+    dequantize_optimizer_state_kernel_stub,
+    &dequantize_optimizer_state_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -9,7 +9,7 @@ namespace cpu {
 
 DEFINE_DISPATCH(adam_fused_step_kernel_stub);
 
-void adam_fused_step(
+void adam_fused_step_scaled(
     const at::Tensor& param_,
     const at::Tensor& exp_avg_,
     const at::Tensor& exp_avg_sq_,
@@ -22,10 +22,8 @@ void adam_fused_step(
     double beta2,
     double learning_rate,
     double weight_decay,
-    double eps) {
-  RECORD_FUNCTION(
-      "torch_ipex::adam_fused_step", c10::ArrayRef<c10::IValue>({}));
-
+    double eps,
+    double grad_scale) {
   TORCH_CHECK(
       learning_rate >= 0, "Expect learning rate >= 0.0, got ", learning_rate);
   TORCH_CHECK(eps >= 0, "Expect eps >= 0.0, got ", eps);
@@ -81,7 +79,8 @@ void adam_fused_step(
       beta2,
       learning_rate,
       weight_decay,
-      eps);
+      eps,
+      grad_scale);
   */
   adam_fused_step_kernel_stub(
       kCPU,
@@ -97,7 +96,42 @@ void adam_fused_step(
       beta2,
       learning_rate,
       weight_decay,
-      eps);
+      eps,
+      grad_scale);
+}
+
+void adam_fused_step(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& max_exp_avg_sq_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    bool amsgrad,
+    double step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps) {
+  RECORD_FUNCTION(
+      "torch_ipex::adam_fused_step", c10::ArrayRef<c10::IValue>({}));
+
+  adam_fused_step_scaled(
+      param_,
+      exp_avg_,
+      exp_avg_sq_,
+      max_exp_avg_sq_,
+      grad_,
+      param2_,
+      amsgrad,
+      step,
+      beta1,
+      beta2,
+      learning_rate,
+      weight_decay,
+      eps,
+      /*grad_scale=*/1.0);
 }
 
 } // namespace cpu
@@ -0,0 +1,59 @@
+#include "optimizer.h"
+
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+#include <cmath>
+
+namespace torch_ipex {
+namespace cpu {
+
+DEFINE_DISPATCH(grad_norm_sq_kernel_stub);
+
+/**
+ * First phase of the fused gradient clipping + AMP unscale + optimizer step:
+ * a single parallel pass over all gradients computing their global L2 norm
+ * and checking them for inf/nan. The second phase is a multi-tensor fused
+ * step with grad_scale = inv_scale * clip_coef, so that the gradients are
+ * read only twice per training step.
+ *@param grads Gradients of all parameters, still multiplied by the AMP scale
+ *@return The global norm of grads, and whether any of them has inf/nan
+ */
+std::tuple<double, bool> grad_norm_non_finite_check(at::TensorList grads) {
+  RECORD_FUNCTION(
+      "torch_ipex::grad_norm_non_finite_check",
+      c10::ArrayRef<c10::IValue>({}));
+
+  std::vector<int64_t> numels(grads.size());
+  for (size_t i = 0; i < grads.size(); i++) {
+    TORCH_CHECK(
+        grads[i].layout() == at::kStrided,
+        "grad_norm_non_finite_check expects strided grads");
+    numels[i] = grads[i].numel();
+  }
+
+  std::vector<double> norm_sqs(grads.size(), 0.0);
+  multi_tensor_apply(numels, [&](int64_t i) {
+    norm_sqs[i] = grad_norm_sq_kernel_stub(kCPU, grads[i]);
+  });
+
+  double total_norm_sq = 0.0;
+  for (auto norm_sq : norm_sqs) {
+    total_norm_sq += norm_sq;
+  }
+  bool found_inf = !std::isfinite(total_norm_sq);
+  return std::make_tuple(std::sqrt(total_norm_sq), found_inf);
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "grad_norm_non_finite_check(Tensor[] grads) -> (float, bool)",
+      torch_ipex::cpu::grad_norm_non_finite_check);
+}
+
+} // namespace
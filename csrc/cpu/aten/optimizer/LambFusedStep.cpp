@@ -9,7 +9,7 @@ namespace cpu {
 
 DEFINE_DISPATCH(lamb_fused_step_kernel_stub);
 
-std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step(
+std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step_scaled(
     const at::Tensor& param_,
     const at::Tensor& exp_avg_,
     const at::Tensor& exp_avg_sq_,
@@ -20,10 +20,8 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step(
     double beta2,
     double learning_rate,
     double weight_decay,
-    double eps) {
-  RECORD_FUNCTION(
-      "torch_ipex::lamb_fused_step", c10::ArrayRef<c10::IValue>({}));
-
+    double eps,
+    double grad_scale) {
   TORCH_CHECK(
       learning_rate >= 0, "Expect learning rate >= 0.0, got ", learning_rate);
   TORCH_CHECK(eps >= 0, "Expect eps >= 0.0, got ", eps);
@@ -69,7 +67,8 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step(
       beta2,
       learning_rate,
       weight_decay,
-      eps);
+      eps,
+      grad_scale);
   */
   return lamb_fused_step_kernel_stub(
       kCPU,
@@ -83,7 +82,38 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step(
       beta2,
       learning_rate,
       weight_decay,
-      eps);
+      eps,
+      grad_scale);
+}
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    int64_t step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps) {
+  RECORD_FUNCTION(
+      "torch_ipex::lamb_fused_step", c10::ArrayRef<c10::IValue>({}));
+
+  return lamb_fused_step_scaled(
+      param_,
+      exp_avg_,
+      exp_avg_sq_,
+      grad_,
+      param2_,
+      step,
+      beta1,
+      beta2,
+      learning_rate,
+      weight_decay,
+      eps,
+      /*grad_scale=*/1.0);
 }
 
 } // namespace cpu
@@ -84,7 +84,8 @@ c10::optional<at::Tensor> lars_fused_step(
       learning_rate,
       weight_decay,
       dampening,
-      nesterov);
+      nesterov,
+      /*grad_scale=*/1.0);
 }
 
 } // namespace cpu
@@ -0,0 +1,264 @@
+#include "optimizer.h"
+
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+std::vector<int64_t> get_numels(at::TensorList params) {
+  std::vector<int64_t> numels(params.size());
+  for (size_t i = 0; i < params.size(); i++) {
+    numels[i] = params[i].numel();
+  }
+  return numels;
+}
+
+void check_list_size(at::TensorList params, size_t size, const char* name) {
+  TORCH_CHECK(
+      params.size() == size,
+      "Expect params and ",
+      name,
+      " have the same length, params length: ",
+      params.size(),
+      "; ",
+      name,
+      " length: ",
+      size);
+}
+
+} // namespace
+
+/**
+ * Multi-tensor Adam fused update, see adam_fused_step for the update of each
+ * parameter. All parameters of a param group are updated in a single parallel
+ * region instead of one region per parameter.
+ *@param steps Step of each parameter, after increment
+ *@param max_exp_avg_sqs Only used, and required, when amsgrad is true
+ *@param grad_scale Multiplier of all grads, see adam_fused_step_scaled
+ */
+void adam_fused_step_multi_tensor(
+    at::TensorList params,
+    at::TensorList exp_avgs,
+    at::TensorList exp_avg_sqs,
+    at::TensorList max_exp_avg_sqs,
+    at::TensorList grads,
+    at::TensorList params2,
+    bool amsgrad,
+    at::ArrayRef<double> steps,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps,
+    double grad_scale) {
+  RECORD_FUNCTION(
+      "torch_ipex::adam_fused_step_multi_tensor",
+      c10::ArrayRef<c10::IValue>({}));
+
+  check_list_size(params, exp_avgs.size(), "exp_avgs");
+  check_list_size(params, exp_avg_sqs.size(), "exp_avg_sqs");
+  check_list_size(params, grads.size(), "grads");
+  check_list_size(params, params2.size(), "params2");
+  check_list_size(params, steps.size(), "steps");
+  if (amsgrad) {
+    check_list_size(params, max_exp_avg_sqs.size(), "max_exp_avg_sqs");
+  }
+
+  multi_tensor_apply(get_numels(params), [&](int64_t i) {
+    adam_fused_step_scaled(
+        params[i],
+        exp_avgs[i],
+        exp_avg_sqs[i],
+        amsgrad ? max_exp_avg_sqs[i] : at::empty({0}, exp_avgs[i].options()),
+        grads[i],
+        params2[i],
+        amsgrad,
+        steps[i],
+        beta1,
+        beta2,
+        learning_rate,
+        weight_decay,
+        eps,
+        grad_scale);
+  });
+}
+
+/**
+ * Multi-tensor Lamb fused update, see lamb_fused_step for the update of each
+ * parameter. The trust ratio is still computed per parameter.
+ *@param steps Step of each parameter, after increment
+ *@param grad_scale Multiplier of all grads, see lamb_fused_step_scaled
+ */
+void lamb_fused_step_multi_tensor(
+    at::TensorList params,
+    at::TensorList exp_avgs,
+    at::TensorList exp_avg_sqs,
+    at::TensorList grads,
+    at::TensorList params2,
+    at::IntArrayRef steps,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps,
+    double grad_scale) {
+  RECORD_FUNCTION(
+      "torch_ipex::lamb_fused_step_multi_tensor",
+      c10::ArrayRef<c10::IValue>({}));
+
+  check_list_size(params, exp_avgs.size(), "exp_avgs");
+  check_list_size(params, exp_avg_sqs.size(), "exp_avg_sqs");
+  check_list_size(params, grads.size(), "grads");
+  check_list_size(params, params2.size(), "params2");
+  check_list_size(params, steps.size(), "steps");
+
+  multi_tensor_apply(get_numels(params), [&](int64_t i) {
+    lamb_fused_step_scaled(
+        params[i],
+        exp_avgs[i],
+        exp_avg_sqs[i],
+        grads[i],
+        params2[i],
+        steps[i],
+        beta1,
+        beta2,
+        learning_rate,
+        weight_decay,
+        eps,
+        grad_scale);
+  });
+}
+
+/**
+ * Multi-tensor SGD fused update, see sgd_fused_step for the update of each
+ * parameter.
+ *@param momentum_bufs Momentum buffer of each parameter, None if not
+ *initialized yet
+ *@param grad_scale Multiplier of all grads, see sgd_fused_step_scaled
+ *@return The momentum buffers of all parameters, empty if momentum is 0
+ */
+std::vector<at::Tensor> sgd_fused_step_multi_tensor(
+    at::TensorList params,
+    at::TensorList grads,
+    const c10::List<c10::optional<at::Tensor>>& momentum_bufs,
+    at::TensorList params2,
+    double momentum,
+    double learning_rate,
+    double weight_decay,
+    double dampening,
+    bool nesterov,
+    double grad_scale) {
+  RECORD_FUNCTION(
+      "torch_ipex::sgd_fused_step_multi_tensor",
+      c10::ArrayRef<c10::IValue>({}));
+
+  check_list_size(params, grads.size(), "grads");
+  check_list_size(params, momentum_bufs.size(), "momentum_bufs");
+  check_list_size(params, params2.size(), "params2");
+
+  std::vector<c10::optional<at::Tensor>> bufs;
+  bufs.reserve(momentum_bufs.size());
+  for (size_t i = 0; i < momentum_bufs.size(); i++) {
+    bufs.push_back(momentum_bufs.get(i));
+  }
+  std::vector<at::Tensor> new_bufs(params.size());
+  multi_tensor_apply(get_numels(params), [&](int64_t i) {
+    // the single tensor op takes mutable references
+    at::Tensor param = params[i];
+    at::Tensor param2 = params2[i];
+    auto buf = sgd_fused_step_scaled(
+        param,
+        grads[i],
+        bufs[i],
+        param2,
+        momentum,
+        learning_rate,
+        weight_decay,
+        dampening,
+        nesterov,
+        grad_scale);
+    if (buf.has_value()) {
+      new_bufs[i] = buf.value();
+    }
+  });
+
+  if (momentum == 0) {
+    return {};
+  }
+  return new_bufs;
+}
+
+/**
+ * Multi-tensor Adagrad fused update, see adagrad_fused_step for the update of
+ * each parameter.
+ *@param steps Step of each parameter, after increment
+ */
+void adagrad_fused_step_multi_tensor(
+    at::TensorList params,
+    at::TensorList grads,
+    at::TensorList state_sums,
+    at::TensorList params2,
+    at::ArrayRef<double> steps,
+    double learning_rate,
+    double weight_decay,
+    double lr_decay,
+    double eps) {
+  RECORD_FUNCTION(
+      "torch_ipex::adagrad_fused_step_multi_tensor",
+      c10::ArrayRef<c10::IValue>({}));
+
+  check_list_size(params, grads.size(), "grads");
+  check_list_size(params, state_sums.size(), "state_sums");
+  check_list_size(params, params2.size(), "params2");
+  check_list_size(params, steps.size(), "steps");
+
+  multi_tensor_apply(get_numels(params), [&](int64_t i) {
+    adagrad_fused_step(
+        params[i],
+        grads[i],
+        state_sums[i],
+        params2[i],
+        steps[i],
+        learning_rate,
+        weight_decay,
+        lr_decay,
+        eps);
+  });
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "adam_fused_step_multi_tensor(Tensor(a!)[] params, Tensor(b!)[] "
+      "exp_avgs, Tensor(c!)[] exp_avg_sqs, Tensor(d!)[] max_exp_avg_sqs, "
+      "Tensor[] grads, Tensor(e!)[] params2, bool amsgrad, float[] steps, "
+      "float beta1, float beta2, float lr, float weight_decay, float eps, "
+      "float grad_scale=1.) -> ()",
+      torch_ipex::cpu::adam_fused_step_multi_tensor);
+  m.def(
+      "lamb_fused_step_multi_tensor(Tensor(a!)[] params, Tensor(b!)[] "
+      "exp_avgs, Tensor(c!)[] exp_avg_sqs, Tensor(d!)[] grads, Tensor(e!)[] "
+      "params2, int[] steps, float beta1, float beta2, float lr, "
+      "float weight_decay, float eps, float grad_scale=1.) -> ()",
+      torch_ipex::cpu::lamb_fused_step_multi_tensor);
+  m.def(
+      "sgd_fused_step_multi_tensor(Tensor(a!)[] params, Tensor[] grads, "
+      "Tensor?[] momentum_bufs, Tensor(b!)[] params2, float momentum, "
+      "float lr, float weight_decay, float dampening, bool nesterov, "
+      "float grad_scale=1.) -> Tensor[]",
+      torch_ipex::cpu::sgd_fused_step_multi_tensor);
+  m.def(
+      "adagrad_fused_step_multi_tensor(Tensor(a!)[] params, Tensor[] grads, "
+      "Tensor(b!)[] state_sums, Tensor(c!)[] params2, float[] steps, "
+      "float lr, float weight_decay, float lr_decay, float eps) -> ()",
+      torch_ipex::cpu::adagrad_fused_step_multi_tensor);
+}
+
+} // namespace
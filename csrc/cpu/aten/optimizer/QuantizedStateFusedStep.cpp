@@ -0,0 +1,261 @@
+#include "optimizer.h"
+
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+DEFINE_DISPATCH(adam_fused_step_8bit_kernel_stub);
+DEFINE_DISPATCH(lamb_fused_step_8bit_kernel_stub);
+DEFINE_DISPATCH(quantize_optimizer_state_kernel_stub);
+DEFINE_DISPATCH(dequantize_optimizer_state_kernel_stub);
+
+namespace {
+
+void check_quantized_state(
+    const at::Tensor& param,
+    const at::Tensor& q,
+    const at::Tensor& absmax,
+    at::ScalarType dtype,
+    const char* name) {
+  int64_t num_blocks = (param.numel() + kQuantizedStateBlockSize - 1) /
+      kQuantizedStateBlockSize;
+  TORCH_CHECK(
+      q.scalar_type() == dtype && q.is_contiguous() &&
+          q.numel() == param.numel(),
+      "Expect ",
+      name,
+      " to be a contiguous ",
+      dtype,
+      " tensor with ",
+      param.numel(),
+      " elements");
+  TORCH_CHECK(
+      absmax.scalar_type() == at::kFloat && absmax.is_contiguous() &&
+          absmax.numel() == num_blocks,
+      "Expect ",
+      name,
+      "_absmax to be a contiguous float tensor with ",
+      num_blocks,
+      " elements");
+}
+
+void check_quantized_step_args(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_absmax_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& exp_avg_sq_absmax_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps) {
+  TORCH_CHECK(
+      learning_rate >= 0, "Expect learning rate >= 0.0, got ", learning_rate);
+  TORCH_CHECK(eps >= 0, "Expect eps >= 0.0, got ", eps);
+  TORCH_CHECK(beta1 >= 0 && beta1 < 1, "Expect 0.0 <= beta1 < 1.0, got", beta1);
+  TORCH_CHECK(beta2 >= 0 && beta2 < 1, "Expect 0.0 <= beta2 < 1.0, got", beta2);
+  TORCH_CHECK(
+      weight_decay >= 0, "Expect weight_decay >= 0.0, got ", weight_decay);
+
+  TORCH_CHECK(
+      param_.sizes() == grad_.sizes(),
+      "Expect param and grad have the same sizes, param sizes: ",
+      param_.sizes(),
+      "; grad sizes: ",
+      grad_.sizes());
+  TORCH_CHECK(
+      param2_.numel() == 0 || param_.sizes() == param2_.sizes(),
+      "Expect param and param2_ have the same sizes, param sizes: ",
+      param_.sizes(),
+      "; param2_ sizes: ",
+      param2_.sizes());
+  check_quantized_state(
+      param_, exp_avg_, exp_avg_absmax_, at::kChar, "exp_avg");
+  check_quantized_state(
+      param_, exp_avg_sq_, exp_avg_sq_absmax_, at::kByte, "exp_avg_sq");
+}
+
+} // namespace
+
+/**
+ * Adam fused update with 8-bit block-quantized states.
+ *@param exp_avg_ First moment, int8 with one absmax per
+ *kQuantizedStateBlockSize elements in exp_avg_absmax_
+ *@param exp_avg_sq_ Second moment, uint8 dynamic exponent codes with one
+ *absmax per block in exp_avg_sq_absmax_
+ * Other args are the same as adam_fused_step, amsgrad is not supported.
+ */
+void adam_fused_step_8bit(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_absmax_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& exp_avg_sq_absmax_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    double step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps) {
+  RECORD_FUNCTION(
+      "torch_ipex::adam_fused_step_8bit", c10::ArrayRef<c10::IValue>({}));
+
+  check_quantized_step_args(
+      param_,
+      exp_avg_,
+      exp_avg_absmax_,
+      exp_avg_sq_,
+      exp_avg_sq_absmax_,
+      grad_,
+      param2_,
+      beta1,
+      beta2,
+      learning_rate,
+      weight_decay,
+      eps);
+
+  adam_fused_step_8bit_kernel_stub(
+      kCPU,
+      param_,
+      exp_avg_,
+      exp_avg_absmax_,
+      exp_avg_sq_,
+      exp_avg_sq_absmax_,
+      grad_,
+      param2_,
+      step,
+      beta1,
+      beta2,
+      learning_rate,
+      weight_decay,
+      eps);
+}
+
+/**
+ * Lamb fused update with 8-bit block-quantized states, the states are the
+ * same as adam_fused_step_8bit and other args the same as lamb_fused_step.
+ */
+void lamb_fused_step_8bit(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_absmax_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& exp_avg_sq_absmax_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    int64_t step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps) {
+  RECORD_FUNCTION(
+      "torch_ipex::lamb_fused_step_8bit", c10::ArrayRef<c10::IValue>({}));
+
+  check_quantized_step_args(
+      param_,
+      exp_avg_,
+      exp_avg_absmax_,
+      exp_avg_sq_,
+      exp_avg_sq_absmax_,
+      grad_,
+      param2_,
+      beta1,
+      beta2,
+      learning_rate,
+      weight_decay,
+      eps);
+
+  lamb_fused_step_8bit_kernel_stub(
+      kCPU,
+      param_,
+      exp_avg_,
+      exp_avg_absmax_,
+      exp_avg_sq_,
+      exp_avg_sq_absmax_,
+      grad_,
+      param2_,
+      step,
+      beta1,
+      beta2,
+      learning_rate,
+      weight_decay,
+      eps);
+}
+
+/**
+ * Quantizes an optimizer state to the format of the 8-bit fused steps, e.g.
+ * to convert the states of a checkpoint.
+ *@param dynamic_exponent uint8 dynamic exponent codes (second moment) if
+ *true, linear int8 (first moment) otherwise
+ *@return The flattened quantized state and the absmax of each block
+ */
+std::tuple<at::Tensor, at::Tensor> quantize_optimizer_state(
+    const at::Tensor& state,
+    bool dynamic_exponent) {
+  RECORD_FUNCTION(
+      "torch_ipex::quantize_optimizer_state", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      !dynamic_exponent || state.min().item<double>() >= 0,
+      "Expect a non-negative state for dynamic exponent quantization");
+  return quantize_optimizer_state_kernel_stub(kCPU, state, dynamic_exponent);
+}
+
+/**
+ * Inverse of quantize_optimizer_state, returns a flattened float state.
+ */
+at::Tensor dequantize_optimizer_state(
+    const at::Tensor& q,
+    const at::Tensor& absmax,
+    bool dynamic_exponent) {
+  RECORD_FUNCTION(
+      "torch_ipex::dequantize_optimizer_state",
+      c10::ArrayRef<c10::IValue>({}));
+  check_quantized_state(
+      q,
+      q,
+      absmax,
+      dynamic_exponent ? at::kByte : at::kChar,
+      "quantized state");
+  return dequantize_optimizer_state_kernel_stub(
+      kCPU, q, absmax, dynamic_exponent);
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "adam_fused_step_8bit(Tensor(a!) param, Tensor(b!) exp_avg, "
+      "Tensor(c!) exp_avg_absmax, Tensor(d!) exp_avg_sq, "
+      "Tensor(e!) exp_avg_sq_absmax, Tensor grad, Tensor(f!) param2, "
+      "float step, float beta1, float beta2, float lr, float weight_decay, "
+      "float eps) -> ()",
+      torch_ipex::cpu::adam_fused_step_8bit);
+  m.def(
+      "lamb_fused_step_8bit(Tensor(a!) param, Tensor(b!) exp_avg, "
+      "Tensor(c!) exp_avg_absmax, Tensor(d!) exp_avg_sq, "
+      "Tensor(e!) exp_avg_sq_absmax, Tensor grad, Tensor(f!) param2, "
+      "int step, float beta1, float beta2, float lr, float weight_decay, "
+      "float eps) -> ()",
+      torch_ipex::cpu::lamb_fused_step_8bit);
+  m.def(
+      "quantize_optimizer_state(Tensor state, bool dynamic_exponent) -> "
+      "(Tensor, Tensor)",
+      torch_ipex::cpu::quantize_optimizer_state);
+  m.def(
+      "dequantize_optimizer_state(Tensor q, Tensor absmax, "
+      "bool dynamic_exponent) -> Tensor",
+      torch_ipex::cpu::dequantize_optimizer_state);
+}
+
+} // namespace
@@ -23,8 +23,9 @@ DEFINE_DISPATCH(sgd_fused_step_kernel_stub);
  *@param weight_decay Args for regularization to avoid over-fit.
  *@param dampening Attribute for momentum.
  *@param nesterov Attribute for momentum.
+ *@param grad_scale Multiplier of grad, e.g. AMP unscale and clip coefficient
  */
-c10::optional<at::Tensor> sgd_fused_step(
+c10::optional<at::Tensor> sgd_fused_step_scaled(
     at::Tensor& param_,
     const at::Tensor& grad_,
     const c10::optional<at::Tensor>& momentum_buf_,
@@ -33,9 +34,8 @@ c10::optional<at::Tensor> sgd_fused_step(
     double learning_rate,
     double weight_decay,
     double dampening,
-    bool nesterov) {
-  RECORD_FUNCTION("torch_ipex::sgd_fused_step", c10::ArrayRef<c10::IValue>({}));
-
+    bool nesterov,
+    double grad_scale) {
   TORCH_CHECK(
       weight_decay >= 0, "Expect weight_decay >= 0.0, got ", weight_decay);
 
@@ -69,7 +69,8 @@ c10::optional<at::Tensor> sgd_fused_step(
       learning_rate,
       weight_decay,
       dampening,
-      nesterov);
+      nesterov,
+      grad_scale);
   */
   return sgd_fused_step_kernel_stub(
       kCPU,
@@ -81,7 +82,33 @@ c10::optional<at::Tensor> sgd_fused_step(
       learning_rate,
       weight_decay,
       dampening,
-      nesterov);
+      nesterov,
+      grad_scale);
+}
+
+c10::optional<at::Tensor> sgd_fused_step(
+    at::Tensor& param_,
+    const at::Tensor& grad_,
+    const c10::optional<at::Tensor>& momentum_buf_,
+    at::Tensor& param2_,
+    double momentum,
+    double learning_rate,
+    double weight_decay,
+    double dampening,
+    bool nesterov) {
+  RECORD_FUNCTION("torch_ipex::sgd_fused_step", c10::ArrayRef<c10::IValue>({}));
+
+  return sgd_fused_step_scaled(
+      param_,
+      grad_,
+      momentum_buf_,
+      param2_,
+      momentum,
+      learning_rate,
+      weight_decay,
+      dampening,
+      nesterov,
+      /*grad_scale=*/1.0);
 }
 
 } // namespace cpu
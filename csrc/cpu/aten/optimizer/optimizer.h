@@ -1,7 +1,13 @@
 #pragma once
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <dyndisp/DispatchStub.h>
 
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <vector>
+
 namespace torch_ipex {
 namespace cpu {
 
@@ -18,7 +24,8 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step_kernel_impl(
     double beta2,
     double learning_rate,
     double weight_decay,
-    double eps);
+    double eps,
+    double grad_scale);
 
 std::tuple<at::Tensor, at::Tensor> adagrad_fused_step_kernel_impl(
     const at::Tensor& param_,
@@ -40,7 +47,8 @@ c10::optional<at::Tensor> sgd_fused_step_kernel_impl(
     double learning_rate,
     double weight_decay,
     double dampening,
-    bool nesterov);
+    bool nesterov,
+    double grad_scale);
 
 at::Tensor packed_add_kernel_impl(
     at::Tensor& top_half,
@@ -61,7 +69,8 @@ void adam_fused_step_kernel_impl(
     double beta2,
     double learning_rate,
     double weight_decay,
-    double eps);
+    double eps,
+    double grad_scale);
 
 } // namespace
 
@@ -89,6 +98,7 @@ using lamb_fused_step_kernel_fn =
         double,
         double,
         double,
+        double,
         double);
 DECLARE_DISPATCH(lamb_fused_step_kernel_fn, lamb_fused_step_kernel_stub);
 
@@ -101,7 +111,8 @@ using sgd_fused_step_kernel_fn = c10::optional<at::Tensor> (*)(
     double,
     double,
     double,
-    bool);
+    bool,
+    double);
 DECLARE_DISPATCH(sgd_fused_step_kernel_fn, sgd_fused_step_kernel_stub);
 
 using packed_add_kernel_fn =
@@ -121,6 +132,7 @@ using adam_fused_step_kernel_fn = void (*)(
     double,
     double,
     double,
+    double,
     double);
 DECLARE_DISPATCH(adam_fused_step_kernel_fn, adam_fused_step_kernel_stub);
 
@@ -128,5 +140,216 @@ using lars_norm_kernel_fn = float (*)(const at::Tensor&);
 
 DECLARE_DISPATCH(lars_norm_kernel_fn, lars_norm_kernel_stub);
 
+// Sum of squares of a gradient, non-finite if the gradient has inf/nan
+using grad_norm_sq_kernel_fn = double (*)(const at::Tensor&);
+DECLARE_DISPATCH(grad_norm_sq_kernel_fn, grad_norm_sq_kernel_stub);
+
+// Number of elements sharing one absmax in quantized optimizer states
+constexpr int64_t kQuantizedStateBlockSize = 256;
+
+using adam_fused_step_8bit_kernel_fn = void (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    double,
+    double,
+    double,
+    double,
+    double,
+    double);
+DECLARE_DISPATCH(
+    adam_fused_step_8bit_kernel_fn,
+    adam_fused_step_8bit_kernel_stub);
+
+using lamb_fused_step_8bit_kernel_fn = void (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    int64_t,
+    double,
+    double,
+    double,
+    double,
+    double);
+DECLARE_DISPATCH(
+    lamb_fused_step_8bit_kernel_fn,
+    lamb_fused_step_8bit_kernel_stub);
+
+using quantize_optimizer_state_kernel_fn =
+    std::tuple<at::Tensor, at::Tensor> (*)(const at::Tensor&, bool);
+DECLARE_DISPATCH(
+    quantize_optimizer_state_kernel_fn,
+    quantize_optimizer_state_kernel_stub);
+
+using dequantize_optimizer_state_kernel_fn =
+    at::Tensor (*)(const at::Tensor&, const at::Tensor&, bool);
+DECLARE_DISPATCH(
+    dequantize_optimizer_state_kernel_fn,
+    dequantize_optimizer_state_kernel_stub);
+
+void adam_fused_step(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& max_exp_avg_sq_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    bool amsgrad,
+    double step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps);
+
+// The fused steps below multiply the gradient by grad_scale as it is loaded,
+// so that AMP unscaling and gradient clipping cost no extra pass over the
+// gradients. The single tensor ops above are the grad_scale == 1 case.
+void adam_fused_step_scaled(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& max_exp_avg_sq_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    bool amsgrad,
+    double step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps,
+    double grad_scale);
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step_scaled(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    int64_t step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps,
+    double grad_scale);
+
+c10::optional<at::Tensor> sgd_fused_step_scaled(
+    at::Tensor& param_,
+    const at::Tensor& grad_,
+    const c10::optional<at::Tensor>& momentum_buf_,
+    at::Tensor& param2_,
+    double momentum,
+    double learning_rate,
+    double weight_decay,
+    double dampening,
+    bool nesterov,
+    double grad_scale);
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> lamb_fused_step(
+    const at::Tensor& param_,
+    const at::Tensor& exp_avg_,
+    const at::Tensor& exp_avg_sq_,
+    const at::Tensor& grad_,
+    const at::Tensor& param2_,
+    int64_t step,
+    double beta1,
+    double beta2,
+    double learning_rate,
+    double weight_decay,
+    double eps);
+
+c10::optional<at::Tensor> sgd_fused_step(
+    at::Tensor& param_,
+    const at::Tensor& grad_,
+    const c10::optional<at::Tensor>& momentum_buf_,
+    at::Tensor& param2_,
+    double momentum,
+    double learning_rate,
+    double weight_decay,
+    double dampening,
+    bool nesterov);
+
+std::tuple<at::Tensor, at::Tensor> adagrad_fused_step(
+    const at::Tensor& param_,
+    const at::Tensor& grad_,
+    const at::Tensor& state_sum_,
+    const at::Tensor& param2_,
+    double step,
+    double learning_rate,
+    double weight_decay,
+    double lr_decay,
+    double eps);
+
+// Parameters with fewer elements than this are updated whole by a single
+// thread; larger ones are split across all threads by the per-parameter
+// kernels.
+constexpr int64_t kMultiTensorSmallNumel = 65536;
+
+/**
+ * Applies fn(i) to every parameter i of a multi-tensor optimizer step.
+ * Small parameters are distributed over the threads of a single parallel
+ * region, balancing the total number of elements per thread (longest
+ * processing time first). Inside the region the per-parameter kernels run
+ * sequentially, so the fork/join cost is paid once instead of per parameter.
+ *@param numels Number of elements of each parameter
+ *@param fn Update of the i-th parameter
+ */
+inline void multi_tensor_apply(
+    const std::vector<int64_t>& numels,
+    const std::function<void(int64_t)>& fn) {
+  std::vector<int64_t> small;
+  std::vector<int64_t> large;
+  for (int64_t i = 0; i < numels.size(); i++) {
+    if (numels[i] < kMultiTensorSmallNumel) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+
+  if (!small.empty()) {
+    std::sort(small.begin(), small.end(), [&](int64_t a, int64_t b) {
+      return numels[a] > numels[b];
+    });
+    int64_t num_bins =
+        std::min<int64_t>(at::get_num_threads(), (int64_t)small.size());
+    std::vector<std::vector<int64_t>> bins(num_bins);
+    // (load, bin), the least loaded bin on top
+    using load_t = std::pair<int64_t, int64_t>;
+    std::priority_queue<load_t, std::vector<load_t>, std::greater<load_t>>
+        loads;
+    for (int64_t b = 0; b < num_bins; b++) {
+      loads.push({0, b});
+    }
+    for (auto i : small) {
+      auto least = loads.top();
+      loads.pop();
+      bins[least.second].push_back(i);
+      loads.push({least.first + numels[i], least.second});
+    }
+    at::parallel_for(0, num_bins, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        for (auto i : bins[b]) {
+          fn(i);
+        }
+      }
+    });
+  }
+
+  for (auto i : large) {
+    fn(i);
+  }
+}
+
 } // namespace cpu
 } // namespace torch_ipex
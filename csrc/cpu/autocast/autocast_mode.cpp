@@ -2,8 +2,12 @@
 
 #include "library.h"
 
+#include <algorithm>
+#include <atomic>
 #include <exception>
 #include <iostream>
+#include <mutex>
+#include <shared_mutex>
 
 namespace torch_ipex {
 namespace autocast {
@@ -16,6 +20,129 @@ using val_type = std::tuple<weakref_type, at::Tensor>;
 thread_local std::unordered_map<c10::TensorImpl*, val_type> cached_casts;
 
 thread_local at::ScalarType current_target_dtype = at::kBFloat16;
+
+// The weight cast cache of the inference, shared by the threads. The weak
+// reference keeps the TensorImpl of the weight allocated, so its address is not
+// reused by another tensor while it is a key.
+struct WeightCast {
+  weakref_type weight;
+  int64_t version;
+  // a weight replaced by set_data, e.g. `param.data = ...`, keeps its version
+  const void* data;
+  // undefined for a registered weight not cast yet
+  at::Tensor cast;
+  // by register_autocast_weight, kept until the weight is freed
+  bool registered;
+};
+
+// Lookups only take the read lock, so that the threads running the inference
+// don't wait for each other. A cast is added once per weight.
+struct WeightCastCache {
+  std::shared_mutex mutex;
+  std::unordered_map<c10::TensorImpl*, WeightCast> casts;
+};
+
+WeightCastCache& get_weight_cast_cache() {
+  static WeightCastCache cache;
+  return cache;
+}
+
+std::atomic<bool> weight_cache_enabled{true};
+// the lookup of the tensors not requiring grad is skipped when it is 0
+std::atomic<size_t> num_registered_weights{0};
+
+// Drops the casts of the freed weights. Called with the write lock held.
+void drop_expired_weight_casts(WeightCastCache& cache) {
+  for (auto it = cache.casts.begin(); it != cache.casts.end();) {
+    if (it->second.weight.expired()) {
+      if (it->second.registered) {
+        num_registered_weights.fetch_sub(1, std::memory_order_relaxed);
+      }
+      it = cache.casts.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// Whether arg may be a weight of the inference, i.e. outside of grad mode a
+// parameter: a leaf tensor requiring grad, or a tensor registered with
+// register_autocast_weight such as a frozen weight. The other tensors, e.g.
+// the inputs, are never cached, so their casts don't outlive them.
+bool may_be_inference_weight(const Tensor& arg) {
+  if (at::GradMode::is_enabled() || arg.layout() != at::kStrided ||
+      arg.is_inference() || !arg.is_leaf() || arg.is_view()) {
+    return false;
+  }
+  return arg.requires_grad() ||
+      num_registered_weights.load(std::memory_order_relaxed) > 0;
+}
+
+bool is_valid_weight_cast(
+    const WeightCast& weight_cast,
+    const Tensor& arg,
+    at::ScalarType to_type) {
+  // an in-place update of the weight bumps its version
+  return weight_cast.version == arg._version() &&
+      weight_cast.data == arg.data_ptr() &&
+      weight_cast.cast.sizes() == arg.sizes() &&
+      weight_cast.cast.scalar_type() == to_type;
+}
+
+// Returns the cast of arg, and whether arg is a registered weight.
+c10::optional<Tensor> find_weight_cast(
+    const Tensor& arg,
+    at::ScalarType to_type,
+    bool& registered) {
+  auto& cache = get_weight_cast_cache();
+  {
+    std::shared_lock<std::shared_mutex> lock(cache.mutex);
+    auto it = cache.casts.find(arg.unsafeGetTensorImpl());
+    if (it == cache.casts.end()) {
+      return c10::nullopt;
+    }
+    const auto& weight_cast = it->second;
+    registered = weight_cast.registered;
+    if (!weight_cast.cast.defined()) {
+      return c10::nullopt;
+    }
+    if (is_valid_weight_cast(weight_cast, arg, to_type)) {
+      return weight_cast.cast;
+    }
+  }
+  // the cast is stale, drop it with the casts of the freed weights
+  std::unique_lock<std::shared_mutex> lock(cache.mutex);
+  auto it = cache.casts.find(arg.unsafeGetTensorImpl());
+  if (it != cache.casts.end() && it->second.cast.defined() &&
+      !is_valid_weight_cast(it->second, arg, to_type)) {
+    if (it->second.registered) {
+      it->second.cast = at::Tensor();
+    } else {
+      cache.casts.erase(it);
+    }
+  }
+  drop_expired_weight_casts(cache);
+  return c10::nullopt;
+}
+
+void add_weight_cast(const Tensor& arg, const Tensor& cast) {
+  auto& cache = get_weight_cast_cache();
+  std::unique_lock<std::shared_mutex> lock(cache.mutex);
+  drop_expired_weight_casts(cache);
+  auto it = cache.casts.find(arg.unsafeGetTensorImpl());
+  bool registered = it != cache.casts.end() && it->second.registered;
+  if (it != cache.casts.end()) {
+    cache.casts.erase(it);
+  }
+  cache.casts.emplace(
+      arg.unsafeGetTensorImpl(),
+      WeightCast{
+          weakref_type(arg.getIntrusivePtr()),
+          arg._version(),
+          arg.data_ptr(),
+          cast,
+          registered});
+}
 } // namespace
 
 at::ScalarType get_autocast_dtype() {
@@ -30,13 +157,88 @@ void clear_autocast_cache() {
   cached_casts.clear();
 }
 
+void set_autocast_weight_cache_enabled(bool enabled) {
+  weight_cache_enabled.store(enabled, std::memory_order_relaxed);
+  if (!enabled) {
+    clear_autocast_weight_cache();
+  }
+}
+
+bool is_autocast_weight_cache_enabled() {
+  return weight_cache_enabled.load(std::memory_order_relaxed);
+}
+
+void clear_autocast_weight_cache() {
+  auto& cache = get_weight_cast_cache();
+  std::unique_lock<std::shared_mutex> lock(cache.mutex);
+  drop_expired_weight_casts(cache);
+  for (auto it = cache.casts.begin(); it != cache.casts.end();) {
+    if (it->second.registered) {
+      it->second.cast = at::Tensor();
+      ++it;
+    } else {
+      it = cache.casts.erase(it);
+    }
+  }
+}
+
+size_t get_autocast_weight_cache_size() {
+  auto& cache = get_weight_cast_cache();
+  std::shared_lock<std::shared_mutex> lock(cache.mutex);
+  return std::count_if(
+      cache.casts.begin(), cache.casts.end(), [](const auto& weight_cast) {
+        return weight_cast.second.cast.defined();
+      });
+}
+
+void register_autocast_weight(const Tensor& weight) {
+  TORCH_CHECK(
+      weight.layout() == at::kStrided && weight.is_leaf() &&
+          !weight.is_view(),
+      "register_autocast_weight: expected a strided leaf tensor");
+  auto& cache = get_weight_cast_cache();
+  std::unique_lock<std::shared_mutex> lock(cache.mutex);
+  drop_expired_weight_casts(cache);
+  auto it = cache.casts.find(weight.unsafeGetTensorImpl());
+  if (it != cache.casts.end()) {
+    if (!it->second.registered) {
+      it->second.registered = true;
+      num_registered_weights.fetch_add(1, std::memory_order_relaxed);
+    }
+    return;
+  }
+  cache.casts.emplace(
+      weight.unsafeGetTensorImpl(),
+      WeightCast{
+          weakref_type(weight.getIntrusivePtr()),
+          weight._version(),
+          weight.data_ptr(),
+          at::Tensor(),
+          true});
+  num_registered_weights.fetch_add(1, std::memory_order_relaxed);
+}
+
 Tensor cpu_cached_cast(at::ScalarType to_type, const Tensor& arg) {
   if (is_eligible_cpu(arg) && (arg.scalar_type() != to_type)) {
-    bool can_try_cache =
+    // a cast of the persistent cache would be a constant of a traced graph
+    bool can_try_weight_cache =
+        (to_type == current_target_dtype && arg.scalar_type() == at::kFloat &&
+         is_autocast_weight_cache_enabled() &&
+         at::autocast::is_autocast_cache_enabled() &&
+         !torch::jit::tracer::isTracing() && may_be_inference_weight(arg));
+    bool can_try_cache = !can_try_weight_cache &&
         (to_type == current_target_dtype && arg.scalar_type() == at::kFloat &&
          arg.requires_grad() && arg.is_leaf() && !arg.is_view() &&
          at::autocast::is_autocast_cache_enabled());
 
+    if (can_try_weight_cache) {
+      bool registered = false;
+      auto weight_cast = find_weight_cast(arg, to_type, registered);
+      if (weight_cast.has_value()) {
+        return *weight_cast;
+      }
+      can_try_weight_cache = arg.requires_grad() || registered;
+    }
     if (can_try_cache) {
       auto it = cached_casts.find(arg.unsafeGetTensorImpl());
       if (it != cached_casts.end()) {
@@ -54,6 +256,9 @@ Tensor cpu_cached_cast(at::ScalarType to_type, const Tensor& arg) {
       casted_arg = arg.to(at::kFloat);
       // casted_arg = arg.to_dense(at::kFloat);
     }
+    if (can_try_weight_cache) {
+      add_weight_cast(arg, casted_arg);
+    }
     if (can_try_cache) {
       cached_casts.emplace(
           arg.unsafeGetTensorImpl(),
@@ -7,8 +7,10 @@
 #include <dnnl.hpp>
 
 #include <algorithm>
+#include <cctype>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 
 namespace torch_ipex {
 namespace cpu {
@@ -41,6 +43,32 @@ const char* CPUCapabilityToString(CPUCapability isa) {
   }
 }
 
+CPUCapability CPUCapabilityFromString(const std::string& isa) {
+  std::string isa_lower = isa;
+  std::transform(
+      isa_lower.begin(), isa_lower.end(), isa_lower.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      });
+  if (isa_lower == "avx512_fp16") {
+    return CPUCapability::AVX512_FP16;
+  } else if (isa_lower == "amx") {
+    return CPUCapability::AMX;
+  } else if (isa_lower == "avx512_bf16") {
+    return CPUCapability::AVX512_BF16;
+  } else if (isa_lower == "avx512_vnni") {
+    return CPUCapability::AVX512_VNNI;
+  } else if (isa_lower == "avx512") {
+    return CPUCapability::AVX512;
+  } else if (isa_lower == "avx2_vnni") {
+    return CPUCapability::AVX2_VNNI;
+  } else if (isa_lower == "avx2") {
+    return CPUCapability::AVX2;
+  } else if (isa_lower == "default") {
+    return CPUCapability::DEFAULT;
+  }
+  return CPUCapability::NUM_OPTIONS;
+}
+
 CPUCapability _get_highest_cpu_support_isa_level() {
   /*
   reference to FindAVX.cmake
@@ -163,23 +191,8 @@ static CPUCapability compute_cpu_capability() {
   */
   auto envar = std::getenv("ATEN_CPU_CAPABILITY");
   if (envar) {
-    if (strcmp(envar, "avx512_fp16") == 0) {
-      manual_setup_isa_level = CPUCapability::AVX512_FP16;
-    } else if (strcmp(envar, "amx") == 0) {
-      manual_setup_isa_level = CPUCapability::AMX;
-    } else if (strcmp(envar, "avx512_bf16") == 0) {
-      manual_setup_isa_level = CPUCapability::AVX512_BF16;
-    } else if (strcmp(envar, "avx512_vnni") == 0) {
-      manual_setup_isa_level = CPUCapability::AVX512_VNNI;
-    } else if (strcmp(envar, "avx512") == 0) {
-      manual_setup_isa_level = CPUCapability::AVX512;
-    } else if (strcmp(envar, "avx2_vnni") == 0) {
-      manual_setup_isa_level = CPUCapability::AVX2_VNNI;
-    } else if (strcmp(envar, "avx2") == 0) {
-      manual_setup_isa_level = CPUCapability::AVX2;
-    } else if (strcmp(envar, "default") == 0) {
-      manual_setup_isa_level = CPUCapability::DEFAULT;
-    } else {
+    manual_setup_isa_level = CPUCapabilityFromString(envar);
+    if (manual_setup_isa_level == CPUCapability::NUM_OPTIONS) {
       TORCH_WARN("ignoring invalid value for ATEN_CPU_CAPABILITY: ", envar);
       b_manual_setup = false;
     }
@@ -245,6 +258,8 @@ void* DispatchStubImpl::get_call_ptr(
     case DeviceType::CPU: {
       // Use memory_order_relaxed here since even if two threads race,
       // they will still compute the same value for cpu_dispatch_ptr.
+      // The pointer is only set when it is still null, so that a concurrent
+      // set_dispatch_stub_isa_level() is not overwritten.
       auto fptr = cpu_dispatch_ptr.load(std::memory_order_relaxed);
       if (!fptr) {
         fptr = choose_cpu_impl(
@@ -278,7 +293,11 @@ void* DispatchStubImpl::get_call_ptr(
             AVX2
 #endif
         );
-        cpu_dispatch_ptr.store(fptr, std::memory_order_relaxed);
+        void* expected = nullptr;
+        if (!cpu_dispatch_ptr.compare_exchange_strong(
+                expected, fptr, std::memory_order_relaxed)) {
+          fptr = expected;
+        }
       }
       return fptr;
     }
@@ -415,5 +434,165 @@ void* DispatchStubImpl::choose_cpu_impl(
   return DEFAULT;
 }
 
+namespace {
+
+struct DispatchStubRegistry {
+  std::mutex mutex;
+  std::vector<DispatchStubImpl*> stubs;
+};
+
+// The stubs register themselves during the static initialization, a function
+// local static avoids depending on the initialization order of the
+// translation units.
+DispatchStubRegistry& get_dispatch_stub_registry() {
+  static DispatchStubRegistry registry;
+  return registry;
+}
+
+DispatchStubImpl* find_dispatch_stub(
+    const DispatchStubRegistry& registry,
+    const std::string& name) {
+  for (auto stub : registry.stubs) {
+    if (name == stub->get_name_fn()) {
+      return stub;
+    }
+  }
+  return nullptr;
+}
+
+void* get_impl(const DispatchStubImplTable& impls, CPUCapability isa) {
+  return impls[static_cast<size_t>(isa)];
+}
+
+// The ISA level the stub dispatches to, NUM_OPTIONS when it has no
+// implementation for the current ISA level.
+CPUCapability get_dispatched_isa_level(
+    DispatchStubImpl& stub,
+    const DispatchStubImplTable& impls) {
+  auto fptr = stub.cpu_dispatch_ptr.load(std::memory_order_relaxed);
+  if (!fptr) {
+    try {
+      fptr = stub.choose_cpu_impl(
+          get_impl(impls, CPUCapability::DEFAULT)
+#ifdef HAVE_AVX512_FP16_CPU_DEFINITION
+              ,
+          get_impl(impls, CPUCapability::AVX512_FP16)
+#endif
+#ifdef HAVE_AMX_CPU_DEFINITION
+              ,
+          get_impl(impls, CPUCapability::AMX)
+#endif
+#ifdef HAVE_AVX512_BF16_CPU_DEFINITION
+              ,
+          get_impl(impls, CPUCapability::AVX512_BF16)
+#endif
+#ifdef HAVE_AVX512_VNNI_CPU_DEFINITION
+              ,
+          get_impl(impls, CPUCapability::AVX512_VNNI)
+#endif
+#ifdef HAVE_AVX512_CPU_DEFINITION
+              ,
+          get_impl(impls, CPUCapability::AVX512)
+#endif
+#ifdef HAVE_AVX2_VNNI_CPU_DEFINITION
+              ,
+          get_impl(impls, CPUCapability::AVX2_VNNI)
+#endif
+#ifdef HAVE_AVX2_CPU_DEFINITION
+              ,
+          get_impl(impls, CPUCapability::AVX2)
+#endif
+      );
+    } catch (const c10::Error&) {
+      return CPUCapability::NUM_OPTIONS;
+    }
+  }
+  // every ISA level is built from a different translation unit, so the
+  // implementations are distinct
+  for (size_t i = 0; i < impls.size(); i++) {
+    if (impls[i] == fptr) {
+      return static_cast<CPUCapability>(i);
+    }
+  }
+  return CPUCapability::NUM_OPTIONS;
+}
+
+} // anonymous namespace
+
+void DispatchStubImpl::register_stub(
+    const char* (*get_name)(),
+    DispatchStubImplTable (*get_impls)()) {
+  get_name_fn = get_name;
+  get_impls_fn = get_impls;
+  auto& registry = get_dispatch_stub_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.stubs.push_back(this);
+}
+
+std::vector<DispatchStubInfo> get_dispatch_stubs() {
+  auto& registry = get_dispatch_stub_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::vector<DispatchStubInfo> infos;
+  infos.reserve(registry.stubs.size());
+  for (auto stub : registry.stubs) {
+    auto impls = stub->get_impls_fn();
+    DispatchStubInfo info;
+    info.name = stub->get_name_fn();
+    for (size_t i = 0; i < impls.size(); i++) {
+      if (impls[i]) {
+        info.isa_levels.push_back(static_cast<CPUCapability>(i));
+      }
+    }
+    info.overridden =
+        stub->isa_level_override != CPUCapability::NUM_OPTIONS;
+    info.current_isa_level = info.overridden
+        ? stub->isa_level_override
+        : get_dispatched_isa_level(*stub, impls);
+    infos.push_back(std::move(info));
+  }
+  std::sort(
+      infos.begin(),
+      infos.end(),
+      [](const DispatchStubInfo& a, const DispatchStubInfo& b) {
+        return a.name < b.name;
+      });
+  return infos;
+}
+
+void set_dispatch_stub_isa_level(const std::string& name, CPUCapability isa) {
+  TORCH_CHECK(
+      isa >= CPUCapability::DEFAULT && isa < CPUCapability::NUM_OPTIONS,
+      "set_dispatch_stub_isa_level: invalid ISA level");
+  TORCH_CHECK(
+      isa <= _get_highest_cpu_support_isa_level(),
+      "set_dispatch_stub_isa_level: ",
+      CPUCapabilityToString(isa),
+      " is not supported by the CPU");
+  auto& registry = get_dispatch_stub_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto stub = find_dispatch_stub(registry, name);
+  TORCH_CHECK(stub, "set_dispatch_stub_isa_level: unknown stub ", name);
+  auto fptr = get_impl(stub->get_impls_fn(), isa);
+  TORCH_CHECK(
+      fptr,
+      "set_dispatch_stub_isa_level: ",
+      name,
+      " has no ",
+      CPUCapabilityToString(isa),
+      " implementation");
+  stub->isa_level_override = isa;
+  stub->cpu_dispatch_ptr.store(fptr, std::memory_order_relaxed);
+}
+
+void reset_dispatch_stub_isa_level(const std::string& name) {
+  auto& registry = get_dispatch_stub_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto stub = find_dispatch_stub(registry, name);
+  TORCH_CHECK(stub, "reset_dispatch_stub_isa_level: unknown stub ", name);
+  stub->isa_level_override = CPUCapability::NUM_OPTIONS;
+  // chosen again by the next call
+  stub->cpu_dispatch_ptr.store(nullptr, std::memory_order_relaxed);
+}
+
 } // namespace cpu
 } // namespace torch_ipex
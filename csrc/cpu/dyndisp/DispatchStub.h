@@ -3,10 +3,16 @@
 #include <c10/core/Backend.h>
 #include <c10/core/ScalarType.h>
 #include <c10/util/Exception.h>
+#include <c10/util/Type.h>
 
 #include <Macros.h>
+#include <array>
 #include <atomic>
+#include <string>
 #include <type_traits>
+#include <vector>
+
+#include "utils/op_instrumentation.h"
 
 using namespace c10;
 
@@ -37,6 +43,11 @@ using namespace c10;
 // To call:
 //   stub(kCPU, tensor);
 //
+// Every stub registers itself when it is defined, get_dispatch_stubs() lists
+// them with the ISA levels they are built for, and
+// set_dispatch_stub_isa_level() overrides the ISA level of a single stub at
+// runtime.
+//
 // TODO: CPU instruction set selection should be folded into whatever
 // the main dispatch mechanism is.
 
@@ -63,6 +74,9 @@ enum class CPUCapability {
 };
 
 const char* CPUCapabilityToString(CPUCapability isa);
+// Parses the names of ATEN_CPU_CAPABILITY, case insensitive, NUM_OPTIONS for
+// an unknown name.
+CPUCapability CPUCapabilityFromString(const std::string& isa);
 CPUCapability _get_highest_cpu_support_isa_level();
 CPUCapability _get_highest_binary_support_isa_level();
 
@@ -73,6 +87,35 @@ CPUCapability get_cpu_capability();
 template <typename FnPtr, typename T>
 struct DispatchStub;
 
+// The implementations of a stub indexed by CPUCapability, nullptr for the
+// ISA levels not built or not registered.
+using DispatchStubImplTable =
+    std::array<void*, static_cast<size_t>(CPUCapability::NUM_OPTIONS)>;
+
+struct DispatchStubInfo {
+  std::string name;
+  // the ISA levels with an implementation, in increasing order
+  std::vector<CPUCapability> isa_levels;
+  // the ISA level of the implementation the stub dispatches to
+  CPUCapability current_isa_level;
+  // set by set_dispatch_stub_isa_level()
+  bool overridden;
+};
+
+IPEX_API std::vector<DispatchStubInfo> get_dispatch_stubs();
+
+// Makes the stub dispatch to the implementation of the given ISA level
+// instead of the one chosen by get_cpu_capability(), e.g. to compare the ISA
+// variants of a kernel in the same process. The level must have an
+// implementation and be supported by the CPU. The implementation replaces the
+// cached dispatch pointer, so the calls of the stub cost the same as before.
+IPEX_API void set_dispatch_stub_isa_level(
+    const std::string& name,
+    CPUCapability isa);
+
+// Back to the implementation chosen by get_cpu_capability().
+IPEX_API void reset_dispatch_stub_isa_level(const std::string& name);
+
 /**
  * The sole purpose of this class is to outline methods that don't need to be
  * specialized or otherwise inlined and duplicated (by the compiler due to
@@ -150,6 +193,19 @@ struct IPEX_API DispatchStubImpl {
 #endif
   );
 
+  // Adds the stub to the list of get_dispatch_stubs(), the name and the
+  // implementations are read when the list is queried since the
+  // implementations are registered by other translation units.
+  void register_stub(
+      const char* (*get_name)(),
+      DispatchStubImplTable (*get_impls)());
+
+  const char* (*get_name_fn)() = nullptr;
+  DispatchStubImplTable (*get_impls_fn)() = nullptr;
+  // the ISA level set by set_dispatch_stub_isa_level(), NUM_OPTIONS when
+  // the level is chosen by get_cpu_capability()
+  CPUCapability isa_level_override = CPUCapability::NUM_OPTIONS;
+
 // Fixing dispatch error in Windows debug builds.
 // See https://github.com/pytorch/pytorch/issues/22681 for more details.
 #if defined(_MSC_VER) && defined(_DEBUG)
@@ -165,7 +221,9 @@ template <typename rT, typename T, typename... Args>
 struct DispatchStub<rT (*)(Args...), T> {
   using FnPtr = rT (*)(Args...);
 
-  DispatchStub() = default;
+  DispatchStub() {
+    impl.register_stub(&get_stub_name, &get_impls);
+  }
   DispatchStub(const DispatchStub&) = delete;
   DispatchStub& operator=(const DispatchStub&) = delete;
 
@@ -205,10 +263,61 @@ struct DispatchStub<rT (*)(Args...), T> {
             ));
   }
 
+  // the name of the stub struct without the namespace
+  static const char* get_stub_name() {
+    static const std::string name = []() {
+      std::string type_name = c10::demangle_type<T>();
+      auto pos = type_name.rfind("::");
+      return pos == std::string::npos ? type_name : type_name.substr(pos + 2);
+    }();
+    return name.c_str();
+  }
+
+  static void set_impl(
+      DispatchStubImplTable& impls,
+      CPUCapability isa,
+      FnPtr fn) {
+    impls[static_cast<size_t>(isa)] = reinterpret_cast<void*>(fn);
+  }
+
+  static DispatchStubImplTable get_impls() {
+    DispatchStubImplTable impls{};
+    set_impl(impls, CPUCapability::DEFAULT, DEFAULT);
+#ifdef HAVE_AVX512_FP16_CPU_DEFINITION
+    set_impl(impls, CPUCapability::AVX512_FP16, AVX512_FP16);
+#endif
+#ifdef HAVE_AMX_CPU_DEFINITION
+    set_impl(impls, CPUCapability::AMX, AMX);
+#endif
+#ifdef HAVE_AVX512_BF16_CPU_DEFINITION
+    set_impl(impls, CPUCapability::AVX512_BF16, AVX512_BF16);
+#endif
+#ifdef HAVE_AVX512_VNNI_CPU_DEFINITION
+    set_impl(impls, CPUCapability::AVX512_VNNI, AVX512_VNNI);
+#endif
+#ifdef HAVE_AVX512_CPU_DEFINITION
+    set_impl(impls, CPUCapability::AVX512, AVX512);
+#endif
+#ifdef HAVE_AVX2_VNNI_CPU_DEFINITION
+    set_impl(impls, CPUCapability::AVX2_VNNI, AVX2_VNNI);
+#endif
+#ifdef HAVE_AVX2_CPU_DEFINITION
+    set_impl(impls, CPUCapability::AVX2, AVX2);
+#endif
+    return impls;
+  }
+
  public:
   template <typename... ArgTypes>
   rT operator()(DeviceType device_type, ArgTypes&&... args) {
     FnPtr call_ptr = get_call_ptr(device_type);
+    if (C10_UNLIKELY(instrumentation::is_enabled())) {
+      // the stub doesn't know the FLOPs of the kernel, only the bytes of its
+      // tensor arguments are recorded
+      instrumentation::OpScope scope(get_stub_name());
+      scope.add_tensors(args...);
+      return (*call_ptr)(std::forward<ArgTypes>(args)...);
+    }
     return (*call_ptr)(std::forward<ArgTypes>(args)...);
   }
 
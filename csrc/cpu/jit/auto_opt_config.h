@@ -26,6 +26,54 @@ class IPEX_API AutoOptConfig {
     return jit_repack_for_linear_;
   }
 
+  inline void set_conv_primitive_cache_capacity(int64_t capacity) {
+    conv_primitive_cache_capacity_ = capacity;
+  }
+
+  inline int64_t get_conv_primitive_cache_capacity() {
+    return conv_primitive_cache_capacity_;
+  }
+
+  inline void set_conv_input_bucket_size(int64_t bucket_size) {
+    conv_input_bucket_size_ = bucket_size;
+  }
+
+  inline int64_t get_conv_input_bucket_size() {
+    return conv_input_bucket_size_;
+  }
+
+  inline void set_linear_primitive_cache_capacity(int64_t capacity) {
+    linear_primitive_cache_capacity_ = capacity;
+  }
+
+  inline int64_t get_linear_primitive_cache_capacity() {
+    return linear_primitive_cache_capacity_;
+  }
+
+  inline void set_linear_m_bucket_size(int64_t bucket_size) {
+    linear_m_bucket_size_ = bucket_size;
+  }
+
+  inline int64_t get_linear_m_bucket_size() {
+    return linear_m_bucket_size_;
+  }
+
+  inline void set_jit_memory_planning(bool jit_memory_planning) {
+    jit_memory_planning_ = jit_memory_planning;
+  }
+
+  inline bool get_jit_memory_planning() {
+    return jit_memory_planning_;
+  }
+
+  inline void set_jit_sparse_linear_threshold(double threshold) {
+    jit_sparse_linear_threshold_ = threshold;
+  }
+
+  inline double get_jit_sparse_linear_threshold() {
+    return jit_sparse_linear_threshold_;
+  }
+
  private:
   AutoOptConfig()
       : jit_fuse_(true),
@@ -38,6 +86,28 @@ class IPEX_API AutoOptConfig {
         //    will be the best format. (2) Linear + binary cannot be folded if
         //    we do not do repack, since it is implemented on aten:linear
         jit_repack_for_linear_(true),
+        // Number of input shapes each prepacked convolution keeps the
+        // primitives for besides the prepacked one, 0 disables the cache.
+        conv_primitive_cache_capacity_(16),
+        // Pad the spatial dims of the input of prepacked convolution up to a
+        // multiple of the bucket size, so that close resolutions share one
+        // cached primitive. 0 or 1 disables the padding.
+        conv_input_bucket_size_(0),
+        // Number of input shapes each prepacked linear keeps the primitives
+        // for, 0 disables the cache.
+        linear_primitive_cache_capacity_(16),
+        // Pad the rows (M) of the flattened input of prepacked linear up to
+        // a multiple of the bucket size, so that close batch sizes share one
+        // cached primitive. 0 or 1 disables the padding.
+        linear_m_bucket_size_(0),
+        // Preassign the outputs of the prepacked linear and convolution of
+        // the optimized graph in one arena planned for the profiled shapes.
+        // Off by default since each thread running the graph keeps its arena.
+        jit_memory_planning_(false),
+        // Convert the frozen linears whose weight has at least this fraction
+        // of zero blocks, or is 2:4 sparse, to the sparse prepacked linear.
+        // 0 disables the conversion.
+        jit_sparse_linear_threshold_(0),
         calibration_step_(false),
         qscheme_(at::QScheme::PER_TENSOR_AFFINE) {}
 
@@ -47,6 +117,12 @@ class IPEX_API AutoOptConfig {
 
   bool jit_fuse_;
   bool jit_repack_for_linear_;
+  int64_t conv_primitive_cache_capacity_;
+  int64_t conv_input_bucket_size_;
+  int64_t linear_primitive_cache_capacity_;
+  int64_t linear_m_bucket_size_;
+  bool jit_memory_planning_;
+  double jit_sparse_linear_threshold_;
   // the flag for one iteration of calibration step whether end or not.
   bool calibration_step_;
   at::QScheme qscheme_;
@@ -0,0 +1,76 @@
+#include "compiled_partition_cache.h"
+#include "kernel.h"
+
+namespace torch_ipex {
+namespace jit {
+namespace fuser {
+namespace onednn {
+
+CompiledPartitionCache& CompiledPartitionCache::getInstance() {
+  static CompiledPartitionCache cache;
+  return cache;
+}
+
+std::shared_ptr<const CompiledPartitionCache::Entry> CompiledPartitionCache::
+    find(const Key& key) {
+  UniqueReadLock<ReadWriteMutex> lock(rwmutex_);
+  auto iter = map_.find(key);
+  if (iter == map_.end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return iter->second;
+}
+
+std::shared_ptr<const CompiledPartitionCache::Entry> CompiledPartitionCache::
+    insert(const Key& key, std::shared_ptr<const Entry> entry) {
+  UniqueWriteLock<ReadWriteMutex> lock(rwmutex_);
+  auto iter = map_.find(key);
+  if (iter != map_.end()) {
+    // compiled concurrently by another thread, keep the first one
+    return iter->second;
+  }
+  if (capacity_ == 0) {
+    // the cache is disabled by a capacity of 0
+    return entry;
+  }
+  evictIfFull(1);
+  map_.emplace(key, entry);
+  insertionOrder_.push_back(key);
+  return entry;
+}
+
+void CompiledPartitionCache::evictIfFull(size_t numNewEntries) {
+  while (!insertionOrder_.empty() &&
+         map_.size() + numNewEntries > capacity_) {
+    map_.erase(insertionOrder_.front());
+    insertionOrder_.pop_front();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void CompiledPartitionCache::clear() {
+  UniqueWriteLock<ReadWriteMutex> lock(rwmutex_);
+  map_.clear();
+  insertionOrder_.clear();
+  hits_ = 0;
+  misses_ = 0;
+  evictions_ = 0;
+}
+
+CompiledPartitionCache::Stats CompiledPartitionCache::getStats() {
+  UniqueReadLock<ReadWriteMutex> lock(rwmutex_);
+  return {hits_, misses_, evictions_, map_.size(), capacity_};
+}
+
+void CompiledPartitionCache::setCapacity(size_t capacity) {
+  UniqueWriteLock<ReadWriteMutex> lock(rwmutex_);
+  capacity_ = capacity;
+  evictIfFull(0);
+}
+
+} // namespace onednn
+} // namespace fuser
+} // namespace jit
+} // namespace torch_ipex
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "codegen/LlgaTensorImpl.h"
+#include "utils/rw_lock.h"
+
+#include <oneapi/dnnl/dnnl_graph.hpp>
+
+namespace std {
+template <>
+struct hash<std::vector<int64_t>> {
+  // hash_combine with a 64-bit finalizer per element, so that keys differing
+  // only in the order or position of their dims do not collide
+  size_t operator()(const std::vector<int64_t>& key) const {
+    uint64_t seed = key.size();
+    for (auto v : key) {
+      uint64_t x = static_cast<uint64_t>(v);
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccdULL;
+      x ^= x >> 33;
+      seed ^= x + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+    return static_cast<size_t>(seed);
+  }
+};
+
+} // namespace std
+
+namespace torch_ipex {
+namespace jit {
+namespace fuser {
+namespace onednn {
+
+// Process-wide cache of compiled LLGA partitions shared by all threads, so
+// that every thread (or TaskExecutor stream) running the same partition with
+// the same input shapes and thread count compiles it only once.
+//
+// The per-thread LRU cache in LlgaKernel stays in front of it, because the
+// run arguments (data handles of input/output tensors) it holds are mutated
+// on every run and cannot be shared. Entries here are immutable once
+// inserted, so lookups only take the read lock.
+class CompiledPartitionCache {
+ public:
+  using Key = std::vector<int64_t>;
+
+  struct Entry {
+    dnnl::graph::compiled_partition cp_;
+    std::vector<LlgaTensorDesc> outputSpecs_;
+    std::vector<short> inplacePairOffsets_;
+  };
+
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t size;
+    size_t capacity;
+  };
+
+  static CompiledPartitionCache& getInstance();
+
+  // Returns nullptr on miss.
+  std::shared_ptr<const Entry> find(const Key& key);
+
+  // Insert the entry unless another thread has inserted the same key in the
+  // meantime, and return the entry that is stored in the cache.
+  std::shared_ptr<const Entry> insert(
+      const Key& key,
+      std::shared_ptr<const Entry> entry);
+
+  void clear();
+
+  Stats getStats();
+
+  // A capacity of 0 disables the cache and drops all the entries.
+  void setCapacity(size_t capacity);
+
+  bool isEnabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  void setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+ private:
+  CompiledPartitionCache() = default;
+  CompiledPartitionCache(const CompiledPartitionCache&) = delete;
+  void operator=(const CompiledPartitionCache&) = delete;
+
+  // Evict the oldest entries until numNewEntries more fit in the capacity.
+  void evictIfFull(size_t numNewEntries);
+
+  ReadWriteMutex rwmutex_;
+  std::unordered_map<Key, std::shared_ptr<const Entry>> map_;
+  // entries are evicted in insertion order: reordering on hit would need the
+  // write lock on the hot path
+  std::deque<Key> insertionOrder_;
+  size_t capacity_ = 7500;
+  std::atomic<bool> enabled_{true};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+
+} // namespace onednn
+} // namespace fuser
+} // namespace jit
+} // namespace torch_ipex
@@ -4,6 +4,8 @@
 #include "fusion_group_name.h"
 #include "graph_fuser.h"
 #include "guard_shape.h"
+#include "compiled_partition_cache.h"
+#include "persistent_cache.h"
 #include "kernel.h"
 #include "layout_propagation.h"
 #include "lift_up_quant.h"
@@ -105,6 +107,41 @@ bool getLlgaWeightCacheEnabled() {
   return dnnl::graph::get_constant_tensor_cache();
 }
 
+void setLlgaSharedPartitionCacheEnabled(bool enabled) {
+  CompiledPartitionCache::getInstance().setEnabled(enabled);
+}
+
+bool getLlgaSharedPartitionCacheEnabled() {
+  return CompiledPartitionCache::getInstance().isEnabled();
+}
+
+void setLlgaSharedPartitionCacheCapacity(int64_t capacity) {
+  TORCH_CHECK(capacity >= 0, "cache capacity should be non-negative");
+  CompiledPartitionCache::getInstance().setCapacity(capacity);
+}
+
+void clearLlgaSharedPartitionCache() {
+  CompiledPartitionCache::getInstance().clear();
+}
+
+std::unordered_map<std::string, int64_t> getLlgaSharedPartitionCacheStats() {
+  auto stats = CompiledPartitionCache::getInstance().getStats();
+  return {
+      {"hits", static_cast<int64_t>(stats.hits)},
+      {"misses", static_cast<int64_t>(stats.misses)},
+      {"evictions", static_cast<int64_t>(stats.evictions)},
+      {"size", static_cast<int64_t>(stats.size)},
+      {"capacity", static_cast<int64_t>(stats.capacity)}};
+}
+
+void setLlgaPersistentCacheDir(const std::string& dir) {
+  PersistentPartitionCache::getInstance().setDirectory(dir);
+}
+
+std::string getLlgaPersistentCacheDir() {
+  return PersistentPartitionCache::getInstance().getDirectory();
+}
+
 } // namespace onednn
 } // namespace fuser
 
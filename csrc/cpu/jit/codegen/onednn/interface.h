@@ -4,6 +4,9 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/passes/pass_manager.h>
 
+#include <string>
+#include <unordered_map>
+
 namespace torch_ipex {
 namespace jit {
 namespace fuser {
@@ -25,6 +28,24 @@ IPEX_API void setLlgaWeightCacheEnabled(bool enabled);
 
 IPEX_API bool getLlgaWeightCacheEnabled();
 
+IPEX_API void setLlgaSharedPartitionCacheEnabled(bool enabled);
+
+IPEX_API bool getLlgaSharedPartitionCacheEnabled();
+
+IPEX_API void setLlgaSharedPartitionCacheCapacity(int64_t capacity);
+
+IPEX_API void clearLlgaSharedPartitionCache();
+
+// hits, misses, evictions, size and capacity of the process-wide compiled
+// partition cache
+IPEX_API std::unordered_map<std::string, int64_t>
+getLlgaSharedPartitionCacheStats();
+
+// Directory of the on-disk partition cache, an empty string disables it
+IPEX_API void setLlgaPersistentCacheDir(const std::string& dir);
+
+IPEX_API std::string getLlgaPersistentCacheDir();
+
 } // namespace onednn
 } // namespace fuser
 
@@ -4,6 +4,7 @@
 #include "kernel.h"
 #include "operator.h"
 #include "runtime.h"
+#include "utils/op_instrumentation.h"
 
 #include <ATen/core/functional.h>
 #include <ATen/quantized/Quantizer.h>
@@ -25,6 +26,15 @@ thread_local std::
     unordered_map<std::vector<int64_t>, LlgaKernel::list_iterator_t>
         LlgaKernel::cache_items_map_;
 thread_local int LlgaKernel::capacity_ = 7500;
+thread_local uint64_t LlgaKernel::cache_generation_ = 0;
+
+// Unique for each thread of the process, unlike std::thread::id which may be
+// reused by a new thread, so that a slot of a finished thread is never read.
+static uint64_t getThreadToken() {
+  static std::atomic<uint64_t> nextToken{1};
+  thread_local uint64_t token = nextToken.fetch_add(1);
+  return token;
+}
 
 LlgaKernel::LlgaKernel(const Node* fusionNode)
     : fusionNode_(fusionNode),
@@ -47,6 +57,87 @@ LlgaKernel::LlgaKernel(const Node* fusionNode)
   partition_ = partitions[0];
   nPartitionInputs_ = partition_.get_input_ports().size();
   GRAPH_DEBUG("Initialized ", debugName(), "\n", graph_->toString());
+  if (PersistentPartitionCache::getInstance().isEnabled() &&
+      CompiledPartitionCache::getInstance().isEnabled()) {
+    precompilePersistedPartitions();
+  }
+}
+
+std::vector<int64_t> LlgaKernel::cacheKeyPrefix() const {
+  // fusionNode_ may be reassigned to another LlgaFusionGroup after ~LlgaKernel
+  // would be called, and another LlgaFusionGroup may be created for another
+  // graph. But since JIT graphs have had a memory leak issue for years now,
+  // torch::jit::Graph::~Graph is not called after a model is traced.
+  // So we would use 2 pieces of info that make a partition unique.
+  return {
+      omp_get_max_threads(),
+      (int64_t)(uintptr_t)((void*)fusionNode_),
+      (int64_t)(uintptr_t)((void*)graph_.get())};
+}
+
+bool LlgaKernel::keyMatches(
+    const std::vector<int64_t>& key,
+    const TensorArgs& inputs) const {
+  if (key.size() < 3 || key[0] != omp_get_max_threads() ||
+      key[1] != (int64_t)(uintptr_t)((void*)fusionNode_) ||
+      key[2] != (int64_t)(uintptr_t)((void*)graph_.get())) {
+    return false;
+  }
+  size_t pos = 3;
+  for (auto& in : inputs) {
+    auto shape = in.sizes();
+    if (pos + 1 + shape.size() > key.size() || key[pos] != (int64_t)shape.size() ||
+        !std::equal(shape.begin(), shape.end(), key.begin() + pos + 1)) {
+      return false;
+    }
+    pos += 1 + shape.size();
+  }
+  return pos == key.size();
+}
+
+const std::string& LlgaKernel::persistentId() {
+  std::call_once(persistentIdInitialized_, [&]() {
+    persistentId_ =
+        PersistentPartitionCache::getInstance().partitionId(graph_->toString());
+  });
+  return persistentId_;
+}
+
+void LlgaKernel::precompilePersistedPartitions() {
+  RECORD_FUNCTION(
+      "LLGA_bridge::precompileKernels", c10::ArrayRef<c10::IValue>({}));
+  auto compilations =
+      PersistentPartitionCache::getInstance().load(persistentId());
+  auto& sharedCache = CompiledPartitionCache::getInstance();
+  for (auto& compilation : compilations) {
+    // kernels are compiled for a given number of threads
+    if (compilation.numThreads != omp_get_max_threads() ||
+        compilation.inputShapes.size() != nGraphInputs_ ||
+        compilation.inputSpecs.size() != nPartitionInputs_) {
+      continue;
+    }
+    auto key = cacheKeyPrefix();
+    for (auto& shape : compilation.inputShapes) {
+      appendShapeToKey(key, shape);
+    }
+    if (sharedCache.find(key)) {
+      continue;
+    }
+    try {
+      auto compilationOutput = compile(
+          partition_,
+          compilation.inputSpecs,
+          compilation.convertDimsToUnknown);
+      auto compiled = std::make_shared<CompiledPartitionCache::Entry>();
+      compiled->cp_ = std::move(compilationOutput.first);
+      compiled->outputSpecs_ = std::move(compilationOutput.second);
+      compiled->inplacePairOffsets_ = inplacePairOffsets_;
+      sharedCache.insert(key, compiled);
+    } catch (std::exception& e) {
+      // a stale record only costs a compilation on the first run
+      GRAPH_DEBUG("Failed to precompile ", debugName(), ": ", e.what());
+    }
+  }
 }
 
 bool LlgaKernel::useOpaqueLayout(size_t offset) const {
@@ -153,22 +244,20 @@ ArgSpecs LlgaKernel::initializeInputSpecs(const TensorArgs& inputs) {
   return inputSpecs;
 }
 
-ArgSpecs LlgaKernel::initializeOutputSpecs(
-    const TensorArgs& inputs,
-    bool convertDimsToUnknown = false) {
-  ArgSpecs outputSpecs;
-  outputSpecs.reserve(nOutputs_);
-
-  if (convertDimsToUnknown == false) {
-    auto numInputs = inputs.size();
-    for (auto i = 0; i < numInputs; i++) {
-      if (!((inputs[i].sizes().vec() == tracedInputShapes_[i]) &&
-            (inputs[i].strides().vec() == tracedInputStrides_[i]))) {
-        convertDimsToUnknown = true;
-        break;
-      }
+bool LlgaKernel::matchesTracedInputs(const TensorArgs& inputs) const {
+  auto numInputs = inputs.size();
+  for (auto i = 0; i < numInputs; i++) {
+    if (!((inputs[i].sizes().vec() == tracedInputShapes_[i]) &&
+          (inputs[i].strides().vec() == tracedInputStrides_[i]))) {
+      return false;
     }
   }
+  return true;
+}
+
+ArgSpecs LlgaKernel::initializeOutputSpecs(bool convertDimsToUnknown) {
+  ArgSpecs outputSpecs;
+  outputSpecs.reserve(nOutputs_);
 
   for (size_t i = 0; i < nOutputs_; i++) {
     auto spec = ArgSpec(graph_->outputs()[i]);
@@ -381,11 +470,11 @@ void LlgaKernel::prepareRunArgs(
 
 std::pair<compiled_partition, ArgSpecs> LlgaKernel::compile(
     const partition& partition,
-    const TensorArgs& inputs,
-    ArgSpecs& inputSpecs) {
+    ArgSpecs& inputSpecs,
+    bool convertDimsToUnknown) {
   RECORD_FUNCTION("LLGA_bridge::compileKernel", c10::ArrayRef<c10::IValue>({}));
   auto inputLogicalTensors = fmap(inputSpecs, toLogicalTensor);
-  auto outputSpecs = initializeOutputSpecs(inputs);
+  auto outputSpecs = initializeOutputSpecs(convertDimsToUnknown);
   auto outputLogicalTensors = fmap(outputSpecs, toLogicalTensor);
   compiled_partition compilation;
   try {
@@ -406,7 +495,7 @@ std::pair<compiled_partition, ArgSpecs> LlgaKernel::compile(
     if (concreteOutputStrides) {
       // recompute outputSpecs and output logical tensors
       // with INT64_MIN sizes & strides
-      outputSpecs = initializeOutputSpecs(inputs, true);
+      outputSpecs = initializeOutputSpecs(true);
       outputLogicalTensors = fmap(outputSpecs, toLogicalTensor);
       compilation = partition.compile(
           inputLogicalTensors, outputLogicalTensors, Engine::getEngine());
@@ -451,6 +540,18 @@ std::pair<compiled_partition, ArgSpecs> LlgaKernel::compile(
   return std::make_pair(compilation, outputSpecs);
 }
 
+LlgaKernel::inline_cache_slot* LlgaKernel::getInlineCacheSlot() {
+  uint64_t token = getThreadToken();
+  for (auto& slot : inlineCache_) {
+    uint64_t owner = slot.owner_.load(std::memory_order_acquire);
+    if (owner == token ||
+        (owner == 0 && slot.owner_.compare_exchange_strong(owner, token))) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
 LlgaKernel::cp_entry& LlgaKernel::compileAndCache(
     Stack& stack,
     TensorArgs& outputs) {
@@ -462,29 +563,72 @@ LlgaKernel::cp_entry& LlgaKernel::compileAndCache(
         v.isTensor(), "Stack values for LLGA partition must be Tensor type");
     return v.toTensor();
   });
-  std::vector<int64_t> key;
-  key.reserve(1024);
-  key.push_back(omp_get_max_threads());
-  // fusionNode_ may be reassigned to another LlgaFusionGroup after ~LlgaKernel
-  // would be called, and another LlgaFusionGroup may be created for another
-  // graph. But since JIT graphs have had a memory leak issue for years now,
-  // torch::jit::Graph::~Graph is not called after a model is traced.
-  // So we would use 2 pieces of info that make a partition unique.
-  key.push_back((uintptr_t)((void*)fusionNode_));
-  key.push_back((uintptr_t)((void*)graph_.get()));
+  auto inlineSlot = getInlineCacheSlot();
+  if (inlineSlot && inlineSlot->valid_ &&
+      inlineSlot->generation_ == cache_generation_ &&
+      keyMatches(inlineSlot->entry_->first, inputs)) {
+#ifdef GRAPH_DEBUG_ENABLED
+    GRAPH_DEBUG("Inline cached compiled partition is available");
+#endif
+    auto entry = inlineSlot->entry_;
+    cache_items_list_.splice(
+        cache_items_list_.begin(), cache_items_list_, entry);
+    prepareRunArgs(
+        entry->second.inputLLGATensors_,
+        entry->second.outputLLGATensors_,
+        inputs,
+        outputs,
+        entry->second.outputSpecs_);
+    return entry->second;
+  }
+
+  std::vector<int64_t> key = cacheKeyPrefix();
+  size_t keySize = key.size();
+  for (auto& in : inputs) {
+    keySize += 1 + in.dim();
+  }
+  key.reserve(keySize);
   for (auto& in : inputs) {
-    auto shape_vec = in.sizes().vec();
-    key.insert(key.end(), shape_vec.begin(), shape_vec.end());
+    appendShapeToKey(key, in.sizes());
   }
   auto iter = cache_items_map_.find(key);
   if (iter == cache_items_map_.end()) {
-    GRAPH_DEBUG("Compiling partition");
     cp_entry compiledPartitionEntry;
-    auto input_shape = inputs[0].sizes().vec();
     auto inputSpecs = initializeInputSpecs(inputs);
-    auto compilationOutput = compile(partition_, inputs, inputSpecs);
-    compiledPartitionEntry.outputSpecs_ = std::move(compilationOutput.second);
-    compiledPartitionEntry.cp_ = std::move(compilationOutput.first);
+    auto& sharedCache = CompiledPartitionCache::getInstance();
+    std::shared_ptr<const CompiledPartitionCache::Entry> shared =
+        sharedCache.isEnabled() ? sharedCache.find(key) : nullptr;
+    if (!shared) {
+      GRAPH_DEBUG("Compiling partition");
+      bool convertDimsToUnknown = !matchesTracedInputs(inputs);
+      auto compilationOutput =
+          compile(partition_, inputSpecs, convertDimsToUnknown);
+      auto compiled = std::make_shared<CompiledPartitionCache::Entry>();
+      compiled->cp_ = std::move(compilationOutput.first);
+      compiled->outputSpecs_ = std::move(compilationOutput.second);
+      compiled->inplacePairOffsets_ = inplacePairOffsets_;
+      shared = sharedCache.isEnabled() ? sharedCache.insert(key, compiled)
+                                       : compiled;
+      auto& persistentCache = PersistentPartitionCache::getInstance();
+      if (persistentCache.isEnabled()) {
+        PersistedCompilation record;
+        record.numThreads = key[0];
+        record.convertDimsToUnknown = convertDimsToUnknown;
+        record.inputShapes = fmap(inputs, [](const at::Tensor& t) {
+          return t.sizes().vec();
+        });
+        record.inputSpecs = inputSpecs;
+        persistentCache.store(persistentId(), record);
+      }
+    } else {
+#ifdef GRAPH_DEBUG_ENABLED
+      GRAPH_DEBUG("Compiled partition is shared by another thread");
+#endif
+    }
+    // compiled_partition is a handle, copying it shares the compiled kernel
+    compiledPartitionEntry.cp_ = shared->cp_;
+    compiledPartitionEntry.outputSpecs_ = shared->outputSpecs_;
+    inplacePairOffsets_ = shared->inplacePairOffsets_;
     prepareAndCacheRunArgs(
         compiledPartitionEntry.inputLLGATensors_,
         compiledPartitionEntry.outputLLGATensors_,
@@ -500,16 +644,26 @@ LlgaKernel::cp_entry& LlgaKernel::compileAndCache(
       last--;
       cache_items_map_.erase(last->first);
       cache_items_list_.pop_back();
+      // the evicted entry may be referenced by inline caches
+      cache_generation_++;
     }
-    // If hash computation cost is higher than copying this struct,
-    // then remove std::move above & return compiledPartitionEntry instead
-    return cache_items_map_[key]->second;
+    if (inlineSlot) {
+      inlineSlot->entry_ = cache_items_list_.begin();
+      inlineSlot->generation_ = cache_generation_;
+      inlineSlot->valid_ = true;
+    }
+    return cache_items_list_.begin()->second;
   } else {
 #ifdef GRAPH_DEBUG_ENABLED
     GRAPH_DEBUG("Cached compiled partition is available");
 #endif
     cache_items_list_.splice(
         cache_items_list_.begin(), cache_items_list_, iter->second);
+    if (inlineSlot) {
+      inlineSlot->entry_ = iter->second;
+      inlineSlot->generation_ = cache_generation_;
+      inlineSlot->valid_ = true;
+    }
     prepareRunArgs(
         iter->second->second.inputLLGATensors_,
         iter->second->second.outputLLGATensors_,
@@ -522,6 +676,15 @@ LlgaKernel::cp_entry& LlgaKernel::compileAndCache(
 
 void LlgaKernel::run(Stack& stack) {
   GRAPH_DEBUG("In ", debugName(), "\n");
+  // includes the compilation of the partition at the first run of a shape
+  instrumentation::OpScope scope(profileName().c_str());
+  if (scope.active()) {
+    for (const auto& input : last(stack, nGraphInputs_)) {
+      if (input.isTensor()) {
+        scope.add_tensor(input.toTensor());
+      }
+    }
+  }
   TensorArgs outputs;
   outputs.reserve(nOutputs_);
 
@@ -530,14 +693,24 @@ void LlgaKernel::run(Stack& stack) {
 #ifdef GRAPH_DEBUG_ENABLED
   GRAPH_DEBUG("Executing partition");
 #endif
-  compiledPartitionEntry.cp_.execute(
-      Stream::getStream(),
-      compiledPartitionEntry.inputLLGATensors_,
-      compiledPartitionEntry.outputLLGATensors_);
+  {
+    // separates the oneDNN kernel from the bridge overhead, which is the
+    // rest of the LlgaFusionGroup time in the profile
+    RECORD_FUNCTION("LLGA_bridge::execute", c10::ArrayRef<c10::IValue>({}));
+    compiledPartitionEntry.cp_.execute(
+        Stream::getStream(),
+        compiledPartitionEntry.inputLLGATensors_,
+        compiledPartitionEntry.outputLLGATensors_);
+  }
 
 #ifdef GRAPH_DEBUG_ENABLED
   GRAPH_DEBUG("Partition executed");
 #endif
+  if (scope.active()) {
+    for (const auto& output : outputs) {
+      scope.add_bytes(output.nbytes());
+    }
+  }
   // Update the stack.
   drop(stack, nGraphInputs_);
   for (auto& o : outputs) {
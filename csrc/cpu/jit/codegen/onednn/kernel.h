@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <unordered_map>
 #include <vector>
 #include "codegen/LlgaTensorImpl.h"
+#include "compiled_partition_cache.h"
 #include "graph_helper.h"
+#include "persistent_cache.h"
 #include "utils/rw_lock.h"
 
 #include <oneapi/dnnl/dnnl_graph.hpp>
@@ -11,34 +15,6 @@
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
 
-namespace std {
-template <>
-struct hash<std::vector<int64_t>> {
-  size_t operator()(const std::vector<int64_t>& key) const {
-    size_t total = key.size();
-    size_t sum = 0;
-    if (total < 64) {
-      for (size_t i = 0; i < total; i++) {
-        sum += key[i] << i;
-      }
-    } else {
-      size_t batch = total / 64;
-      size_t remain = total % 64;
-      for (size_t bs = 0; bs < batch; bs++) {
-        for (size_t i = 0; i < 64; i++) {
-          sum += key[bs * 64 + i] << i;
-        }
-      }
-      for (size_t i = 0; i < remain; i++) {
-        sum += key[batch * 64 + i] << i;
-      }
-    }
-    return sum;
-  }
-};
-
-} // namespace std
-
 namespace torch_ipex {
 namespace jit {
 namespace fuser {
@@ -100,17 +76,47 @@ class LlgaKernel {
 
   ArgSpecs initializeInputSpecs(const TensorArgs& inputs);
 
-  ArgSpecs initializeOutputSpecs(
-      const TensorArgs& inputs,
-      bool convertDimsToUnknown);
+  // Output shapes are only known for the input shapes the graph was traced
+  // with, so outputs of other shapes get unknown dims.
+  bool matchesTracedInputs(const TensorArgs& inputs) const;
+
+  ArgSpecs initializeOutputSpecs(bool convertDimsToUnknown);
 
   std::pair<dnnl::graph::compiled_partition, ArgSpecs> compile(
       const dnnl::graph::partition& partition,
-      const TensorArgs& inputs,
-      ArgSpecs& inputSpecs);
+      ArgSpecs& inputSpecs,
+      bool convertDimsToUnknown);
+
+  // Leading part of the compiled partition cache key, followed by the rank
+  // and the shape of each graph input.
+  std::vector<int64_t> cacheKeyPrefix() const;
+
+  static void appendShapeToKey(
+      std::vector<int64_t>& key,
+      c10::IntArrayRef shape) {
+    key.push_back(shape.size());
+    key.insert(key.end(), shape.begin(), shape.end());
+  }
+
+  // Compares a cache key with the one the inputs would produce, without
+  // building it.
+  bool keyMatches(const std::vector<int64_t>& key, const TensorArgs& inputs)
+      const;
+
+  const std::string& persistentId();
+
+  // Compiles the partitions recorded by previous processes into the
+  // process-wide CompiledPartitionCache.
+  void precompilePersistedPartitions();
 
   cp_entry& compileAndCache(torch::jit::Stack& stack, TensorArgs& outputs);
 
+  struct inline_cache_slot;
+
+  // The inline cache slot of the calling thread, nullptr if all the slots
+  // belong to other threads.
+  inline_cache_slot* getInlineCacheSlot();
+
   void prepareRunArgs(
       RunArgs& inputLlgaTensors,
       RunArgs& outputLlgaTensors,
@@ -169,13 +175,30 @@ class LlgaKernel {
   // function. Adopted from
   // https://github.com/lamerman/cpp-lru-cache/blob/master/include/lrucache.hpp
   // LRU cache is per-thread, so as to enable weight sharing among groups of
-  // threads.
+  // threads. It holds the per-thread run arguments, the compiled partitions
+  // themselves come from the process-wide CompiledPartitionCache.
   using key_value_pair_t = std::pair<std::vector<int64_t>, cp_entry>;
   using list_iterator_t = std::list<key_value_pair_t>::iterator;
   static thread_local std::list<key_value_pair_t> cache_items_list_;
   static thread_local std::unordered_map<std::vector<int64_t>, list_iterator_t>
       cache_items_map_;
   static thread_local int capacity_;
+  // Monomorphic inline cache: the LRU entry used by the last run of the
+  // kernel, for each of the first kInlineCacheSlots threads running it. Most
+  // kernels see the same shapes run after run, so the key needs neither be
+  // built nor hashed. A slot is claimed once by a thread and only used by it,
+  // and its entry is only valid for the eviction generation it was recorded
+  // in. The slots go away with the kernel.
+  static constexpr int kInlineCacheSlots = 4;
+  struct inline_cache_slot {
+    // token of the owning thread, never reused, 0 for a free slot
+    std::atomic<uint64_t> owner_{0};
+    list_iterator_t entry_;
+    uint64_t generation_ = 0;
+    bool valid_ = false;
+  };
+  std::array<inline_cache_slot, kInlineCacheSlots> inlineCache_;
+  static thread_local uint64_t cache_generation_;
   std::vector<std::vector<int64_t>> tracedInputShapes_;
   std::vector<std::vector<int64_t>> tracedInputStrides_;
   std::string debugName_;
@@ -184,6 +207,8 @@ class LlgaKernel {
   std::once_flag constantSpecInitializedFlag_;
   std::once_flag tracedInputShapesInitialized_;
   std::vector<short> inplacePairOffsets_;
+  std::once_flag persistentIdInitialized_;
+  std::string persistentId_;
 };
 
 } // namespace onednn
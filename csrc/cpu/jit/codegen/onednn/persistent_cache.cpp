@@ -0,0 +1,204 @@
+#include "persistent_cache.h"
+
+#include <dyndisp/DispatchStub.h>
+#include <oneapi/dnnl/dnnl.h>
+#include <torch/csrc/jit/jit_log.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace torch_ipex {
+namespace jit {
+namespace fuser {
+namespace onednn {
+
+using desc = dnnl::graph::logical_tensor;
+
+namespace {
+
+const char* kFormatVersion = "ipex_llga_cache_v1";
+
+std::string environmentId() {
+  const dnnl_version_t* v = dnnl_version();
+  std::stringstream ss;
+  ss << "isa=" << cpu::CPUCapabilityToString(cpu::get_cpu_capability())
+     << " onednn=" << v->major << "." << v->minor << "." << v->patch << "."
+     << v->hash;
+  return ss.str();
+}
+
+// Only strided logical tensors with known dims can be rebuilt without the
+// tensors they were derived from.
+bool serializeSpec(const LlgaTensorDesc& spec, std::ostream& os) {
+  desc lt = spec.logical_tensor();
+  if (lt.get_layout_type() != desc::layout_type::strided ||
+      lt.get_ndims() < 0) {
+    return false;
+  }
+  auto dims = lt.get_dims();
+  auto strides = lt.get_strides();
+  os << " " << lt.get_id() << " " << static_cast<int>(lt.get_data_type())
+     << " " << static_cast<int>(lt.get_property_type()) << " "
+     << dims.size();
+  for (auto d : dims) {
+    os << " " << d;
+  }
+  for (auto s : strides) {
+    os << " " << s;
+  }
+  return true;
+}
+
+bool deserializeSpec(std::istream& is, std::vector<LlgaTensorDesc>& specs) {
+  size_t tid;
+  int dtype, property;
+  size_t ndims;
+  if (!(is >> tid >> dtype >> property >> ndims)) {
+    return false;
+  }
+  std::vector<int64_t> dims(ndims), strides(ndims);
+  for (auto& d : dims) {
+    is >> d;
+  }
+  for (auto& s : strides) {
+    is >> s;
+  }
+  specs.emplace_back(
+      tid,
+      dims,
+      strides,
+      static_cast<desc::data_type>(dtype),
+      static_cast<desc::property_type>(property),
+      /* is_scalar_tensor = */ ndims == 0);
+  return !is.fail();
+}
+
+} // namespace
+
+PersistentPartitionCache::PersistentPartitionCache() {
+  auto envar = std::getenv("IPEX_LLGA_CACHE_DIR");
+  if (envar) {
+    dir_ = envar;
+  }
+}
+
+PersistentPartitionCache& PersistentPartitionCache::getInstance() {
+  static PersistentPartitionCache cache;
+  return cache;
+}
+
+void PersistentPartitionCache::setDirectory(const std::string& dir) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  dir_ = dir;
+}
+
+std::string PersistentPartitionCache::getDirectory() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dir_;
+}
+
+bool PersistentPartitionCache::isEnabled() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !dir_.empty();
+}
+
+std::string PersistentPartitionCache::partitionId(
+    const std::string& subgraph) const {
+  std::stringstream ss;
+  ss << std::hex << std::hash<std::string>{}(subgraph + environmentId());
+  return ss.str();
+}
+
+std::string PersistentPartitionCache::filePath(
+    const std::string& partitionId) const {
+  return dir_ + "/llga_" + partitionId + ".cache";
+}
+
+std::vector<PersistedCompilation> PersistentPartitionCache::load(
+    const std::string& partitionId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<PersistedCompilation> compilations;
+  std::ifstream file(filePath(partitionId));
+  std::string line;
+  if (!file.is_open() || !std::getline(file, line) ||
+      line != std::string(kFormatVersion) + " " + environmentId()) {
+    return compilations;
+  }
+  // several processes may have recorded the same compilation
+  std::set<std::string> seen;
+  while (std::getline(file, line)) {
+    if (!seen.insert(line).second) {
+      continue;
+    }
+    std::istringstream is(line);
+    PersistedCompilation c;
+    size_t nInputs, nSpecs;
+    if (!(is >> c.numThreads >> c.convertDimsToUnknown >> nInputs)) {
+      continue;
+    }
+    c.inputShapes.resize(nInputs);
+    for (auto& shape : c.inputShapes) {
+      size_t ndims;
+      is >> ndims;
+      shape.resize(ndims);
+      for (auto& d : shape) {
+        is >> d;
+      }
+    }
+    bool valid = static_cast<bool>(is >> nSpecs);
+    for (size_t i = 0; valid && i < nSpecs; i++) {
+      valid = deserializeSpec(is, c.inputSpecs);
+    }
+    if (valid) {
+      compilations.emplace_back(std::move(c));
+    } else {
+      GRAPH_DEBUG("Skipping corrupted LLGA cache record: ", line);
+    }
+  }
+  return compilations;
+}
+
+void PersistentPartitionCache::store(
+    const std::string& partitionId,
+    const PersistedCompilation& compilation) {
+  std::stringstream ss;
+  ss << compilation.numThreads << " " << compilation.convertDimsToUnknown
+     << " " << compilation.inputShapes.size();
+  for (auto& shape : compilation.inputShapes) {
+    ss << " " << shape.size();
+    for (auto d : shape) {
+      ss << " " << d;
+    }
+  }
+  ss << " " << compilation.inputSpecs.size();
+  for (auto& spec : compilation.inputSpecs) {
+    if (!serializeSpec(spec, ss)) {
+      return;
+    }
+  }
+  ss << "\n";
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (dir_.empty()) {
+    return;
+  }
+  auto path = filePath(partitionId);
+  bool isNew = !std::ifstream(path).good();
+  std::ofstream file(path, std::ios::app);
+  if (!file.is_open()) {
+    TORCH_WARN_ONCE("Cannot write LLGA partition cache to ", dir_);
+    return;
+  }
+  if (isNew) {
+    file << kFormatVersion << " " << environmentId() << "\n";
+  }
+  // one write per record, so concurrent writers append whole lines
+  file << ss.str();
+}
+
+} // namespace onednn
+} // namespace fuser
+} // namespace jit
+} // namespace torch_ipex
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include "codegen/LlgaTensorImpl.h"
+
+namespace torch_ipex {
+namespace jit {
+namespace fuser {
+namespace onednn {
+
+// Everything needed to compile a partition again without seeing its inputs:
+// the logical tensors it was compiled with, plus the graph input shapes and
+// thread count that make up its key in the compiled partition cache.
+struct PersistedCompilation {
+  int64_t numThreads;
+  bool convertDimsToUnknown;
+  std::vector<std::vector<int64_t>> inputShapes;
+  std::vector<LlgaTensorDesc> inputSpecs;
+};
+
+// Optional on-disk cache of the LLGA partitions a process has compiled.
+//
+// oneDNN Graph does not expose serialization of compiled partitions on CPU,
+// so the cache stores the compilation requests instead. When an LlgaKernel is
+// created it compiles every request recorded for its partition up front and
+// puts the result in the process-wide CompiledPartitionCache, so new
+// processes do not compile on the first request of each input shape.
+//
+// A partition is identified by its fusion subgraph, the ISA reported by
+// get_cpu_capability() and the oneDNN version, one file per partition under
+// the cache directory. The directory is taken from IPEX_LLGA_CACHE_DIR and
+// can be changed at runtime; an empty directory disables the cache.
+class PersistentPartitionCache {
+ public:
+  static PersistentPartitionCache& getInstance();
+
+  void setDirectory(const std::string& dir);
+
+  std::string getDirectory();
+
+  bool isEnabled();
+
+  std::string partitionId(const std::string& subgraph) const;
+
+  std::vector<PersistedCompilation> load(const std::string& partitionId);
+
+  void store(
+      const std::string& partitionId,
+      const PersistedCompilation& compilation);
+
+ private:
+  PersistentPartitionCache();
+  PersistentPartitionCache(const PersistentPartitionCache&) = delete;
+  void operator=(const PersistentPartitionCache&) = delete;
+
+  std::string filePath(const std::string& partitionId) const;
+
+  std::mutex mutex_;
+  std::string dir_;
+};
+
+} // namespace onednn
+} // namespace fuser
+} // namespace jit
+} // namespace torch_ipex
@@ -3,6 +3,7 @@
 #include <ATen/Tensor.h>
 
 #include <ideep.hpp>
+#include "ConvPrimitiveCache.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -27,6 +28,8 @@ struct ContextConvolution final {
   bool weight_is_channels_last_;
   ideep::convolution_forward_params conv_params_;
   ideep::convolution_forward::super conv_desc_;
+  // primitives of the input shapes other than the prepacked one
+  std::unique_ptr<ConvPrimitiveCache> primitive_cache_;
 
   ContextConvolution() = delete;
 
@@ -54,7 +57,8 @@ struct ContextConvolution final {
         groups_(groups),
         weight_is_channels_last_(weight_is_channels_last),
         conv_params_(conv_params),
-        conv_desc_(conv_desc) {}
+        conv_desc_(conv_desc),
+        primitive_cache_(std::make_unique<ConvPrimitiveCache>()) {}
 
   ContextConvolution(ContextConvolution&&) = default;
   ContextConvolution& operator=(ContextConvolution&&) = default;
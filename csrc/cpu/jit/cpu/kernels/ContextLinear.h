@@ -3,6 +3,7 @@
 #include <ATen/Tensor.h>
 
 #include <ideep.hpp>
+#include "LinearPrimitiveCache.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -14,6 +15,8 @@ struct ContextLinear final {
   // at_weight is used for autograd and optimizer update
   at::Tensor at_weight_;
   c10::optional<at::Tensor> at_bias_;
+  // primitives of the input shapes seen at runtime
+  std::unique_ptr<LinearPrimitiveCache> primitive_cache_;
 
   ContextLinear() = delete;
 
@@ -25,7 +28,8 @@ struct ContextLinear final {
       : original_desc_(std::move(original_desc)),
         weight_packed_(std::move(weight_packed)),
         at_weight_(std::move(at_weight)),
-        at_bias_(std::move(bias)) {}
+        at_bias_(std::move(bias)),
+        primitive_cache_(std::make_unique<LinearPrimitiveCache>()) {}
 
   ContextLinear(ContextLinear&&) = default;
   ContextLinear& operator=(ContextLinear&&) = default;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+
+#include "aten/SparseLinear.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+struct ContextLinearSparse final {
+  SparseLinearFormat format_;
+  int64_t out_features_;
+  int64_t in_features_;
+  // packed weight, see aten/SparseLinear.h
+  at::Tensor values_;
+  at::Tensor indices_;
+  at::Tensor row_ptr_;
+  at::Tensor bias_; // float bias padded to the output blocks
+  c10::optional<at::Tensor> at_bias_;
+
+  ContextLinearSparse() = delete;
+
+  ContextLinearSparse(
+      SparseLinearFormat format,
+      int64_t out_features,
+      int64_t in_features,
+      at::Tensor&& values,
+      at::Tensor&& indices,
+      at::Tensor&& row_ptr,
+      at::Tensor&& bias,
+      c10::optional<at::Tensor>&& at_bias)
+      : format_(format),
+        out_features_(out_features),
+        in_features_(in_features),
+        values_(std::move(values)),
+        indices_(std::move(indices)),
+        row_ptr_(std::move(row_ptr)),
+        bias_(std::move(bias)),
+        at_bias_(std::move(at_bias)) {}
+
+  ContextLinearSparse(ContextLinearSparse&&) = default;
+  ContextLinearSparse& operator=(ContextLinearSparse&&) = default;
+
+  ~ContextLinearSparse() {}
+};
+
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
@@ -7,6 +7,7 @@
 #include "aten/WeightPack.h"
 #include "aten/utils/utils.h"
 #include "ideep/IDeepConversions.h"
+#include "jit/auto_opt_config.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -622,6 +623,175 @@ ContextConvolution create(
       ideep::convolution_forward::super(conv_params.pd)};
 }
 
+// Pad the spatial dims of the input on the bottom/right side up to a multiple
+// of bucket_size. The padded elements are zeros, the same as the implicit
+// padding of the convolution, so the output in the range of the unpadded
+// input doesn't change and the rest is cropped after the computation.
+static at::Tensor pad_input_to_bucket(
+    const at::Tensor& input,
+    int64_t bucket_size,
+    at::MemoryFormat memory_format) {
+  if (bucket_size <= 1) {
+    return input;
+  }
+  // constant_pad_nd takes the pads starting from the last dim
+  std::vector<int64_t> pad;
+  bool need_pad = false;
+  for (int64_t d = input.dim() - 1; d >= 2; d--) {
+    int64_t size = input.size(d);
+    int64_t padded_size = (size + bucket_size - 1) / bucket_size * bucket_size;
+    pad.push_back(0);
+    pad.push_back(padded_size - size);
+    need_pad = need_pad || padded_size != size;
+  }
+  if (!need_pad) {
+    return input;
+  }
+  return at::constant_pad_nd(input, pad, 0).contiguous(memory_format);
+}
+
+// Returns the primitive cached in the context for the input shape, which is
+// created and cached on miss, or nullptr if the shape has to go to the slow
+// path.
+static std::shared_ptr<const ConvPrimitiveCache::Entry> get_cached_primitive(
+    const ContextConvolution& context,
+    const ideep::tensor& mkldnn_input,
+    ideep::tensor& mkldnn_output,
+    const ideep::attr_t& attr) {
+  int64_t capacity =
+      AutoOptConfig::singleton().get_conv_primitive_cache_capacity();
+  if (capacity <= 0) {
+    return nullptr;
+  }
+  auto src_desc = mkldnn_input.get_desc();
+  auto entry = context.primitive_cache_->find(src_desc, attr);
+  if (entry == nullptr) {
+    auto new_entry = std::make_shared<ConvPrimitiveCache::Entry>();
+    new_entry->src_desc_ = src_desc;
+    new_entry->attr_ = attr;
+    auto output_sizes = mkldnn_output.get_dims();
+    if (context.bias_.is_empty()) {
+      ideep::convolution_forward::prepare(
+          new_entry->conv_params_,
+          mkldnn_input,
+          context.weight_packed_,
+          output_sizes,
+          mkldnn_output,
+          {context.stride_.begin(), context.stride_.end()},
+          {context.dilation_.begin(), context.dilation_.end()},
+          {context.padding_.begin(), context.padding_.end()},
+          {context.padding_.begin(), context.padding_.end()},
+          context.groups_,
+          ideep::scale_t(),
+          ideep::scale_t(),
+          ideep::scale_t(),
+          attr,
+          ideep::algorithm::convolution_direct,
+          ideep::prop_kind::forward_inference);
+    } else {
+      ideep::convolution_forward::prepare(
+          new_entry->conv_params_,
+          mkldnn_input,
+          context.weight_packed_,
+          context.bias_,
+          output_sizes,
+          mkldnn_output,
+          {context.stride_.begin(), context.stride_.end()},
+          {context.dilation_.begin(), context.dilation_.end()},
+          {context.padding_.begin(), context.padding_.end()},
+          {context.padding_.begin(), context.padding_.end()},
+          context.groups_,
+          ideep::scale_t(),
+          ideep::scale_t(),
+          ideep::scale_t(),
+          attr,
+          ideep::algorithm::convolution_direct,
+          ideep::prop_kind::forward_inference);
+    }
+    // The weight is only packed once, a primitive preferring another weight
+    // format would need a reorder of the weight on every call.
+    new_entry->weight_compatible_ =
+        ideep::tensor::desc(
+            new_entry->conv_params_.pd.weights_desc(), context.groups_) ==
+        context.weight_packed_.get_desc();
+    if (new_entry->weight_compatible_) {
+      new_entry->conv_desc_ =
+          ideep::convolution_forward::super(new_entry->conv_params_.pd);
+    }
+    entry = context.primitive_cache_->insert(new_entry, capacity);
+  }
+  return entry->weight_compatible_ ? entry : nullptr;
+}
+
+static void compute_with_primitive(
+    const ContextConvolution& context,
+    const ConvPrimitiveCache::Entry& entry,
+    const ideep::tensor& mkldnn_input,
+    ideep::tensor& mkldnn_output) {
+  if (context.bias_.is_empty()) {
+    ideep::convolution_forward::compute(
+        entry.conv_params_,
+        entry.conv_desc_,
+        mkldnn_input,
+        context.weight_packed_,
+        mkldnn_output);
+  } else {
+    ideep::convolution_forward::compute(
+        entry.conv_params_,
+        entry.conv_desc_,
+        mkldnn_input,
+        context.weight_packed_,
+        context.bias_,
+        mkldnn_output);
+  }
+}
+
+// Run the input, whose shape differs from the prepacked one, with the cached
+// primitive. Returns an undefined tensor if the slow path has to be used.
+static at::Tensor run_with_primitive_cache(
+    const ContextConvolution& context,
+    const at::Tensor& input,
+    const ideep::attr_t& attr,
+    at::MemoryFormat memory_format) {
+  auto kernel_size = context.weight_packed_.get_dims();
+  std::vector<int64_t> output_sizes = calc_conv_output_size(
+      input.sizes(),
+      kernel_size,
+      context.padding_,
+      context.stride_,
+      context.dilation_);
+  auto input_ = pad_input_to_bucket(
+      input,
+      AutoOptConfig::singleton().get_conv_input_bucket_size(),
+      memory_format);
+  bool padded = !input_.is_same(input);
+  auto padded_output_sizes = padded ? calc_conv_output_size(
+                                          input_.sizes(),
+                                          kernel_size,
+                                          context.padding_,
+                                          context.stride_,
+                                          context.dilation_)
+                                    : output_sizes;
+  auto output = at::empty(
+      padded_output_sizes, input_.options().memory_format(memory_format));
+
+  const ideep::tensor mkldnn_input = itensor_view_from_dense(input_);
+  ideep::tensor mkldnn_output = itensor_view_from_dense(output);
+  auto entry =
+      get_cached_primitive(context, mkldnn_input, mkldnn_output, attr);
+  if (entry == nullptr) {
+    return at::Tensor();
+  }
+  compute_with_primitive(context, *entry, mkldnn_input, mkldnn_output);
+  if (padded) {
+    for (int64_t d = 2; d < output.dim(); d++) {
+      output = output.narrow(d, 0, output_sizes[d]);
+    }
+    output = output.contiguous(memory_format);
+  }
+  return output;
+}
+
 at::Tensor run(
     const ContextConvolution& context,
     const at::Tensor& input,
@@ -687,6 +857,14 @@ at::Tensor run(
     }
     return output;
   }
+  // 1d input goes to the slow path, which reorders it to channels last.
+  if (input_.dim() != 3) {
+    auto output =
+        run_with_primitive_cache(context, input_, attr, memory_format);
+    if (output.defined()) {
+      return output;
+    }
+  }
   return convolution_kernel(
       input_,
       context.weight_packed_,
@@ -764,18 +942,29 @@ at::Tensor& run(
           context.bias_,
           mkldnn_output);
     }
-  } else {
-    convolution_kernel_output(
-        input_,
-        context.weight_packed_,
-        context.bias_,
-        accumu,
-        context.stride_,
-        context.padding_,
-        context.dilation_,
-        context.groups_,
-        attr);
+    return accumu;
+  }
+
+  if (input_.dim() != 3) {
+    const ideep::tensor mkldnn_input = itensor_view_from_dense(input_);
+    ideep::tensor mkldnn_output = itensor_view_from_dense(accumu);
+    auto entry =
+        get_cached_primitive(context, mkldnn_input, mkldnn_output, attr);
+    if (entry != nullptr) {
+      compute_with_primitive(context, *entry, mkldnn_input, mkldnn_output);
+      return accumu;
+    }
   }
+  convolution_kernel_output(
+      input_,
+      context.weight_packed_,
+      context.bias_,
+      accumu,
+      context.stride_,
+      context.padding_,
+      context.dilation_,
+      context.groups_,
+      attr);
   return accumu;
 }
 
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ideep.hpp>
+#include "utils/primitive_cache.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+
+// The convolution primitive of one ConvolutionOpContext for an input shape,
+// keyed by the input desc (dims, data type and memory format) and the post-op
+// attr, so that models with dynamic input resolution reuse the primitives.
+struct ConvPrimitiveEntry {
+  ideep::tensor::desc src_desc_;
+  ideep::attr_t attr_;
+  ideep::convolution_forward_params conv_params_;
+  ideep::convolution_forward::super conv_desc_;
+  // False if the primitive expects another weight format than the prepacked
+  // one, then the shape always goes to the slow path instead of creating the
+  // primitive again.
+  bool weight_compatible_ = false;
+
+  bool matches(
+      const ideep::tensor::desc& src_desc,
+      const ideep::attr_t& attr) const {
+    return src_desc_ == src_desc && same_primitive_attr(attr, attr_);
+  }
+};
+
+using ConvPrimitiveCache = PrimitiveCache<ConvPrimitiveEntry>;
+
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
@@ -1,5 +1,6 @@
 #include "LinearMKLPacked.h"
 #include <ideep.hpp>
+#include "Mha.h"
 #include "aten/LinearMKL.h"
 #include "aten/WeightPack.h"
 #include "ideep/IDeepConversions.h"
@@ -30,6 +31,16 @@ at::Tensor mkl_sgemm_run(
   return op_context->run(input);
 }
 
+std::vector<at::Tensor> mkl_sgemm_qkv_run(
+    const at::Tensor& input,
+    const at::IntArrayRef& split_list,
+    int64_t num_head,
+    c10::intrusive_ptr<MKLOpContext> op_context) {
+  RECORD_FUNCTION(
+      "ipex_prepack::mkl_sgemm_qkv_run", c10::ArrayRef<c10::IValue>({}));
+  return dil_qkv_split_heads(op_context->run(input), split_list, num_head);
+}
+
 ContextLinearMKL create(
     at::Tensor& weight,
     const c10::optional<at::Tensor>& bias,
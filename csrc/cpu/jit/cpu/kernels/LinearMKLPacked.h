@@ -18,6 +18,14 @@ at::Tensor mkl_sgemm_run(
     const at::Tensor& input,
     c10::intrusive_ptr<MKLOpContext> op_context);
 
+// Concatenated query/key/value linear with the output split into
+// head-major [bs, num_head, seq, head_size] tensors
+std::vector<at::Tensor> mkl_sgemm_qkv_run(
+    const at::Tensor& input,
+    const at::IntArrayRef& split_list,
+    int64_t num_head,
+    c10::intrusive_ptr<MKLOpContext> op_context);
+
 ContextLinearMKL create(
     at::Tensor& weight,
     const c10::optional<at::Tensor>& bias,
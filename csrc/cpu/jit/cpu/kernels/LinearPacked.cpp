@@ -1,8 +1,10 @@
 #include "LinearPacked.h"
 #include <ideep.hpp>
+#include "Mha.h"
 #include "aten/Linear.h"
 #include "aten/WeightPack.h"
 #include "ideep/IDeepConversions.h"
+#include "jit/auto_opt_config.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -224,6 +226,17 @@ at::Tensor linear_mul_add_run(
       input, post_op_tensors, op_attr.set_fpmath_mode(torch_ipex::fpmath_mode));
 }
 
+std::vector<at::Tensor> linear_qkv_run(
+    const at::Tensor& input,
+    const at::IntArrayRef& split_list,
+    int64_t num_head,
+    const c10::intrusive_ptr<LinearOpContext>& op_context) {
+  RECORD_FUNCTION(
+      "ipex_prepack::linear_qkv_run", c10::ArrayRef<c10::IValue>({}));
+  auto qkv = op_context->run(input, ideep::attr_t(torch_ipex::fpmath_mode));
+  return dil_qkv_split_heads(qkv, split_list, num_head);
+}
+
 ContextLinear create(
     const at::Tensor& weight,
     const c10::optional<at::Tensor>& bias,
@@ -264,6 +277,112 @@ ContextLinear create(
   };
 }
 
+// Returns the primitive cached in the context for the 2D input, which is
+// created and cached on miss, or nullptr if the shape has to go to the slow
+// path.
+static std::shared_ptr<const LinearPrimitiveCache::Entry> get_cached_primitive(
+    const ContextLinear& context,
+    const ideep::tensor& mkldnn_input,
+    ideep::tensor& mkldnn_output,
+    const ideep::attr_t& attr) {
+  int64_t capacity =
+      AutoOptConfig::singleton().get_linear_primitive_cache_capacity();
+  if (capacity <= 0) {
+    return nullptr;
+  }
+  auto src_desc = mkldnn_input.get_desc();
+  auto entry = context.primitive_cache_->find(src_desc, attr);
+  if (entry == nullptr) {
+    auto new_entry = std::make_shared<LinearPrimitiveCache::Entry>();
+    new_entry->src_desc_ = src_desc;
+    new_entry->attr_ = attr;
+    if (context.at_bias_) {
+      auto mkldnn_bias = itensor_view_from_dense(*context.at_bias_);
+      ideep::inner_product_forward::prepare(
+          new_entry->params_,
+          mkldnn_input,
+          context.weight_packed_,
+          mkldnn_bias,
+          mkldnn_output,
+          attr);
+    } else {
+      ideep::inner_product_forward::prepare(
+          new_entry->params_,
+          mkldnn_input,
+          context.weight_packed_,
+          mkldnn_output,
+          attr);
+    }
+    // The weight is only packed once, a primitive preferring another weight
+    // format would need a reorder of the weight on every call.
+    new_entry->weight_compatible_ =
+        ideep::tensor::desc(new_entry->params_.pd.weights_desc()) ==
+        context.weight_packed_.get_desc();
+    entry = context.primitive_cache_->insert(new_entry, capacity);
+  }
+  return entry->weight_compatible_ ? entry : nullptr;
+}
+
+static void compute_with_primitive(
+    const ContextLinear& context,
+    const LinearPrimitiveCache::Entry& entry,
+    const ideep::tensor& mkldnn_input,
+    ideep::tensor& mkldnn_output) {
+  if (context.at_bias_) {
+    auto mkldnn_bias = itensor_view_from_dense(*context.at_bias_);
+    ideep::inner_product_forward::compute<true, false>(
+        entry.params_,
+        mkldnn_input,
+        context.weight_packed_,
+        mkldnn_bias,
+        mkldnn_output);
+  } else {
+    ideep::inner_product_forward::compute<true, false>(
+        entry.params_, mkldnn_input, context.weight_packed_, mkldnn_output);
+  }
+}
+
+// Run the contiguous input with the cached primitive. The rows of the
+// flattened input are padded with zeros up to a multiple of the M bucket size,
+// each row of the output only depends on the same row of the input, so the
+// padded rows are just dropped after the computation. Returns an undefined
+// tensor if the slow path has to be used.
+static at::Tensor run_with_primitive_cache(
+    const ContextLinear& context,
+    const at::Tensor& input,
+    const ideep::attr_t& attr) {
+  // See [Note: onednn inner product with Pytorch Linear]
+  auto input_2d =
+      input.dim() == 2 ? input : input.reshape({-1, input.size(-1)});
+  int64_t m = input_2d.size(0);
+  if (m == 0) {
+    return at::Tensor();
+  }
+  int64_t bucket_size = AutoOptConfig::singleton().get_linear_m_bucket_size();
+  int64_t padded_m = bucket_size > 1
+      ? (m + bucket_size - 1) / bucket_size * bucket_size
+      : m;
+  if (padded_m != m) {
+    input_2d = at::constant_pad_nd(input_2d, {0, 0, 0, padded_m - m}, 0);
+  }
+  int64_t n = context.weight_packed_.get_dim(0);
+  auto output_2d = at::empty({padded_m, n}, input.options());
+
+  const ideep::tensor mkldnn_input = itensor_view_from_dense(input_2d);
+  ideep::tensor mkldnn_output = itensor_view_from_dense(output_2d);
+  auto entry =
+      get_cached_primitive(context, mkldnn_input, mkldnn_output, attr);
+  if (entry == nullptr) {
+    return at::Tensor();
+  }
+  compute_with_primitive(context, *entry, mkldnn_input, mkldnn_output);
+
+  auto output_size = input.sizes().vec();
+  output_size.back() = n;
+  // narrow on the rows of a row-major matrix keeps it contiguous
+  return output_2d.narrow(0, 0, m).view(output_size);
+}
+
 at::Tensor run(
     const ContextLinear& context,
     const at::Tensor& input,
@@ -272,6 +391,10 @@ at::Tensor run(
       input.size(input.dim() - 1) == context.weight_packed_.get_dims()[1],
       "Check the shapes of mat1 and mat2, they cannot be multiplied!");
   auto input_ = input.contiguous();
+  auto output = run_with_primitive_cache(context, input_, attr);
+  if (output.defined()) {
+    return output;
+  }
   c10::MaybeOwned<at::Tensor> bias_maybe_owned =
       at::borrow_from_optional_tensor(context.at_bias_);
   const at::Tensor& bias = *bias_maybe_owned;
@@ -287,6 +410,21 @@ at::Tensor& run(
       input.size(input.dim() - 1) == context.weight_packed_.get_dims()[1],
       "Check the shapes of mat1 and mat2, they cannot be multiplied!");
   auto input_ = input.contiguous();
+  // The sum post-op reads the accumu in place, so the rows can't be padded
+  // and M is looked up as is.
+  if (accumu.is_contiguous() && input_.numel() > 0) {
+    auto input_2d =
+        input_.dim() == 2 ? input_ : input_.reshape({-1, input_.size(-1)});
+    auto accumu_2d = accumu.view({input_2d.size(0), -1});
+    const ideep::tensor mkldnn_input = itensor_view_from_dense(input_2d);
+    ideep::tensor mkldnn_output = itensor_view_from_dense(accumu_2d);
+    auto entry =
+        get_cached_primitive(context, mkldnn_input, mkldnn_output, attr);
+    if (entry != nullptr) {
+      compute_with_primitive(context, *entry, mkldnn_input, mkldnn_output);
+      return accumu;
+    }
+  }
   c10::MaybeOwned<at::Tensor> bias_maybe_owned =
       at::borrow_from_optional_tensor(context.at_bias_);
   const at::Tensor& bias = *bias_maybe_owned;
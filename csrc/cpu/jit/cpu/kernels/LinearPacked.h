@@ -88,6 +88,14 @@ at::Tensor linear_mul_add_run(
     const at::Tensor& to_add,
     const c10::intrusive_ptr<LinearOpContext>& op_context);
 
+// Concatenated query/key/value linear with the output split into
+// head-major [bs, num_head, seq, head_size] tensors
+std::vector<at::Tensor> linear_qkv_run(
+    const at::Tensor& input,
+    const at::IntArrayRef& split_list,
+    int64_t num_head,
+    const c10::intrusive_ptr<LinearOpContext>& op_context);
+
 ContextLinear create(
     const at::Tensor& weight,
     const c10::optional<at::Tensor>& bias,
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <ideep.hpp>
+#include "utils/primitive_cache.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+
+// The inner product primitive of one LinearOpContext for a batch size (M) of
+// the flattened 2D input, which changes from call to call with dynamic
+// batching or variable sequence length. Keyed by the input desc (M, K and the
+// data type) and the post-op attr. With M bucketing enabled, M is rounded up
+// before the lookup so that one entry serves the whole bucket.
+struct LinearPrimitiveEntry {
+  ideep::tensor::desc src_desc_;
+  ideep::attr_t attr_;
+  ideep::inner_product_forward_params params_;
+  // False if the primitive expects another weight format than the prepacked
+  // one, then the shape always goes to the slow path instead of creating the
+  // primitive again.
+  bool weight_compatible_ = false;
+
+  bool matches(
+      const ideep::tensor::desc& src_desc,
+      const ideep::attr_t& attr) const {
+    return src_desc_ == src_desc && same_primitive_attr(attr, attr_);
+  }
+};
+
+using LinearPrimitiveCache = PrimitiveCache<LinearPrimitiveEntry>;
+
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
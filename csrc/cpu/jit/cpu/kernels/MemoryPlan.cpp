@@ -0,0 +1,177 @@
+#include "MemoryPlan.h"
+#include <ATen/ATen.h>
+#include <ATen/record_function.h>
+#include <ideep.hpp>
+#include "ideep/IDeepConversions.h"
+
+#include <algorithm>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+// The plans the thread has an arena in, so that the arenas are freed when the
+// thread exits instead of staying with the plan.
+class ThreadArenas {
+ public:
+  void add(c10::weak_intrusive_ptr<MemoryPlan> plan) {
+    // forget the plans already destroyed
+    plans_.erase(
+        std::remove_if(
+            plans_.begin(),
+            plans_.end(),
+            [](const c10::weak_intrusive_ptr<MemoryPlan>& p) {
+              return p.expired();
+            }),
+        plans_.end());
+    plans_.push_back(std::move(plan));
+  }
+
+  ~ThreadArenas() {
+    for (auto& weak_plan : plans_) {
+      if (auto plan = weak_plan.lock()) {
+        plan->release_arena(std::this_thread::get_id());
+      }
+    }
+  }
+
+ private:
+  std::vector<c10::weak_intrusive_ptr<MemoryPlan>> plans_;
+};
+
+thread_local ThreadArenas thread_arenas;
+
+} // namespace
+
+at::Tensor MemoryPlan::get_buffer(int64_t slot, const at::Tensor& input) {
+  const Slot& s = slots_[slot];
+  if (input.scalar_type() != s.input_dtype_ ||
+      !input.sizes().equals(s.input_sizes_) ||
+      !input.strides().equals(s.input_strides_)) {
+    return at::Tensor();
+  }
+
+  at::Tensor arena;
+  bool created = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& thread_arena = arenas_[std::this_thread::get_id()];
+    if (!thread_arena.defined()) {
+      thread_arena = at::empty({arena_size_}, input.options().dtype(at::kByte));
+      created = true;
+    }
+    arena = thread_arena;
+  }
+  if (created) {
+    thread_arenas.add(c10::weak_intrusive_ptr<MemoryPlan>(
+        c10::intrusive_ptr<MemoryPlan>::unsafe_reclaim_from_nonowning(this)));
+  }
+  // The offsets are 64 bytes aligned by the pass, so they are always a
+  // multiple of the element size.
+  return at::empty({0}, input.options().dtype(s.output_dtype_))
+      .set_(
+          arena.storage(),
+          s.offset_ / c10::elementSize(s.output_dtype_),
+          s.output_sizes_,
+          s.output_strides_);
+}
+
+int64_t MemoryPlan::get_num_arenas() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return arenas_.size();
+}
+
+void MemoryPlan::release_arena(std::thread::id thread) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  arenas_.erase(thread);
+}
+
+// The memory of the plan outlives it while a thread holds a weak reference,
+// so the arenas are freed here rather than in the destructor.
+void MemoryPlan::release_resources() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  arenas_.clear();
+}
+
+namespace detail {
+namespace memory_plan {
+
+#define RETURN_UNARY_POST_OP_ATTR(FUSED_OP)                  \
+  if (post_op == #FUSED_OP) {                                \
+    return ideep::attr_t::fuse_##FUSED_OP().set_fpmath_mode( \
+        torch_ipex::fpmath_mode);                            \
+  }
+
+// Same attr as the one of ipex_prepack::{linear,convolution}_<post_op>_run,
+// so that the convolution takes its prepacked primitive.
+static ideep::attr_t get_post_op_attr(const std::string& post_op) {
+  RETURN_UNARY_POST_OP_ATTR(relu);
+  RETURN_UNARY_POST_OP_ATTR(sigmoid);
+  RETURN_UNARY_POST_OP_ATTR(swish);
+  RETURN_UNARY_POST_OP_ATTR(tanh);
+  RETURN_UNARY_POST_OP_ATTR(mish);
+  RETURN_UNARY_POST_OP_ATTR(abs);
+  RETURN_UNARY_POST_OP_ATTR(exp);
+  RETURN_UNARY_POST_OP_ATTR(hardswish);
+  RETURN_UNARY_POST_OP_ATTR(square);
+  RETURN_UNARY_POST_OP_ATTR(log);
+  RETURN_UNARY_POST_OP_ATTR(round);
+  RETURN_UNARY_POST_OP_ATTR(sqrt);
+  RETURN_UNARY_POST_OP_ATTR(hardsigmoid);
+  TORCH_CHECK(post_op.empty(), "MemoryPlan: unsupported post-op ", post_op);
+  return ideep::attr_t(torch_ipex::fpmath_mode);
+}
+
+#undef RETURN_UNARY_POST_OP_ATTR
+
+at::Tensor linear_planned_run(
+    const at::Tensor& input,
+    int64_t slot,
+    const c10::intrusive_ptr<MemoryPlan>& plan,
+    const c10::intrusive_ptr<LinearOpContext>& op_context) {
+  RECORD_FUNCTION(
+      "ipex_prepack::linear_planned_run", c10::ArrayRef<c10::IValue>({}));
+  auto attr = get_post_op_attr(plan->get_slot(slot).post_op_);
+  auto output = plan->get_buffer(slot, input);
+  if (!output.defined()) {
+    return op_context->run(input, attr);
+  }
+  // the attr has no sum post-op, so the buffer is overwritten
+  return op_context->run(input, output, attr);
+}
+
+at::Tensor convolution_planned_run(
+    const at::Tensor& input,
+    int64_t slot,
+    const c10::intrusive_ptr<MemoryPlan>& plan,
+    const c10::intrusive_ptr<ConvolutionOpContext>& op_context) {
+  RECORD_FUNCTION(
+      "ipex_prepack::convolution_planned_run", c10::ArrayRef<c10::IValue>({}));
+  auto attr = get_post_op_attr(plan->get_slot(slot).post_op_);
+  auto output = plan->get_buffer(slot, input);
+  if (!output.defined()) {
+    return op_context->run(input, attr);
+  }
+  return op_context->run(input, output, attr);
+}
+
+at::Tensor mkl_sgemm_planned_run(
+    const at::Tensor& input,
+    int64_t slot,
+    const c10::intrusive_ptr<MemoryPlan>& plan,
+    const c10::intrusive_ptr<MKLOpContext>& op_context) {
+  RECORD_FUNCTION(
+      "ipex_prepack::mkl_sgemm_planned_run", c10::ArrayRef<c10::IValue>({}));
+  auto output = plan->get_buffer(slot, input);
+  if (!output.defined()) {
+    return op_context->run(input);
+  }
+  // the sgemm overwrites the buffer, the bias is copied in first if any
+  return op_context->run(input, output);
+}
+
+} // namespace memory_plan
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <torch/custom_class.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "OpContext.h"
+
+namespace torch_ipex {
+namespace cpu {
+
+// Static memory plan of the outputs of the prepacked ops of one JIT-fused
+// graph. The PlanStaticMemory pass assigns each planned output a slot at a
+// fixed offset of one arena, from the input and output shapes profiled by the
+// graph executor, so that the outputs whose lifetimes don't overlap share the
+// memory and nothing is allocated at runtime.
+//
+// The plan is only valid for the profiled shapes. An op whose input doesn't
+// match the slot at runtime gets an undefined buffer and allocates its output
+// as usual. Each thread running the graph gets its own arena, so that the
+// instances of MultiInstanceEngine sharing one module don't share the buffers.
+// The arena of a thread is released when the thread exits.
+class MemoryPlan : public torch::jit::CustomClassHolder {
+ public:
+  struct Slot {
+    int64_t offset_;
+    std::vector<int64_t> input_sizes_;
+    std::vector<int64_t> input_strides_;
+    c10::ScalarType input_dtype_;
+    std::vector<int64_t> output_sizes_;
+    std::vector<int64_t> output_strides_;
+    c10::ScalarType output_dtype_;
+    // name of the fused unary post-op, empty for none
+    std::string post_op_;
+  };
+
+  MemoryPlan(int64_t arena_size, std::vector<Slot> slots)
+      : arena_size_(arena_size), slots_(std::move(slots)) {}
+
+  // Returns the view of the arena of current thread for the output of slot,
+  // or an undefined tensor if the input doesn't match the profiled one.
+  at::Tensor get_buffer(int64_t slot, const at::Tensor& input);
+
+  const Slot& get_slot(int64_t slot) const {
+    return slots_[slot];
+  }
+
+  int64_t get_arena_size() {
+    return arena_size_;
+  }
+
+  int64_t get_num_slots() {
+    return slots_.size();
+  }
+
+  // Number of live threads that have run the graph with the planned shapes.
+  int64_t get_num_arenas();
+
+  // Frees the arena of the thread, called when the thread exits.
+  void release_arena(std::thread::id thread);
+
+  void release_resources() override;
+
+ private:
+  int64_t arena_size_;
+  std::vector<Slot> slots_;
+  std::mutex mutex_;
+  std::unordered_map<std::thread::id, at::Tensor> arenas_;
+};
+
+namespace detail {
+namespace memory_plan {
+
+at::Tensor linear_planned_run(
+    const at::Tensor& input,
+    int64_t slot,
+    const c10::intrusive_ptr<MemoryPlan>& plan,
+    const c10::intrusive_ptr<LinearOpContext>& op_context);
+
+at::Tensor convolution_planned_run(
+    const at::Tensor& input,
+    int64_t slot,
+    const c10::intrusive_ptr<MemoryPlan>& plan,
+    const c10::intrusive_ptr<ConvolutionOpContext>& op_context);
+
+at::Tensor mkl_sgemm_planned_run(
+    const at::Tensor& input,
+    int64_t slot,
+    const c10::intrusive_ptr<MemoryPlan>& plan,
+    const c10::intrusive_ptr<MKLOpContext>& op_context);
+
+} // namespace memory_plan
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
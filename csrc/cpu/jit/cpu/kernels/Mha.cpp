@@ -308,5 +308,70 @@ c10::List<at::Tensor> dil_split_tensor(
   RECORD_FUNCTION("dil_split_tensor", c10::ArrayRef<c10::IValue>({}));
   return c10::List<at::Tensor>(dil_mat_split<at::BFloat16>(mat, split_list));
 }
+
+/**
+ * Split the output of the concatenated query/key/value linear,
+ * [bs, seq, sum(split_list)], into contiguous head-major
+ * [bs, num_head, seq, head_size] tensors in a single pass. It replaces the
+ * split copy after the linear and the copies that make the permuted views
+ * contiguous in the attention. Only the element size matters for the copy,
+ * so all the dtypes share one implementation.
+ */
+std::vector<at::Tensor> dil_qkv_split_heads(
+    const at::Tensor& qkv,
+    const at::IntArrayRef& split_list,
+    const int64_t& num_head) {
+  RECORD_FUNCTION("dil_qkv_split_heads", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      qkv.dim() == 3,
+      "dil_qkv_split_heads: expect qkv to be [bs, seq, hidden_size]");
+  int64_t batchSize = qkv.size(0);
+  int64_t sequenceSize = qkv.size(1);
+  int64_t total_size = qkv.size(2);
+  int64_t split_size = split_list.size();
+  std::vector<int64_t> offsets(split_size);
+  std::vector<int64_t> headSizes(split_size);
+  int64_t accum = 0;
+  for (int64_t j = 0; j < split_size; ++j) {
+    TORCH_CHECK(
+        split_list[j] % num_head == 0,
+        "dil_qkv_split_heads: split size is not divisible by num_head");
+    offsets[j] = accum;
+    headSizes[j] = split_list[j] / num_head;
+    accum += split_list[j];
+  }
+  TORCH_CHECK(
+      accum == total_size,
+      "dil_qkv_split_heads: split sizes don't sum up to the hidden size");
+
+  std::vector<at::Tensor> split_mat;
+  std::vector<char*> dst;
+  for (int64_t j = 0; j < split_size; ++j) {
+    split_mat.push_back(at::empty(
+        {batchSize, num_head, sequenceSize, headSizes[j]}, qkv.options()));
+    dst.push_back(static_cast<char*>(split_mat[j].data_ptr()));
+  }
+  auto qkv_ = qkv.contiguous();
+  int64_t elem_size = qkv_.element_size();
+  const char* src = static_cast<const char*>(qkv_.data_ptr());
+  at::parallel_for(
+      0, batchSize * sequenceSize, 1, [&](int64_t begin, int64_t end) {
+        for (const auto i : c10::irange(begin, end)) {
+          int64_t b = i / sequenceSize;
+          int64_t s = i % sequenceSize;
+          const char* row = src + i * total_size * elem_size;
+          for (int64_t j = 0; j < split_size; ++j) {
+            int64_t row_bytes = headSizes[j] * elem_size;
+            for (int64_t h = 0; h < num_head; ++h) {
+              memcpy(
+                  dst[j] + ((b * num_head + h) * sequenceSize + s) * row_bytes,
+                  row + offsets[j] * elem_size + h * row_bytes,
+                  row_bytes);
+            }
+          }
+        }
+      });
+  return split_mat;
+}
 } // namespace cpu
 } // namespace torch_ipex
@@ -97,5 +97,10 @@ c10::List<at::Tensor> dil_split_tensor(
     const at::Tensor& mat,
     const at::IntArrayRef& split_list);
 
+std::vector<at::Tensor> dil_qkv_split_heads(
+    const at::Tensor& qkv,
+    const at::IntArrayRef& split_list,
+    const int64_t& num_head);
+
 } // namespace cpu
 } // namespace torch_ipex
@@ -5,10 +5,41 @@
 #include "LinearMKLPacked.h"
 #include "LinearPacked.h"
 #include "LinearWoqPacked.h"
+#include "SparseLinearPacked.h"
+#include "utils/op_instrumentation.h"
 
 namespace torch_ipex {
 namespace cpu {
 
+// FLOPs of the GEMM of the prepacked linear: 2 * M * K * N, with the input
+// of M * K elements. The bytes are the input, the weight and the output.
+static void add_linear_stats(
+    instrumentation::OpScope& scope,
+    const at::Tensor& input,
+    int64_t out_features,
+    int64_t weight_nbytes,
+    const at::Tensor& output) {
+  scope.add_tensor(input);
+  scope.add_bytes(weight_nbytes + output.nbytes());
+  scope.add_flops(2 * input.numel() * out_features);
+}
+
+// FLOPs of the prepacked convolution: 2 * MACs per output element, which is
+// the weight elements per output channel.
+static void add_convolution_stats(
+    instrumentation::OpScope& scope,
+    const at::Tensor& input,
+    const ideep::tensor& weight,
+    const at::Tensor& output) {
+  scope.add_tensor(input);
+  scope.add_bytes(weight.get_size() + output.nbytes());
+  if (output.dim() > 1 && output.size(1) > 0) {
+    scope.add_flops(
+        2 * output.numel() *
+        static_cast<int64_t>(weight.get_desc().nelems()) / output.size(1));
+  }
+}
+
 template <typename T1, typename T2>
 void load_from_ctx_template(T1* self, c10::intrusive_ptr<T2> other) {
   auto& other_ctx_ = other->get_context();
@@ -80,18 +111,37 @@ int64_t ConvolutionOpContext::get_groups() {
   return this->get_context().groups_;
 }
 
+int64_t ConvolutionOpContext::get_primitive_cache_size() {
+  return this->get_context().primitive_cache_->get_stats().size;
+}
+
+void ConvolutionOpContext::clear_primitive_cache() {
+  this->get_context().primitive_cache_->clear();
+}
+
 at::Tensor IpexConvolutionOpContext::run(
     const at::Tensor& input,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::convolution::run(op_context_, input, attr);
+  instrumentation::OpScope scope("ConvolutionOpContext::run");
+  auto output =
+      torch_ipex::cpu::detail::convolution::run(op_context_, input, attr);
+  if (scope.active()) {
+    add_convolution_stats(scope, input, op_context_.weight_packed_, output);
+  }
+  return output;
 }
 
 at::Tensor& IpexConvolutionOpContext::run(
     const at::Tensor& input,
     at::Tensor& accumu,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::convolution::run(
+  instrumentation::OpScope scope("ConvolutionOpContext::run");
+  auto& output = torch_ipex::cpu::detail::convolution::run(
       op_context_, input, accumu, attr);
+  if (scope.active()) {
+    add_convolution_stats(scope, input, op_context_.weight_packed_, output);
+  }
+  return output;
 }
 
 std::tuple<at::Tensor, at::Tensor, at::Tensor> IpexConvolutionOpContext::
@@ -154,22 +204,53 @@ at::Tensor IpexLinearOpContext::get_data_handle() {
 at::Tensor IpexLinearOpContext::run(
     const at::Tensor& input,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::linear::run(op_context_, input, attr);
+  instrumentation::OpScope scope("LinearOpContext::run");
+  auto output = torch_ipex::cpu::detail::linear::run(op_context_, input, attr);
+  if (scope.active()) {
+    add_linear_stats(
+        scope,
+        input,
+        op_context_.weight_packed_.get_dim(0),
+        op_context_.weight_packed_.get_size(),
+        output);
+  }
+  return output;
 }
 
 at::Tensor& IpexLinearOpContext::run(
     const at::Tensor& input,
     at::Tensor& accumu,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::linear::run(op_context_, input, accumu, attr);
+  instrumentation::OpScope scope("LinearOpContext::run");
+  auto& output =
+      torch_ipex::cpu::detail::linear::run(op_context_, input, accumu, attr);
+  if (scope.active()) {
+    add_linear_stats(
+        scope,
+        input,
+        op_context_.weight_packed_.get_dim(0),
+        op_context_.weight_packed_.get_size(),
+        output);
+  }
+  return output;
 }
 
 at::Tensor IpexLinearOpContext::run_with_binary_post_op(
     const at::Tensor& input,
     const std::vector<ideep::tensor>& post_op_src,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::linear::run(
+  instrumentation::OpScope scope("LinearOpContext::run");
+  auto output = torch_ipex::cpu::detail::linear::run(
       op_context_, input, post_op_src, attr);
+  if (scope.active()) {
+    add_linear_stats(
+        scope,
+        input,
+        op_context_.weight_packed_.get_dim(0),
+        op_context_.weight_packed_.get_size(),
+        output);
+  }
+  return output;
 }
 
 std::tuple<at::Tensor, at::Tensor, at::Tensor> IpexLinearOpContext::
@@ -185,6 +266,19 @@ at::Tensor IpexLinearOpContext::get_at_packed_weight() {
   return op_context_.at_weight_;
 }
 
+std::tuple<int64_t, int64_t, int64_t> LinearOpContext::
+    get_primitive_cache_stats() {
+  auto stats = this->get_context().primitive_cache_->get_stats();
+  return std::make_tuple(
+      static_cast<int64_t>(stats.hits),
+      static_cast<int64_t>(stats.misses),
+      static_cast<int64_t>(stats.size));
+}
+
+void LinearOpContext::clear_primitive_cache() {
+  this->get_context().primitive_cache_->clear();
+}
+
 c10::optional<at::Tensor> IpexLinearOpContext::get_at_bias() {
   return op_context_.at_bias_;
 }
@@ -265,13 +359,34 @@ at::Tensor IpexLinearMKLOpContext::pack(const at::Tensor& tensor) {
 }
 
 at::Tensor IpexLinearMKLOpContext::run(const at::Tensor& input) {
-  return torch_ipex::cpu::detail::mkl_sgemm::run(op_context_, input);
+  instrumentation::OpScope scope("MKLOpContext::run");
+  auto output = torch_ipex::cpu::detail::mkl_sgemm::run(op_context_, input);
+  if (scope.active()) {
+    add_linear_stats(
+        scope,
+        input,
+        get_out_features(),
+        op_context_.at_weight_.nbytes(),
+        output);
+  }
+  return output;
 }
 
 at::Tensor& IpexLinearMKLOpContext::run(
     const at::Tensor& input,
     at::Tensor& accumu) {
-  return torch_ipex::cpu::detail::mkl_sgemm::run(op_context_, input, accumu);
+  instrumentation::OpScope scope("MKLOpContext::run");
+  auto& output =
+      torch_ipex::cpu::detail::mkl_sgemm::run(op_context_, input, accumu);
+  if (scope.active()) {
+    add_linear_stats(
+        scope,
+        input,
+        get_out_features(),
+        op_context_.at_weight_.nbytes(),
+        output);
+  }
+  return output;
 }
 
 at::Tensor IpexLinearMKLOpContext::to_public(const at::Tensor& tensor) {
@@ -295,6 +410,63 @@ void IpexLinearMKLOpContext::load_from_ctx(
   load_from_ctx_template(this, other);
 }
 
+c10::intrusive_ptr<SparseLinearOpContext> IpexSparseLinearOpContext::
+    create_context(
+        at::Tensor&& weight,
+        c10::optional<at::Tensor>&& bias,
+        const std::string& format) {
+  auto op_context =
+      torch_ipex::cpu::detail::sparse_linear::create(weight, bias, format);
+  return c10::make_intrusive<IpexSparseLinearOpContext>(std::move(op_context));
+}
+
+at::Tensor IpexSparseLinearOpContext::get_at_packed_weight() {
+  return op_context_.values_;
+}
+
+c10::optional<at::Tensor> IpexSparseLinearOpContext::get_at_bias() {
+  return op_context_.at_bias_;
+}
+
+at::Tensor IpexSparseLinearOpContext::get_data_handle() {
+  at::Tensor ptr = at::empty(1, at::kLong);
+  ptr[0] = reinterpret_cast<int64_t>(this);
+  return ptr;
+}
+
+at::Tensor IpexSparseLinearOpContext::run(const at::Tensor& input) {
+  instrumentation::OpScope scope("SparseLinearOpContext::run");
+  auto output =
+      torch_ipex::cpu::detail::sparse_linear::run(op_context_, input);
+  if (scope.active()) {
+    // only the stored weights are computed and read
+    auto& values = op_context_.values_;
+    int64_t K = op_context_.in_features_;
+    int64_t M = K > 0 ? input.numel() / K : 0;
+    scope.add_tensor(input);
+    scope.add_bytes(
+        values.nbytes() + op_context_.indices_.nbytes() + output.nbytes());
+    scope.add_flops(2 * M * values.numel());
+  }
+  return output;
+}
+
+at::Tensor IpexSparseLinearOpContext::to_public(const at::Tensor& tensor) {
+  return torch_ipex::cpu::detail::sparse_linear::unpack(op_context_);
+}
+
+detail::ContextLinearSparse& IpexSparseLinearOpContext::get_context() {
+  return op_context_;
+}
+
+int64_t IpexSparseLinearOpContext::get_out_features() {
+  return op_context_.out_features_;
+}
+
+int64_t IpexSparseLinearOpContext::get_in_features() {
+  return op_context_.in_features_;
+}
+
 at::Tensor IpexConvTransposeOpContext::run(
     const at::Tensor& input,
     const ideep::attr_t& attr) {
@@ -9,6 +9,7 @@
 #include "ContextConvolution.h"
 #include "ContextLinear.h"
 #include "ContextLinearMKL.h"
+#include "ContextLinearSparse.h"
 #include "ContextLinearWoq.h"
 #include "assert.h"
 
@@ -86,6 +87,12 @@ class ConvolutionOpContext : public torch::jit::CustomClassHolder {
 
   int64_t get_groups();
 
+  // Number of input shapes the primitives are cached for, besides the
+  // prepacked one.
+  int64_t get_primitive_cache_size();
+
+  void clear_primitive_cache();
+
   virtual detail::ContextConvolution& get_context() = 0;
 
   virtual at::Tensor get_data_handle() = 0;
@@ -211,6 +218,11 @@ class LinearOpContext : public torch::jit::CustomClassHolder {
 
   virtual detail::ContextLinear& get_context() = 0;
 
+  // (hits, misses, size) of the primitive cache
+  std::tuple<int64_t, int64_t, int64_t> get_primitive_cache_stats();
+
+  void clear_primitive_cache();
+
   // The load_state_dict behavior for nn.Modules are inplace copy weight from
   // state_dict So the load_state_dict for optimizer can only handle the states
   // and keep parameter groups un-changed Thus we need this method to apply
@@ -359,6 +371,69 @@ class IpexLinearMKLOpContext final : public MKLOpContext {
   virtual void load_from_ctx(c10::intrusive_ptr<MKLOpContext> other) override;
 };
 
+// Linear with the sparse weight packed in the block or 2:4 format of
+// aten/SparseLinear.h
+using SerializationTypeSparseLinearPrePack =
+    std::tuple<at::Tensor, c10::optional<at::Tensor>, std::string>;
+
+class SparseLinearOpContext : public torch::jit::CustomClassHolder {
+ public:
+  SerializationTypeSparseLinearPrePack unpack() {
+    auto& context = this->get_context();
+    return std::make_tuple(
+        this->to_public(this->get_at_packed_weight()),
+        context.at_bias_,
+        std::string(sparse_linear_format_to_string(context.format_)));
+  }
+
+  virtual at::Tensor get_at_packed_weight() = 0;
+
+  virtual c10::optional<at::Tensor> get_at_bias() = 0;
+
+  virtual at::Tensor get_data_handle() = 0;
+
+  virtual at::Tensor run(const at::Tensor& input) = 0;
+
+  // Unpack given tensor to same format with original public format for weight
+  virtual at::Tensor to_public(const at::Tensor& tensor) = 0;
+
+  virtual int64_t get_out_features() = 0;
+
+  virtual int64_t get_in_features() = 0;
+
+  virtual detail::ContextLinearSparse& get_context() = 0;
+};
+
+class IpexSparseLinearOpContext final : public SparseLinearOpContext {
+ private:
+  detail::ContextLinearSparse op_context_;
+
+ public:
+  IpexSparseLinearOpContext(detail::ContextLinearSparse&& op_context)
+      : op_context_(std::move(op_context)) {}
+
+  virtual at::Tensor get_at_packed_weight() override;
+
+  virtual c10::optional<at::Tensor> get_at_bias() override;
+
+  virtual at::Tensor get_data_handle() override;
+
+  virtual at::Tensor run(const at::Tensor& input) override;
+
+  virtual at::Tensor to_public(const at::Tensor& tensor) override;
+
+  virtual detail::ContextLinearSparse& get_context() override;
+
+  virtual int64_t get_out_features() override;
+
+  virtual int64_t get_in_features() override;
+
+  static c10::intrusive_ptr<SparseLinearOpContext> create_context(
+      at::Tensor&& weight,
+      c10::optional<at::Tensor>&& bias,
+      const std::string& format);
+};
+
 // Weight-only quantization
 using SerializationTypeWoqLinearPrePack = std::tuple<
     at::Tensor,
@@ -6,7 +6,9 @@
 #include "LinearMKLPacked.h"
 #include "LinearPacked.h"
 #include "LinearWoqPacked.h"
+#include "MemoryPlan.h"
 #include "OpContext.h"
+#include "SparseLinearPacked.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -14,6 +16,7 @@ using detail::conv_transpose::createConvTransposePrePackOpContext;
 using detail::convolution::createConvolutionPrePackOpContext;
 using detail::linear::createLinearPrePackOpContext;
 using detail::mkl_sgemm::createLinearMKLPrePackOpContext;
+using detail::sparse_linear::createSparseLinearPrePackOpContext;
 #ifdef USE_LIBXSMM
 using detail::woq_linear::createWoqLinearPrePackOpContext;
 using detail::woq_linear::createWoqLinearPrePackOpContextInt4;
@@ -49,7 +52,13 @@ TORCH_LIBRARY(ipex_prepack, m) {
           &torch_ipex::cpu::ConvolutionOpContext::get_data_handle)
       .def(
           "load_from_ctx",
-          &torch_ipex::cpu::ConvolutionOpContext::load_from_ctx);
+          &torch_ipex::cpu::ConvolutionOpContext::load_from_ctx)
+      .def(
+          "get_primitive_cache_size",
+          &torch_ipex::cpu::ConvolutionOpContext::get_primitive_cache_size)
+      .def(
+          "clear_primitive_cache",
+          &torch_ipex::cpu::ConvolutionOpContext::clear_primitive_cache);
   m.class_<LinearOpContext>("LinearOpContext")
       .def_pickle(
           [](const c10::intrusive_ptr<LinearOpContext>& op_context)
@@ -70,7 +79,13 @@ TORCH_LIBRARY(ipex_prepack, m) {
       .def("to_public", &torch_ipex::cpu::LinearOpContext::to_public)
       .def(
           "get_data_handle", &torch_ipex::cpu::LinearOpContext::get_data_handle)
-      .def("load_from_ctx", &torch_ipex::cpu::LinearOpContext::load_from_ctx);
+      .def("load_from_ctx", &torch_ipex::cpu::LinearOpContext::load_from_ctx)
+      .def(
+          "get_primitive_cache_stats",
+          &torch_ipex::cpu::LinearOpContext::get_primitive_cache_stats)
+      .def(
+          "clear_primitive_cache",
+          &torch_ipex::cpu::LinearOpContext::clear_primitive_cache);
   m.class_<MKLOpContext>("MKLOpContext")
       .def_pickle(
           [](const c10::intrusive_ptr<MKLOpContext>& op_context)
@@ -90,6 +105,27 @@ TORCH_LIBRARY(ipex_prepack, m) {
       .def("to_public", &torch_ipex::cpu::MKLOpContext::to_public)
       .def("get_data_handle", &torch_ipex::cpu::MKLOpContext::get_data_handle)
       .def("load_from_ctx", &torch_ipex::cpu::MKLOpContext::load_from_ctx);
+  m.class_<SparseLinearOpContext>("SparseLinearOpContext")
+      .def_pickle(
+          [](const c10::intrusive_ptr<SparseLinearOpContext>& op_context)
+              -> SerializationTypeSparseLinearPrePack { // __getstate__
+            return op_context->unpack();
+          },
+          [](SerializationTypeSparseLinearPrePack state)
+              -> c10::intrusive_ptr<SparseLinearOpContext> { // __setstate__
+            return createSparseLinearPrePackOpContext(
+                std::move(std::get<0>(state)),
+                std::move(std::get<1>(state)),
+                std::move(std::get<2>(state)));
+          })
+      .def(
+          "get_weight",
+          &torch_ipex::cpu::SparseLinearOpContext::get_at_packed_weight)
+      .def("get_bias", &torch_ipex::cpu::SparseLinearOpContext::get_at_bias)
+      .def("to_public", &torch_ipex::cpu::SparseLinearOpContext::to_public)
+      .def(
+          "get_data_handle",
+          &torch_ipex::cpu::SparseLinearOpContext::get_data_handle);
   m.class_<ConvTransposeOpContext>("ConvTransposeOpContext")
       .def_pickle(
           [](const c10::intrusive_ptr<ConvTransposeOpContext>& op_context)
@@ -150,6 +186,10 @@ TORCH_LIBRARY(ipex_prepack, m) {
       .def(
           "load_from_ctx", &torch_ipex::cpu::WoqLinearOpContext::load_from_ctx);
 #endif
+  m.class_<MemoryPlan>("MemoryPlan")
+      .def("get_arena_size", &torch_ipex::cpu::MemoryPlan::get_arena_size)
+      .def("get_num_slots", &torch_ipex::cpu::MemoryPlan::get_num_slots)
+      .def("get_num_arenas", &torch_ipex::cpu::MemoryPlan::get_num_arenas);
   m.def(
       "convolution_prepack(Tensor W, Tensor? B, int[] stride, "
       "int[] padding, int[] dilation, int groups, "
@@ -161,6 +201,9 @@ TORCH_LIBRARY(ipex_prepack, m) {
   m.def(
       "mkl_sgemm_prepack(Tensor W, Tensor? B, int? batch_size) "
       "-> __torch__.torch.classes.ipex_prepack.MKLOpContext");
+  m.def(
+      "sparse_linear_prepack(Tensor W, Tensor? B, str format) "
+      "-> __torch__.torch.classes.ipex_prepack.SparseLinearOpContext");
   m.def(
       "conv_transpose_prepack(Tensor W, Tensor? B, int[] stride, "
       "int[] padding, int[] output_padding, int groups, int[] dilation, "
@@ -180,6 +223,8 @@ TORCH_LIBRARY_IMPL(ipex_prepack, CPU, m) {
   m.impl("convolution_prepack", TORCH_FN(createConvolutionPrePackOpContext));
   m.impl("linear_prepack", TORCH_FN(createLinearPrePackOpContext));
   m.impl("mkl_sgemm_prepack", TORCH_FN(createLinearMKLPrePackOpContext));
+  m.impl(
+      "sparse_linear_prepack", TORCH_FN(createSparseLinearPrePackOpContext));
   m.impl(
       "conv_transpose_prepack", TORCH_FN(createConvTransposePrePackOpContext));
 }
@@ -0,0 +1,90 @@
+#include "SparseLinearPacked.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+namespace sparse_linear {
+
+c10::intrusive_ptr<SparseLinearOpContext> createSparseLinearPrePackOpContext(
+    at::Tensor&& weight,
+    c10::optional<at::Tensor>&& bias,
+    std::string format) {
+  RECORD_FUNCTION(
+      "ipex_prepack::createSparseLinearPrePackOpContext",
+      c10::ArrayRef<c10::IValue>({}));
+
+  return IpexSparseLinearOpContext::create_context(
+      std::move(weight), std::move(bias), format);
+}
+
+at::Tensor sparse_linear_run(
+    const at::Tensor& input,
+    c10::intrusive_ptr<SparseLinearOpContext> op_context) {
+  RECORD_FUNCTION(
+      "ipex_prepack::sparse_linear_run", c10::ArrayRef<c10::IValue>({}));
+
+  return op_context->run(input);
+}
+
+ContextLinearSparse create(
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    const std::string& format) {
+  auto sparse_format = sparse_linear_format_from_string(format);
+  auto packed = sparse_linear_pack(weight, sparse_format);
+  auto out_features = weight.size(0);
+  auto in_features = weight.size(1);
+  // the kernels add the bias in float to the accumulators of whole output
+  // blocks
+  at::Tensor padded_bias;
+  if (bias.has_value() && bias->defined()) {
+    TORCH_CHECK(
+        bias->dim() == 1 && bias->size(0) == out_features,
+        "sparse_linear: expected a bias of ",
+        out_features,
+        " elements");
+    padded_bias = at::zeros(
+        {at::divup(out_features, SPARSE_BLOCK_N) * SPARSE_BLOCK_N},
+        at::kFloat);
+    padded_bias.narrow(0, 0, out_features).copy_(*bias);
+  }
+  return ContextLinearSparse{
+      sparse_format,
+      out_features,
+      in_features,
+      std::move(packed[0]),
+      std::move(packed[1]),
+      std::move(packed[2]),
+      std::move(padded_bias),
+      bias.has_value() ? c10::make_optional(*bias) : c10::nullopt,
+  };
+}
+
+at::Tensor run(ContextLinearSparse& context, const at::Tensor& input) {
+  TORCH_CHECK(
+      input.dim() >= 1 && input.size(-1) == context.in_features_,
+      "Check the shapes of mat1 and mat2, they cannot be multiplied!");
+  return sparse_linear_forward(
+      input,
+      context.format_,
+      context.values_,
+      context.indices_,
+      context.row_ptr_,
+      context.bias_,
+      context.out_features_);
+}
+
+at::Tensor unpack(ContextLinearSparse& context) {
+  return sparse_linear_unpack(
+      context.format_,
+      context.values_,
+      context.indices_,
+      context.row_ptr_,
+      context.out_features_,
+      context.in_features_);
+}
+
+} // namespace sparse_linear
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
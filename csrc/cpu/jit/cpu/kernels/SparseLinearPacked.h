@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include "ContextLinearSparse.h"
+#include "OpContext.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+namespace sparse_linear {
+
+c10::intrusive_ptr<SparseLinearOpContext> createSparseLinearPrePackOpContext(
+    at::Tensor&& weight,
+    c10::optional<at::Tensor>&& bias,
+    std::string format);
+
+at::Tensor sparse_linear_run(
+    const at::Tensor& input,
+    c10::intrusive_ptr<SparseLinearOpContext> op_context);
+
+ContextLinearSparse create(
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    const std::string& format);
+
+at::Tensor run(ContextLinearSparse& context, const at::Tensor& input);
+
+// The dense weight of the packed one
+at::Tensor unpack(ContextLinearSparse& context);
+
+} // namespace sparse_linear
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
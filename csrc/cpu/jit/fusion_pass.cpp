@@ -8,6 +8,7 @@
 #include "passes/frozen_linear_folding.h"
 #include "passes/graph_rewrite.h"
 #include "passes/graph_rewrite_helper.h"
+#include "passes/memory_planning.h"
 #include "passes/prepack_folding.h"
 #include "passes/qpadding.h"
 #include "passes/remove_redundant_aliases.h"
@@ -141,6 +142,8 @@ void IPEXFusionPass(std::shared_ptr<Graph>& graph) {
   torch_ipex::jit::FrozenConcatLinear(
       graph, aten_linear_recorder.get_records());
   graph_rewrite::FrozenLinearFolding(graph);
+  // the frozen sparse linears, before the dense ones are prepacked
+  graph_rewrite::insertPrePackedSparseLinearOp(graph);
 
   // linear fusion
   GRAPH_DUMP("After FrozenLinearFolding.Before insertPrePackedLinearOp", graph);
@@ -203,6 +206,9 @@ void IPEXFusionPass(std::shared_ptr<Graph>& graph) {
   // This path should be executed after all the other Matmul-related
   // fusion are completed to prevent mismatching "aten::matmul".
   graph_rewrite::FusedTransFreeMha(graph);
+  // Fuse the split and the head transpose of Q/K/V into the concatenated
+  // linear, after the flash MHA fusions in FusedTransFreeMha.
+  graph_rewrite::FuseLinearQKVSplitHeads(graph);
 
   ConstantPropagation(graph);
   GRAPH_DUMP("Before PrePackingOpsFolder", graph);
@@ -309,6 +315,12 @@ void FusionPass(std::shared_ptr<Graph>& graph) {
   // Note: Since TE is with priority and it has not supported inplace op yet,
   //       we make inplace optimization after TE.
   ApplyInplaceOptimization(graph);
+  // Plan after the inplace optimization which changes the aliases, and
+  // before the profiled shapes are removed.
+  if (AutoOptConfig::singleton().get_jit_memory_planning()) {
+    PlanStaticMemory(graph);
+    GRAPH_DUMP("After PlanStaticMemory", graph);
+  }
   RemoveTensorTypeSpecializations(graph);
   GRAPH_DUMP(
       "After RemoveTensorTypeSpecializations. End of optimization pass", graph);
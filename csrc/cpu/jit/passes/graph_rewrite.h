@@ -59,6 +59,7 @@ void insertPrePackedLinearOp(
     std::shared_ptr<torch::jit::Graph>& graph,
     std::unordered_set<torch::jit::Node*>& aten_linear,
     const bool& use_mkl_sgemm);
+void insertPrePackedSparseLinearOp(std::shared_ptr<torch::jit::Graph>& graph);
 void fuseLinearWithEltwise(std::shared_ptr<torch::jit::Graph>& graph);
 void fuseLinearAddRelu(std::shared_ptr<torch::jit::Graph>& graph);
 void fuseLinearMulAdd(std::shared_ptr<torch::jit::Graph>& graph);
@@ -75,6 +76,7 @@ void fuseConvTransposeAdd(std::shared_ptr<torch::jit::Graph>& graph);
 void FusedEinsumPost(std::shared_ptr<torch::jit::Graph>& graph);
 
 void FusedTransFreeMha(std::shared_ptr<torch::jit::Graph>& graph);
+void FuseLinearQKVSplitHeads(std::shared_ptr<torch::jit::Graph>& graph);
 void FusePythonGELUWithAten(std::shared_ptr<torch::jit::Graph>& graph);
 } // namespace graph_rewrite
 } // namespace jit
@@ -2,6 +2,7 @@
 #include <ideep.hpp>
 #include "passes/utils.h"
 
+#include "aten/SparseLinear.h"
 #include "auto_opt_config.h"
 #include "graph_rewrite.h"
 #include "graph_rewrite_helper.h"
@@ -226,6 +227,69 @@ void insertPrePackedLinearOp(
   insertPrePackedLinearOp(graph->block(), aten_linear, use_mkl_sgemm);
 }
 
+// Replaces the aten linear with the sparse prepacked linear when its frozen
+// weight has enough blocks of zeros for the block format, or is 2:4 sparse.
+void replaceAtenLinearWithSparsePrepackNode(Node* n, double threshold) {
+  auto weight = constant_as<at::Tensor>(n->inputs().at(1));
+  if (!weight.has_value() || weight->dim() != 2 ||
+      !(weight->scalar_type() == at::kFloat ||
+        weight->scalar_type() == at::kBFloat16)) {
+    return;
+  }
+  auto bias = n->inputs().at(2);
+  if (!bias->type()->isSubtypeOf(*NoneType::get()) &&
+      !constant_as<at::Tensor>(bias).has_value()) {
+    return;
+  }
+  std::string format;
+  if (get_block_sparsity(*weight) >= threshold) {
+    format = "block";
+  } else if (is_two_four_sparse(*weight)) {
+    format = "2:4";
+  } else {
+    return;
+  }
+
+  WithInsertPoint guard(n);
+  auto graph = n->owningGraph();
+  auto format_value = graph->insertConstant(IValue(format));
+  auto prepack_node = graph->create(
+      Symbol::fromQualString("ipex_prepack::sparse_linear_prepack"), 1);
+  prepack_node->addInput(n->inputs().at(1));
+  prepack_node->addInput(bias);
+  prepack_node->addInput(format_value);
+  prepack_node->output()->setType(getCustomClass(
+      "__torch__.torch.classes.ipex_prepack.SparseLinearOpContext"));
+  graph->insertNode(prepack_node);
+  auto sparse_linear = graph->insertNode(graph->create(
+      Symbol::fromQualString("ipex_prepack::sparse_linear_run"), 1));
+  sparse_linear->addInput(n->inputs().at(0));
+  sparse_linear->addInput(prepack_node->output());
+  sparse_linear->output()->setType(n->output()->type()->cast<TensorType>());
+  n->output()->replaceAllUsesWith(sparse_linear->output());
+}
+
+void insertPrePackedSparseLinearOp(Block* b, double threshold) {
+  for (Node* n : b->nodes()) {
+    for (Block* block : n->blocks()) {
+      insertPrePackedSparseLinearOp(block, threshold);
+    }
+    if (n->kind() == aten::linear) {
+      replaceAtenLinearWithSparsePrepackNode(n, threshold);
+    }
+  }
+  EliminateDeadCode(b);
+}
+
+void insertPrePackedSparseLinearOp(std::shared_ptr<Graph>& graph) {
+  double threshold =
+      AutoOptConfig::singleton().get_jit_sparse_linear_threshold();
+  if (threshold <= 0) {
+    return;
+  }
+  insertPrePackedSparseLinearOp(graph->block(), threshold);
+}
+
 void RecordAtenLinearNodes(
     Block* b,
     std::unordered_set<Node*>& aten_linear,
@@ -293,6 +293,129 @@ auto split_replace_filter =
       return true;
     };
 
+auto linear_qkv_split_heads_filter =
+    [](const Match& match,
+       const std::unordered_map<std::string, Value*>& vmap) {
+      const auto& match_vmap = match.values_map;
+      auto split_idx = toIValue(graph_rewrite_helper::getValue(
+          "split_idx", match_vmap, vmap));
+      auto permute_sizes = toIValue(
+          graph_rewrite_helper::getValue("permute", match_vmap, vmap));
+      auto zero =
+          toIValue(graph_rewrite_helper::getValue("zero", match_vmap, vmap));
+      auto one =
+          toIValue(graph_rewrite_helper::getValue("one", match_vmap, vmap));
+      auto num_head = toIValue(
+          graph_rewrite_helper::getValue("num_head", match_vmap, vmap));
+      auto head_dim = toIValue(
+          graph_rewrite_helper::getValue("head_dim", match_vmap, vmap));
+      if (!split_idx.has_value() || !permute_sizes.has_value() ||
+          !zero.has_value() || !one.has_value() || !num_head.has_value() ||
+          !head_dim.has_value()) {
+        return false;
+      }
+      std::vector<int64_t> permute_ref = {0, 2, 1, 3};
+      if (permute_sizes->toIntVector() != permute_ref || zero->toInt() != 0 ||
+          one->toInt() != 1) {
+        return false;
+      }
+      // the query, key and value are viewed with the same head size
+      auto split_list = split_idx->toIntVector();
+      if (split_list.size() != 3) {
+        return false;
+      }
+      for (auto split : split_list) {
+        if (split != num_head->toInt() * head_dim->toInt()) {
+          return false;
+        }
+      }
+      // the split is on the last dim of the [bs, seq, hidden_size] output
+      auto qkv = graph_rewrite_helper::getValue("qkv", match_vmap, vmap)
+                     ->type()
+                     ->cast<TensorType>();
+      if (qkv && qkv->dim().has_value() && qkv->dim().value() != 3) {
+        return false;
+      }
+      if (vmap.count("split_dim")) {
+        auto split_dim = toIValue(
+            graph_rewrite_helper::getValue("split_dim", match_vmap, vmap));
+        if (!split_dim.has_value() ||
+            (split_dim->toInt() != -1 && split_dim->toInt() != 2)) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+// The concatenated query/key/value linear of BERT-like attentions is followed
+// by a split of its output and a view + permute of each part into
+// [bs, num_head, seq, head_size]. The split (a copy for BF16) and the
+// permuted views make the later bmm copy the tensors again, so the whole
+// chain is replaced by one op writing the three head-major contiguous tensors
+// right after the GEMM. It runs after FusedTransFreeMha so that the fully
+// fused flash MHA still takes the BF16 BERT pattern first.
+void FuseLinearQKVSplitHeads(std::shared_ptr<Graph>& graph) {
+  std::string qkv_graph = R"(
+      graph(%input: Tensor, %ctx, %split_idx: int[], %split_dim: int, %zero: int, %one: int, %num_head: int, %head_dim: int, %permute: int[]): )";
+
+  std::string qkv_graph_no_dim = R"(
+      graph(%input: Tensor, %ctx, %split_idx: int[], %zero: int, %one: int, %num_head: int, %head_dim: int, %permute: int[]): )";
+
+  std::string linear_qkv = R"(
+        %qkv = ipex_prepack::linear_run(%input, %ctx) )";
+
+  std::string mkl_sgemm_qkv = R"(
+        %qkv = ipex_prepack::mkl_sgemm_run(%input, %ctx) )";
+
+  std::string aten_split = R"(
+        %qkv_list = aten::split_with_sizes(%qkv, %split_idx, %split_dim)
+        %query, %key, %value = prim::ListUnpack(%qkv_list) )";
+
+  std::string ipex_split = R"(
+        %qkv_list = ipex::split_tensor(%qkv, %split_idx)
+        %query, %key, %value = prim::ListUnpack(%qkv_list) )";
+
+  std::string split_heads = R"(
+        %query_size1 = aten::size(%query, %zero)
+        %query_size2 = aten::size(%query, %one)
+        %query_size = prim::ListConstruct(%query_size1, %query_size2, %num_head, %head_dim)
+        %query_1 = aten::view(%query, %query_size)
+        %query_layer = aten::permute(%query_1, %permute)
+        %key_size1 = aten::size(%key, %zero)
+        %key_size2 = aten::size(%key, %one)
+        %key_size = prim::ListConstruct(%key_size1, %key_size2, %num_head, %head_dim)
+        %key_1 = aten::view(%key, %key_size)
+        %key_layer = aten::permute(%key_1, %permute)
+        %value_size1 = aten::size(%value, %zero)
+        %value_size2 = aten::size(%value, %one)
+        %value_size = prim::ListConstruct(%value_size1, %value_size2, %num_head, %head_dim)
+        %value_1 = aten::view(%value, %value_size)
+        %value_layer = aten::permute(%value_1, %permute)
+        return (%query_layer, %key_layer, %value_layer) )";
+
+  std::string fused_linear_qkv = R"(
+        %qkv_list = ipex_prepack::linear_qkv_run(%input, %split_idx, %num_head, %ctx)
+        %query_layer, %key_layer, %value_layer = prim::ListUnpack(%qkv_list)
+        return (%query_layer, %key_layer, %value_layer) )";
+
+  std::string fused_mkl_sgemm_qkv = R"(
+        %qkv_list = ipex_prepack::mkl_sgemm_qkv_run(%input, %split_idx, %num_head, %ctx)
+        %query_layer, %key_layer, %value_layer = prim::ListUnpack(%qkv_list)
+        return (%query_layer, %key_layer, %value_layer) )";
+
+  SubgraphRewriter qkv_fusion;
+  qkv_fusion.RegisterRewritePattern(
+      qkv_graph + linear_qkv + aten_split + split_heads,
+      qkv_graph + fused_linear_qkv);
+  qkv_fusion.RegisterRewritePattern(
+      qkv_graph_no_dim + linear_qkv + ipex_split + split_heads,
+      qkv_graph_no_dim + fused_linear_qkv);
+  qkv_fusion.RegisterRewritePattern(
+      qkv_graph + mkl_sgemm_qkv + aten_split + split_heads,
+      qkv_graph + fused_mkl_sgemm_qkv);
+  qkv_fusion.runOnGraph(graph, linear_qkv_split_heads_filter);
+}
+
 // aten::matmul - always applies contiguous to the input tensors
 // ipex::matmul - allows non-contiguous input tensors with the conditions:
 // 1. tensor1.dim1 == tensor2.dim2
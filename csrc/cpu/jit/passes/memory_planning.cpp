@@ -0,0 +1,289 @@
+#include "memory_planning.h"
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+#include "cpu/kernels/MemoryPlan.h"
+
+#include <algorithm>
+
+namespace torch_ipex {
+namespace jit {
+
+using namespace torch::jit;
+using torch_ipex::cpu::MemoryPlan;
+
+namespace {
+
+constexpr int64_t kArenaAlignment = 64;
+
+struct PlannedOp {
+  Symbol planned_kind;
+  std::string post_op;
+  bool is_convolution;
+  // the MKL sgemm writes the rows of the output contiguously
+  bool needs_contiguous_output;
+};
+
+// prepacked run ops -> (planned op, post-op name)
+const std::unordered_map<Symbol, PlannedOp>& get_plannable_ops() {
+  static const auto plannable_ops = []() {
+    std::unordered_map<Symbol, PlannedOp> ops;
+    const std::vector<std::string> post_ops = {
+        "",
+        "relu",
+        "sigmoid",
+        "swish",
+        "tanh",
+        "mish",
+        "abs",
+        "exp",
+        "hardswish",
+        "square",
+        "log",
+        "round",
+        "sqrt",
+        "hardsigmoid"};
+    auto linear_planned =
+        Symbol::fromQualString("ipex_prepack::linear_planned_run");
+    auto conv_planned =
+        Symbol::fromQualString("ipex_prepack::convolution_planned_run");
+    for (const auto& post_op : post_ops) {
+      auto run = post_op.empty() ? "run" : post_op + "_run";
+      ops.emplace(
+          Symbol::fromQualString("ipex_prepack::linear_" + run),
+          PlannedOp{linear_planned, post_op, false, false});
+      ops.emplace(
+          Symbol::fromQualString("ipex_prepack::convolution_" + run),
+          PlannedOp{conv_planned, post_op, true, false});
+    }
+    // the default fp32 linear of ipex.optimize, which has no fused post-op
+    ops.emplace(
+        Symbol::fromQualString("ipex_prepack::mkl_sgemm_run"),
+        PlannedOp{
+            Symbol::fromQualString("ipex_prepack::mkl_sgemm_planned_run"),
+            "",
+            false,
+            true});
+    return ops;
+  }();
+  return plannable_ops;
+}
+
+struct PlannedValue {
+  Node* node;
+  MemoryPlan::Slot slot;
+  Symbol planned_kind;
+  int64_t nbytes;
+  // index of the defining node and of the last top-level node using the
+  // value or any of its aliases, both inclusive
+  int64_t begin;
+  int64_t end;
+};
+
+int64_t align_up(int64_t nbytes) {
+  return (nbytes + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+}
+
+// Sizes, strides and dtype of a profiled CPU tensor, false if any is unknown
+// or the tensor is empty.
+bool get_profiled_layout(
+    const Value* value,
+    std::vector<int64_t>& sizes,
+    std::vector<int64_t>& strides,
+    c10::ScalarType& dtype) {
+  auto type = value->type()->cast<TensorType>();
+  if (!type || !type->device() || !type->device()->is_cpu() ||
+      !type->scalarType()) {
+    return false;
+  }
+  auto concrete_sizes = type->sizes().concrete_sizes();
+  auto concrete_strides = type->strides().concrete_sizes();
+  if (!concrete_sizes || !concrete_strides) {
+    return false;
+  }
+  sizes = *concrete_sizes;
+  strides = *concrete_strides;
+  dtype = *type->scalarType();
+  return std::all_of(
+      sizes.begin(), sizes.end(), [](int64_t size) { return size > 0; });
+}
+
+bool is_contiguous(
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides) {
+  int64_t expected = 1;
+  for (int64_t i = sizes.size() - 1; i >= 0; i--) {
+    if (sizes[i] != 1 && strides[i] != expected) {
+      return false;
+    }
+    expected *= sizes[i];
+  }
+  return true;
+}
+
+int64_t get_storage_nbytes(
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides,
+    c10::ScalarType dtype) {
+  int64_t numel = 1;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    numel += (sizes[i] - 1) * strides[i];
+  }
+  return numel * c10::elementSize(dtype);
+}
+
+// Values read by the node, including the ones read inside its blocks.
+void collect_used_values(Node* node, std::vector<Value*>& values) {
+  values.insert(values.end(), node->inputs().begin(), node->inputs().end());
+  for (Block* block : node->blocks()) {
+    for (Node* inner : block->nodes()) {
+      collect_used_values(inner, values);
+    }
+    values.insert(
+        values.end(), block->outputs().begin(), block->outputs().end());
+  }
+}
+
+// First fit of the values by decreasing size: each value takes the lowest
+// offset not overlapping the values placed before it whose lifetimes
+// intersect its own. Returns the arena size.
+int64_t assign_offsets(std::vector<PlannedValue>& values) {
+  std::vector<PlannedValue*> order;
+  for (auto& value : values) {
+    order.push_back(&value);
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [](PlannedValue* a, PlannedValue* b) {
+        return a->nbytes > b->nbytes;
+      });
+
+  int64_t arena_size = 0;
+  std::vector<PlannedValue*> placed;
+  for (auto value : order) {
+    std::vector<PlannedValue*> live;
+    for (auto other : placed) {
+      if (other->begin <= value->end && value->begin <= other->end) {
+        live.push_back(other);
+      }
+    }
+    std::sort(live.begin(), live.end(), [](PlannedValue* a, PlannedValue* b) {
+      return a->slot.offset_ < b->slot.offset_;
+    });
+    int64_t offset = 0;
+    for (auto other : live) {
+      if (offset + value->nbytes <= other->slot.offset_) {
+        break;
+      }
+      offset = std::max(offset, align_up(other->slot.offset_ + other->nbytes));
+    }
+    value->slot.offset_ = offset;
+    arena_size = std::max(arena_size, align_up(offset + value->nbytes));
+    placed.push_back(value);
+  }
+  return arena_size;
+}
+
+} // namespace
+
+void PlanStaticMemory(std::shared_ptr<Graph>& graph) {
+  const auto& plannable_ops = get_plannable_ops();
+  AliasDb aliasDb(graph);
+
+  std::vector<Node*> nodes(
+      graph->block()->nodes().begin(), graph->block()->nodes().end());
+  std::vector<PlannedValue> values;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    Node* node = nodes[i];
+    auto it = plannable_ops.find(node->kind());
+    if (it == plannable_ops.end()) {
+      continue;
+    }
+    Value* output = node->output();
+    // the planned output is overwritten by the next run of the graph
+    if (aliasDb.escapesScope({output})) {
+      continue;
+    }
+    MemoryPlan::Slot slot;
+    if (!get_profiled_layout(
+            node->input(0),
+            slot.input_sizes_,
+            slot.input_strides_,
+            slot.input_dtype_) ||
+        !get_profiled_layout(
+            output,
+            slot.output_sizes_,
+            slot.output_strides_,
+            slot.output_dtype_)) {
+      continue;
+    }
+    // conv1d goes through the channels last 1d conversion of the output
+    if (it->second.is_convolution && slot.input_sizes_.size() != 4 &&
+        slot.input_sizes_.size() != 5) {
+      continue;
+    }
+    if (it->second.needs_contiguous_output &&
+        !is_contiguous(slot.output_sizes_, slot.output_strides_)) {
+      continue;
+    }
+    slot.offset_ = 0;
+    slot.post_op_ = it->second.post_op;
+
+    PlannedValue value;
+    value.node = node;
+    value.planned_kind = it->second.planned_kind;
+    value.nbytes = get_storage_nbytes(
+        slot.output_sizes_, slot.output_strides_, slot.output_dtype_);
+    value.slot = std::move(slot);
+    value.begin = i;
+    value.end = i;
+    for (size_t j = i + 1; j < nodes.size(); j++) {
+      std::vector<Value*> used;
+      collect_used_values(nodes[j], used);
+      if (aliasDb.mayContainAlias(used, {output})) {
+        value.end = j;
+      }
+    }
+    values.push_back(std::move(value));
+  }
+  if (values.empty()) {
+    return;
+  }
+
+  int64_t arena_size = assign_offsets(values);
+  GRAPH_DEBUG(
+      "PlanStaticMemory: ",
+      values.size(),
+      " planned outputs in an arena of ",
+      arena_size,
+      " bytes");
+
+  std::vector<MemoryPlan::Slot> slots;
+  for (const auto& value : values) {
+    slots.push_back(value.slot);
+  }
+  auto plan = c10::make_intrusive<MemoryPlan>(arena_size, std::move(slots));
+  auto plan_type = c10::getCustomClassType<c10::intrusive_ptr<MemoryPlan>>();
+  Value* plan_value = nullptr;
+  {
+    WithInsertPoint guard(graph->block()->nodes().front());
+    // the plan is not owning the compilation unit, see PrePackingOpsFolder
+    auto weak_class_obj =
+        IValue(plan).toObject()->copy_to_weak_compilation_ref();
+    plan_value = graph->insertConstant(weak_class_obj)->setType(plan_type);
+  }
+
+  for (size_t i = 0; i < values.size(); i++) {
+    Node* node = values[i].node;
+    WithInsertPoint guard(node);
+    Value* slot = graph->insertConstant(static_cast<int64_t>(i));
+    Node* planned = graph->insertNode(graph->create(
+        values[i].planned_kind,
+        {node->input(0), slot, plan_value, node->input(1)}));
+    planned->output()->setType(node->output()->type());
+    node->output()->replaceAllUsesWith(planned->output());
+    node->destroy();
+  }
+}
+
+} // namespace jit
+} // namespace torch_ipex
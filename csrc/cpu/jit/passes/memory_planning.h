@@ -0,0 +1,16 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch_ipex {
+namespace jit {
+
+// Assign the outputs of the prepacked linear and convolution of the top-level
+// block to fixed offsets of one arena, from their lifetimes and the shapes
+// profiled on the graph, and replace the ops with their planned variants
+// writing into the arena. Needs the specialized tensor types, so it runs
+// before RemoveTensorTypeSpecializations.
+void PlanStaticMemory(std::shared_ptr<torch::jit::Graph>& graph);
+
+} // namespace jit
+} // namespace torch_ipex
@@ -17,12 +17,14 @@
 #include "cpu/kernels/LinearSwishCustomized.h"
 #include "cpu/kernels/Matmul.h"
 #include "cpu/kernels/MaxPool2D.h"
+#include "cpu/kernels/MemoryPlan.h"
 #include "cpu/kernels/Mha.h"
 #include "cpu/kernels/OpContext.h"
 #include "cpu/kernels/QCircularPad.h"
 #include "cpu/kernels/RNN.h"
 #include "cpu/kernels/Shuffle.h"
 #include "cpu/kernels/Softmax.h"
+#include "cpu/kernels/SparseLinearPacked.h"
 #include "ideep/IDeepConversions.h"
 namespace torch_ipex {
 namespace jit {
@@ -33,6 +35,7 @@ using namespace torch_ipex::cpu::detail::convolution;
 using namespace torch_ipex::cpu::detail::linear;
 using namespace torch_ipex::cpu::detail::conv_transpose;
 using namespace torch_ipex::cpu::detail::mkl_sgemm;
+using namespace torch_ipex::cpu::detail::memory_plan;
 
 c10::AliasAnalysisKind aliasAnalysisFromSchema() {
   return c10::AliasAnalysisKind::FROM_SCHEMA;
@@ -697,6 +700,115 @@ torch::jit::RegisterOperators op({
           };
         },
         aliasAnalysisFromSchema()),
+    Operator(
+        "ipex_prepack::sparse_linear_run(Tensor input, "
+        "__torch__.torch.classes.ipex_prepack.SparseLinearOpContext "
+        "W_prepack) -> Tensor",
+        [](const Node* node) -> Operation {
+          return [](Stack* stack) {
+            auto result = detail::sparse_linear::sparse_linear_run(
+                (std::move(peek(stack, 0, 2))).toTensor(),
+                (std::move(peek(stack, 1, 2)))
+                    .toCustomClass<SparseLinearOpContext>());
+            drop(stack, 2);
+            torch::jit::pack(stack, std::move(result));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
+    Operator(
+        "ipex_prepack::linear_qkv_run(Tensor input, int[] split_list, int num_head, "
+        "__torch__.torch.classes.ipex_prepack.LinearOpContext W_prepack) "
+        "-> Tensor[]",
+        [](const Node* node) -> Operation {
+          return [](Stack* stack) {
+            auto result = linear_qkv_run(
+                (std::move(peek(stack, 0, 4))).toTensor(),
+                (std::move(peek(stack, 1, 4))).toIntVector(),
+                (std::move(peek(stack, 2, 4))).toInt(),
+                (std::move(peek(stack, 3, 4)))
+                    .toCustomClass<LinearOpContext>());
+            drop(stack, 4);
+            torch::jit::pack(stack, std::move(result));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
+    Operator(
+        "ipex_prepack::mkl_sgemm_qkv_run(Tensor input, int[] split_list, int num_head, "
+        "__torch__.torch.classes.ipex_prepack.MKLOpContext W_prepack) "
+        "-> Tensor[]",
+        [](const Node* node) -> Operation {
+          return [](Stack* stack) {
+            auto result = mkl_sgemm_qkv_run(
+                (std::move(peek(stack, 0, 4))).toTensor(),
+                (std::move(peek(stack, 1, 4))).toIntVector(),
+                (std::move(peek(stack, 2, 4))).toInt(),
+                (std::move(peek(stack, 3, 4))).toCustomClass<MKLOpContext>());
+            drop(stack, 4);
+            torch::jit::pack(stack, std::move(result));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
+
+    // Prepacked ops writing into the arena of a MemoryPlan
+    Operator(
+        "ipex_prepack::linear_planned_run(Tensor input, int slot, "
+        "__torch__.torch.classes.ipex_prepack.MemoryPlan plan, "
+        "__torch__.torch.classes.ipex_prepack.LinearOpContext W_prepack) "
+        "-> Tensor",
+        [](const Node* node) -> Operation {
+          return [](Stack* stack) {
+            auto result = linear_planned_run(
+                (std::move(peek(stack, 0, 4))).toTensor(),
+                (std::move(peek(stack, 1, 4))).toInt(),
+                (std::move(peek(stack, 2, 4))).toCustomClass<MemoryPlan>(),
+                (std::move(peek(stack, 3, 4)))
+                    .toCustomClass<LinearOpContext>());
+            drop(stack, 4);
+            torch::jit::pack(stack, std::move(result));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
+    Operator(
+        "ipex_prepack::convolution_planned_run(Tensor input, int slot, "
+        "__torch__.torch.classes.ipex_prepack.MemoryPlan plan, "
+        "__torch__.torch.classes.ipex_prepack.ConvolutionOpContext "
+        "W_prepack) -> Tensor",
+        [](const Node* node) -> Operation {
+          return [](Stack* stack) {
+            auto result = convolution_planned_run(
+                (std::move(peek(stack, 0, 4))).toTensor(),
+                (std::move(peek(stack, 1, 4))).toInt(),
+                (std::move(peek(stack, 2, 4))).toCustomClass<MemoryPlan>(),
+                (std::move(peek(stack, 3, 4)))
+                    .toCustomClass<ConvolutionOpContext>());
+            drop(stack, 4);
+            torch::jit::pack(stack, std::move(result));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
+    Operator(
+        "ipex_prepack::mkl_sgemm_planned_run(Tensor input, int slot, "
+        "__torch__.torch.classes.ipex_prepack.MemoryPlan plan, "
+        "__torch__.torch.classes.ipex_prepack.MKLOpContext W_prepack) "
+        "-> Tensor",
+        [](const Node* node) -> Operation {
+          return [](Stack* stack) {
+            auto result = mkl_sgemm_planned_run(
+                (std::move(peek(stack, 0, 4))).toTensor(),
+                (std::move(peek(stack, 1, 4))).toInt(),
+                (std::move(peek(stack, 2, 4))).toCustomClass<MemoryPlan>(),
+                (std::move(peek(stack, 3, 4))).toCustomClass<MKLOpContext>());
+            drop(stack, 4);
+            torch::jit::pack(stack, std::move(result));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
 
     // ConvTranspose fusion run OP
     CreateConvTransposeUnaryPostOpRun(run),
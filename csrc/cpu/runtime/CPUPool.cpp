@@ -1,9 +1,12 @@
 #include "CPUPool.h"
+#include "CPUTopology.h"
 
 #ifdef _WIN32
 #include <Windows.h>
 #else
 #include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 #endif
 
@@ -26,11 +29,25 @@ std::once_flag
     iomp_symbol_loading_call_once_flag; // call_once_flag to ensure the iomp
                                         // symbol loaded once globally
 std::atomic<bool> iomp_symbol_loaded{false};
+std::atomic<RuntimeExtBackend> runtime_ext_backend{RuntimeExtBackend::NONE};
 
 // current_cpu_core_list is only used to cache the cpu_core_list setting
 // of _pin_cpu_cores. It's thread_local, so different task thread can have
 // different settings to support task API.
 thread_local std::vector<int32_t> current_cpu_core_list{-1};
+
+// Numa node the thread memory was bound to by _pin_cpu_cores, -1 means the
+// runtime didn't touch the memory policy of this thread. Only reset the
+// policy when we set it, to keep the external numactl --membind setting.
+thread_local int32_t current_memory_numa_node{-1};
+
+void update_thread_memory_binding(int32_t numa_node_id) {
+  if (numa_node_id < 0 && current_memory_numa_node < 0) {
+    return;
+  }
+  bind_thread_memory_to_numa_node(numa_node_id);
+  current_memory_numa_node = numa_node_id;
+}
 } // namespace
 
 void* open_iomp_library() {
@@ -55,6 +72,58 @@ void* get_func_from_library(void* handle, const char* name) {
 #endif
 }
 
+#ifndef _WIN32
+namespace {
+// Native affinity backend, used when IOMP isn't loaded (e.g. GNU OpenMP).
+// The threads of any OpenMP runtime are pthreads, so the affinity of each
+// OMP thread can be set with pthread_setaffinity_np inside a parallel region.
+// kmp_affinity_mask_t holds a heap allocated cpu_set_t for this backend.
+void native_create_affinity_mask(kmp_affinity_mask_t* mask) {
+  cpu_set_t* cpu_set = new cpu_set_t;
+  CPU_ZERO(cpu_set);
+  *mask = cpu_set;
+}
+
+int native_set_affinity_mask_proc(int proc, kmp_affinity_mask_t* mask) {
+  if (proc < 0 || proc >= CPU_SETSIZE) {
+    return -1;
+  }
+  CPU_SET(proc, static_cast<cpu_set_t*>(*mask));
+  return 0;
+}
+
+int native_set_affinity(kmp_affinity_mask_t* mask) {
+  return pthread_setaffinity_np(
+      pthread_self(), sizeof(cpu_set_t), static_cast<cpu_set_t*>(*mask));
+}
+
+int native_get_affinity(kmp_affinity_mask_t* mask) {
+  return pthread_getaffinity_np(
+      pthread_self(), sizeof(cpu_set_t), static_cast<cpu_set_t*>(*mask));
+}
+
+void native_destroy_affinity_mask(kmp_affinity_mask_t* mask) {
+  delete static_cast<cpu_set_t*>(*mask);
+  *mask = nullptr;
+}
+
+int native_get_affinity_max_proc() {
+  return std::min<int>(sysconf(_SC_NPROCESSORS_CONF), CPU_SETSIZE);
+}
+} // namespace
+
+void loading_native_affinity_symbol() {
+  kmp_create_affinity_mask_ext = native_create_affinity_mask;
+  kmp_set_affinity_mask_proc_ext = native_set_affinity_mask_proc;
+  kmp_set_affinity_ext = native_set_affinity;
+  kmp_get_affinity_ext = native_get_affinity;
+  kmp_destroy_affinity_mask_ext = native_destroy_affinity_mask;
+  kmp_get_affinity_max_proc_ext = native_get_affinity_max_proc;
+  runtime_ext_backend = RuntimeExtBackend::NATIVE;
+  iomp_symbol_loaded = true;
+}
+#endif
+
 void loading_iomp_symbol() {
   void* handle = open_iomp_library();
   if (handle == NULL ||
@@ -65,6 +134,10 @@ void loading_iomp_symbol() {
       get_func_from_library(handle, "kmp_destroy_affinity_mask") == NULL ||
       get_func_from_library(handle, "kmp_get_affinity_max_proc") == NULL) {
     iomp_symbol_loaded = false;
+#ifndef _WIN32
+    // Fall back to the pthread affinity API.
+    loading_native_affinity_symbol();
+#endif
     return;
   }
 
@@ -85,6 +158,7 @@ void loading_iomp_symbol() {
       (kmp_get_affinity_max_proc_p)get_func_from_library(
           handle, "kmp_get_affinity_max_proc");
 
+  runtime_ext_backend = RuntimeExtBackend::IOMP;
   iomp_symbol_loaded = true;
   return;
 }
@@ -98,7 +172,7 @@ std::vector<int32_t> init_process_available_cores() {
   std::vector<int32_t> available_cpu_cores_internal;
 
   if (is_runtime_ext_enabled()) {
-    // When IOMP preloaded.
+    // When IOMP preloaded, or the native pthread affinity backend is used.
     // Step1: Get the main thread affinity information:
     // 2 knowning external command may change it during process starts up:
     //   * External Numactl.
@@ -206,6 +280,11 @@ bool is_runtime_ext_enabled() {
   return do_load_iomp_symbol();
 }
 
+RuntimeExtBackend get_runtime_ext_backend() {
+  do_load_iomp_symbol();
+  return runtime_ext_backend;
+}
+
 void init_runtime_ext() {
   if (!do_load_iomp_symbol()) {
     throw std::runtime_error(
@@ -216,6 +295,7 @@ void init_runtime_ext() {
 
 void _pin_cpu_cores(const torch_ipex::runtime::CPUPool& cpu_pool) {
   const std::vector<int32_t>& cpu_core_list = cpu_pool.get_cpu_core_list();
+  int32_t memory_numa_node = cpu_pool.get_memory_numa_node();
   if (!is_runtime_ext_enabled()) {
     throw std::runtime_error(
         "Didn't preload IOMP before using the runtime API");
@@ -233,6 +313,7 @@ void _pin_cpu_cores(const torch_ipex::runtime::CPUPool& cpu_pool) {
     kmp_set_affinity_mask_proc_ext(phy_core_id, &mask);
     kmp_set_affinity_ext(&mask);
     kmp_destroy_affinity_mask_ext(&mask);
+    update_thread_memory_binding(memory_numa_node);
   }
   // Cache the cpu_core_list for query.
   current_cpu_core_list = cpu_core_list;
@@ -276,6 +357,9 @@ void set_mask_affinity_from_cpu_pool(const CPUPool& cpu_pool) {
     int thread_id = omp_get_thread_num();
     kmp_affinity_mask_t mask = threads_mask[thread_id];
     kmp_set_affinity_ext(&mask);
+    // The mask expression doesn't record the memory binding, so drop the
+    // binding set by _pin_cpu_cores.
+    update_thread_memory_binding(-1);
   }
 }
 
@@ -284,6 +368,18 @@ CPUPool::CPUPool(const std::vector<int32_t>& cpu_core_list) {
   this->cpu_core_list_initialized_ = true;
 }
 
+CPUPool::CPUPool(const std::vector<int32_t>& cpu_core_list, bool bind_memory)
+    : CPUPool(cpu_core_list) {
+  if (bind_memory) {
+    this->memory_numa_node_ =
+        CPUTopology::get().get_numa_node_of_cores(this->cpu_core_list);
+    if (this->memory_numa_node_ < 0) {
+      throw std::runtime_error(
+          "Fail to bind the memory of CPUPool. The cores of CPUPool should locate on one numa node.");
+    }
+  }
+}
+
 CPUPool::CPUPool(std::vector<kmp_affinity_mask_t>&& cpu_core_mask) {
   // Notice: We shouldn't load iomp symbol in sub_thread, otherwise race
   // condition happens.
@@ -305,6 +401,7 @@ CPUPool::CPUPool(CPUPool&& source_cpu_pool) {
     this->cpu_core_list = std::move(
         const_cast<std::vector<int32_t>&>(source_cpu_pool.get_cpu_core_list()));
     this->cpu_core_list_initialized_ = true;
+    this->memory_numa_node_ = source_cpu_pool.get_memory_numa_node();
   } else {
     this->cpu_affinity_mask =
         std::move(const_cast<std::vector<kmp_affinity_mask_t>&>(
@@ -337,6 +434,10 @@ bool CPUPool::is_cpu_affinity_mask_initialized() const {
   return this->cpu_affinity_mask_initialized_;
 }
 
+int32_t CPUPool::get_memory_numa_node() const {
+  return this->memory_numa_node_;
+}
+
 CPUPool::~CPUPool() {
   if (this->cpu_affinity_mask_initialized_) {
     // If we are using the cpu_affinity_mask expression for CPUPool
@@ -22,6 +22,9 @@ typedef int (*kmp_get_affinity_max_proc_p)();
 class IPEX_API CPUPool {
  public:
   explicit CPUPool(const std::vector<int32_t>& cpu_core_list);
+  // When bind_memory is true, all the cores must locate on one numa node and
+  // the threads pinned to this CPUPool will allocate memory from that node.
+  CPUPool(const std::vector<int32_t>& cpu_core_list, bool bind_memory);
   explicit CPUPool(std::vector<kmp_affinity_mask_t>&& cpu_core_mask);
   CPUPool(CPUPool&& source_cpu_pool);
 
@@ -29,6 +32,8 @@ class IPEX_API CPUPool {
   const std::vector<kmp_affinity_mask_t>& get_cpu_affinity_mask() const;
   bool is_cpu_core_list_initialized() const;
   bool is_cpu_affinity_mask_initialized() const;
+  // Numa node the memory is bound to, -1 means no memory binding.
+  int32_t get_memory_numa_node() const;
   ~CPUPool();
 
  private:
@@ -39,6 +44,7 @@ class IPEX_API CPUPool {
   bool cpu_core_list_initialized_{false};
   std::vector<kmp_affinity_mask_t> cpu_affinity_mask;
   bool cpu_affinity_mask_initialized_{false};
+  int32_t memory_numa_node_{-1};
 
   // Put deleted function into private.
   CPUPool() = delete;
@@ -49,12 +55,17 @@ class IPEX_API CPUPool {
   CPUPool& operator=(CPUPool&& source_cpu_pool) = delete;
 };
 
+// Implementation of the thread affinity API: the kmp_* symbols of preloaded
+// IOMP, or pthread_setaffinity_np when IOMP isn't loaded (e.g. GNU OpenMP).
+enum class RuntimeExtBackend { NONE, IOMP, NATIVE };
+
 IPEX_API std::vector<int32_t> init_process_available_cores();
 IPEX_API std::vector<int32_t> get_process_available_cores();
 IPEX_API std::vector<int32_t> filter_cores_by_thread_affinity(
     const std::vector<int32_t>& cpu_core_list);
 bool do_load_iomp_symbol();
 IPEX_API bool is_runtime_ext_enabled();
+IPEX_API RuntimeExtBackend get_runtime_ext_backend();
 IPEX_API void init_runtime_ext();
 IPEX_API void _pin_cpu_cores(const torch_ipex::runtime::CPUPool& cpu_pool);
 IPEX_API bool is_same_core_affinity_setting(
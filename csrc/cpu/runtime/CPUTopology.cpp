@@ -0,0 +1,274 @@
+#include "CPUTopology.h"
+#include "CPUPool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace torch_ipex {
+namespace runtime {
+
+namespace {
+const std::string kSysCpuPath = "/sys/devices/system/cpu/";
+const std::string kSysNodePath = "/sys/devices/system/node/";
+
+// Memory policy modes of set_mempolicy, see
+// https://man7.org/linux/man-pages/man2/set_mempolicy.2.html
+// Defined here to avoid the dependency on libnuma headers.
+constexpr int kMpolDefault = 0;
+constexpr int kMpolPreferred = 1;
+constexpr int kMaxNumaNodes = 1024;
+
+bool read_first_line(const std::string& path, std::string& line) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  return static_cast<bool>(std::getline(file, line));
+}
+
+int32_t read_int(const std::string& path, int32_t default_value) {
+  std::string line;
+  if (!read_first_line(path, line) || line.empty()) {
+    return default_value;
+  }
+  return std::atoi(line.c_str());
+}
+
+// Parse the cpulist format of sysfs, e.g. "0-3,8,10-11".
+std::vector<int32_t> parse_cpu_list(const std::string& cpu_list) {
+  std::vector<int32_t> cpus;
+  std::stringstream ss(cpu_list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    if (dash == std::string::npos) {
+      cpus.emplace_back(std::atoi(range.c_str()));
+    } else {
+      int32_t first = std::atoi(range.substr(0, dash).c_str());
+      int32_t last = std::atoi(range.substr(dash + 1).c_str());
+      for (int32_t cpu = first; cpu <= last; cpu++) {
+        cpus.emplace_back(cpu);
+      }
+    }
+  }
+  return cpus;
+}
+
+int32_t first_cpu_of_list(const std::string& path, int32_t default_value) {
+  std::string line;
+  if (!read_first_line(path, line)) {
+    return default_value;
+  }
+  auto cpus = parse_cpu_list(line);
+  return cpus.empty() ? default_value : cpus[0];
+}
+
+// Map cpu id -> numa node id by scanning /sys/devices/system/node/node*.
+std::map<int32_t, int32_t> read_numa_node_of_cpus() {
+  std::map<int32_t, int32_t> node_of_cpu;
+#ifndef _WIN32
+  DIR* dir = opendir(kSysNodePath.c_str());
+  if (dir == nullptr) {
+    return node_of_cpu;
+  }
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name(entry->d_name);
+    if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+        !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+      continue;
+    }
+    int32_t node_id = std::atoi(name.c_str() + 4);
+    std::string cpu_list;
+    if (read_first_line(kSysNodePath + name + "/cpulist", cpu_list)) {
+      for (auto cpu : parse_cpu_list(cpu_list)) {
+        node_of_cpu[cpu] = node_id;
+      }
+    }
+  }
+  closedir(dir);
+#endif
+  return node_of_cpu;
+}
+
+// Id of the first cpu sharing the L3 cache with cpu, or -1 if unknown.
+int32_t read_l3_cache_id(int32_t cpu) {
+  std::string cache_path =
+      kSysCpuPath + "cpu" + std::to_string(cpu) + "/cache/index";
+  for (int index = 0;; index++) {
+    std::string index_path = cache_path + std::to_string(index);
+    int32_t level = read_int(index_path + "/level", -1);
+    if (level < 0) {
+      return -1;
+    }
+    if (level == 3) {
+      return first_cpu_of_list(index_path + "/shared_cpu_list", -1);
+    }
+  }
+}
+} // namespace
+
+CPUTopology::CPUTopology() {
+  std::vector<int32_t> available_cores = get_process_available_cores();
+  std::sort(available_cores.begin(), available_cores.end());
+  std::map<int32_t, int32_t> node_of_cpu = read_numa_node_of_cpus();
+
+  for (auto cpu : available_cores) {
+    std::string topology_path =
+        kSysCpuPath + "cpu" + std::to_string(cpu) + "/topology/";
+    CPUInfo info;
+    info.cpu_id = cpu;
+    info.physical_core_id =
+        first_cpu_of_list(topology_path + "thread_siblings_list", cpu);
+    info.socket_id = read_int(topology_path + "physical_package_id", 0);
+    auto node = node_of_cpu.find(cpu);
+    info.numa_node_id = node == node_of_cpu.end() ? 0 : node->second;
+    info.l3_cache_id = read_l3_cache_id(cpu);
+    if (info.l3_cache_id < 0) {
+      // No cache information, assume one L3 cache per socket.
+      info.l3_cache_id = -1 - info.socket_id;
+    }
+    info.is_smt_sibling = info.physical_core_id != cpu;
+    this->cpu_infos.emplace_back(info);
+  }
+}
+
+const CPUTopology& CPUTopology::get() {
+  // Parsed once and shared by the whole process.
+  static CPUTopology topology;
+  return topology;
+}
+
+const std::vector<CPUInfo>& CPUTopology::get_cpu_infos() const {
+  return this->cpu_infos;
+}
+
+std::vector<int32_t> CPUTopology::get_numa_node_ids() const {
+  std::vector<int32_t> node_ids;
+  for (const auto& info : this->cpu_infos) {
+    if (std::find(node_ids.begin(), node_ids.end(), info.numa_node_id) ==
+        node_ids.end()) {
+      node_ids.emplace_back(info.numa_node_id);
+    }
+  }
+  std::sort(node_ids.begin(), node_ids.end());
+  return node_ids;
+}
+
+std::vector<int32_t> CPUTopology::get_cores_of_numa_node(
+    int32_t numa_node_id,
+    bool physical_cores_only) const {
+  std::vector<int32_t> cores;
+  for (const auto& info : this->cpu_infos) {
+    if (info.numa_node_id == numa_node_id &&
+        !(physical_cores_only && info.is_smt_sibling)) {
+      cores.emplace_back(info.cpu_id);
+    }
+  }
+  if (cores.empty()) {
+    throw std::runtime_error(
+        "Can't find available core on numa node " +
+        std::to_string(numa_node_id) + " for current process.");
+  }
+  return cores;
+}
+
+std::vector<std::vector<int32_t>> CPUTopology::get_cores_per_l3_cache(
+    bool physical_cores_only) const {
+  // cpu_infos is sorted by cpu_id, so the domains are ordered by the first
+  // core id.
+  std::vector<int32_t> l3_ids;
+  std::vector<std::vector<int32_t>> cores_per_l3;
+  for (const auto& info : this->cpu_infos) {
+    if (physical_cores_only && info.is_smt_sibling) {
+      continue;
+    }
+    auto it = std::find(l3_ids.begin(), l3_ids.end(), info.l3_cache_id);
+    if (it == l3_ids.end()) {
+      l3_ids.emplace_back(info.l3_cache_id);
+      cores_per_l3.emplace_back();
+      cores_per_l3.back().emplace_back(info.cpu_id);
+    } else {
+      cores_per_l3[it - l3_ids.begin()].emplace_back(info.cpu_id);
+    }
+  }
+  return cores_per_l3;
+}
+
+std::vector<int32_t> CPUTopology::get_physical_cores() const {
+  std::vector<int32_t> cores;
+  for (const auto& info : this->cpu_infos) {
+    if (!info.is_smt_sibling) {
+      cores.emplace_back(info.cpu_id);
+    }
+  }
+  return cores;
+}
+
+int32_t CPUTopology::get_numa_node_of_cores(
+    const std::vector<int32_t>& cpu_core_list) const {
+  int32_t numa_node_id = -1;
+  for (auto cpu : cpu_core_list) {
+    const CPUInfo* info = this->find_cpu_info(cpu);
+    if (info == nullptr) {
+      return -1;
+    }
+    if (numa_node_id >= 0 && numa_node_id != info->numa_node_id) {
+      return -1;
+    }
+    numa_node_id = info->numa_node_id;
+  }
+  return numa_node_id;
+}
+
+const CPUInfo* CPUTopology::find_cpu_info(int32_t cpu_id) const {
+  auto it = std::lower_bound(
+      this->cpu_infos.begin(),
+      this->cpu_infos.end(),
+      cpu_id,
+      [](const CPUInfo& info, int32_t id) { return info.cpu_id < id; });
+  if (it == this->cpu_infos.end() || it->cpu_id != cpu_id) {
+    return nullptr;
+  }
+  return &(*it);
+}
+
+bool bind_thread_memory_to_numa_node(int32_t numa_node_id) {
+#if defined(_WIN32) || !defined(SYS_set_mempolicy)
+  return false;
+#else
+  constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+  if (numa_node_id < 0) {
+    return syscall(SYS_set_mempolicy, kMpolDefault, nullptr, 0) == 0;
+  }
+  if (numa_node_id >= kMaxNumaNodes) {
+    return false;
+  }
+  unsigned long node_mask[kMaxNumaNodes / kBitsPerWord] = {0};
+  node_mask[numa_node_id / kBitsPerWord] |= 1UL
+      << (numa_node_id % kBitsPerWord);
+  // The kernel expects maxnode to be one more than the number of mask bits.
+  return syscall(
+             SYS_set_mempolicy,
+             kMpolPreferred,
+             node_mask,
+             kMaxNumaNodes + 1) == 0;
+#endif
+}
+
+} // namespace runtime
+} // namespace torch_ipex
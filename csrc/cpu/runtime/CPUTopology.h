@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <Macros.h>
+
+namespace torch_ipex {
+namespace runtime {
+
+// Placement of one logical CPU inside the machine.
+struct CPUInfo {
+  int32_t cpu_id;
+  // Id of the first logical CPU of the physical core this CPU belongs to.
+  int32_t physical_core_id;
+  int32_t socket_id;
+  int32_t numa_node_id;
+  // Id of the first logical CPU sharing the same L3 cache.
+  int32_t l3_cache_id;
+  // False for the first hardware thread of a physical core, true for its SMT
+  // siblings.
+  bool is_smt_sibling;
+};
+
+// Machine topology parsed once from /sys/devices/system. Queries only return
+// the cores available to current process (see get_process_available_cores),
+// so pools created from them also honor external numactl/taskset settings.
+// When /sys is not readable (e.g. Windows), every available core is treated
+// as a physical core on numa node 0 sharing one L3 cache.
+class IPEX_API CPUTopology {
+ public:
+  static const CPUTopology& get();
+
+  const std::vector<CPUInfo>& get_cpu_infos() const;
+  // Numa nodes that have at least one available core.
+  std::vector<int32_t> get_numa_node_ids() const;
+  std::vector<int32_t> get_cores_of_numa_node(
+      int32_t numa_node_id,
+      bool physical_cores_only) const;
+  // One core list per L3 cache domain, ordered by the first core id.
+  std::vector<std::vector<int32_t>> get_cores_per_l3_cache(
+      bool physical_cores_only) const;
+  std::vector<int32_t> get_physical_cores() const;
+  // Returns the numa node of the cores, or -1 if they span several nodes.
+  int32_t get_numa_node_of_cores(
+      const std::vector<int32_t>& cpu_core_list) const;
+
+ private:
+  CPUTopology();
+  const CPUInfo* find_cpu_info(int32_t cpu_id) const;
+
+  // Sorted by cpu_id, restricted to the available cores.
+  std::vector<CPUInfo> cpu_infos;
+};
+
+// Bind the memory allocated by calling thread to the numa node (preferred
+// policy, falls back to other nodes when the node is out of memory). A
+// negative numa_node_id restores the default local allocation policy.
+IPEX_API bool bind_thread_memory_to_numa_node(int32_t numa_node_id);
+
+} // namespace runtime
+} // namespace torch_ipex
@@ -0,0 +1,120 @@
+#include "MultiInstanceEngine.h"
+
+#include <ATen/core/grad_mode.h>
+
+namespace torch_ipex {
+namespace runtime {
+
+MultiInstanceEngine::MultiInstanceEngine(
+    const torch::jit::Module& module,
+    std::vector<std::shared_ptr<CPUPool>> cpu_pools)
+    : module_(module), cpu_pools_(std::move(cpu_pools)) {
+  // Notice: We shouldn't load iomp symbol in sub_thread, otherwise race
+  // condition happens.
+  if (!is_runtime_ext_enabled()) {
+    throw std::runtime_error(
+        "Fail to init MultiInstanceEngine. The runtime extension isn't "
+        "enabled.");
+  }
+  if (this->cpu_pools_.empty()) {
+    throw std::runtime_error(
+        "Fail to init MultiInstanceEngine. At least one CPUPool is needed.");
+  }
+  // Resolve forward before starting the instances, so a module without
+  // forward fails here instead of inside the instance threads.
+  this->module_.get_method("forward");
+
+  this->num_finished_requests_ =
+      std::make_unique<std::atomic<int64_t>[]>(this->cpu_pools_.size());
+  for (size_t i = 0; i < this->cpu_pools_.size(); i++) {
+    this->num_finished_requests_[i] = 0;
+    this->instances_.emplace_back(
+        [this, i]() { this->instance_loop(i); });
+  }
+}
+
+MultiInstanceEngine::~MultiInstanceEngine() {
+  this->stop();
+}
+
+void MultiInstanceEngine::instance_loop(size_t instance_id) {
+  // Each instance owns an OMP thread pool pinned to its CPUPool, and the
+  // memory of the pool's threads is bound to its numa node if requested.
+  _pin_cpu_cores(*this->cpu_pools_[instance_id]);
+  while (true) {
+    std::function<void()> request;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex_);
+      this->condition_.wait(
+          lock, [this] { return this->stop_ || !this->requests_.empty(); });
+      if (this->stop_ && this->requests_.empty())
+        return;
+      request = std::move(this->requests_.front());
+      this->requests_.pop();
+    }
+    request();
+    this->num_finished_requests_[instance_id]++;
+  }
+}
+
+std::future<c10::IValue> MultiInstanceEngine::submit(
+    std::vector<c10::IValue> inputs) {
+  inputs.insert(inputs.begin(), this->module_._ivalue());
+  auto& function = this->module_.get_method("forward").function();
+  auto task = std::make_shared<std::packaged_task<c10::IValue()>>(
+      [&function, stack = std::move(inputs)]() mutable -> c10::IValue {
+        return function(std::move(stack));
+      });
+  std::future<c10::IValue> result = task->get_future();
+  // Set the thread local status, such as the grad mode, of the submitting
+  // thread into the instance.
+  auto grad_mode = at::GradMode::is_enabled();
+  {
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    // submit request to a stopped engine is not allowed
+    if (this->stop_)
+      throw std::runtime_error("Submit request on stopped MultiInstanceEngine");
+    this->requests_.emplace([task, grad_mode]() {
+      at::GradMode::set_enabled(grad_mode);
+      (*task)();
+    });
+  }
+  this->condition_.notify_one();
+  return result;
+}
+
+c10::IValue MultiInstanceEngine::run_sync(std::vector<c10::IValue> inputs) {
+  return this->submit(std::move(inputs)).get();
+}
+
+const torch::jit::Module& MultiInstanceEngine::get_module() const {
+  return this->module_;
+}
+
+int64_t MultiInstanceEngine::get_num_instances() const {
+  return this->cpu_pools_.size();
+}
+
+std::vector<int64_t> MultiInstanceEngine::get_num_finished_requests() const {
+  std::vector<int64_t> num_finished_requests;
+  for (size_t i = 0; i < this->cpu_pools_.size(); i++) {
+    num_finished_requests.emplace_back(this->num_finished_requests_[i]);
+  }
+  return num_finished_requests;
+}
+
+void MultiInstanceEngine::stop() {
+  {
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    if (this->stop_)
+      return;
+    this->stop_ = true;
+  }
+  this->condition_.notify_all();
+  for (auto& instance : this->instances_) {
+    instance.join();
+  }
+}
+
+} // namespace runtime
+} // namespace torch_ipex
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <ATen/core/ivalue.h>
+#include <Macros.h>
+#include <torch/csrc/jit/api/module.h>
+#include "CPUPool.h"
+
+namespace torch_ipex {
+namespace runtime {
+
+/*
+MultiInstanceEngine runs one inference instance per CPUPool inside current
+process. All the instances execute the same script module, so the parameters
+and the prepacked OpContexts (read-only at inference) are shared instead of
+being copied per instance as with multi-process serving. Requests are pushed
+to one admission queue, and the first idle instance takes the next request.
+*/
+class IPEX_API MultiInstanceEngine {
+ public:
+  explicit MultiInstanceEngine(
+      const torch::jit::Module& module,
+      std::vector<std::shared_ptr<CPUPool>> cpu_pools);
+  MultiInstanceEngine(const MultiInstanceEngine& engine) = delete;
+  MultiInstanceEngine(MultiInstanceEngine&& engine) = delete;
+  MultiInstanceEngine& operator=(const MultiInstanceEngine& engine) = delete;
+  MultiInstanceEngine& operator=(MultiInstanceEngine&& engine) = delete;
+  ~MultiInstanceEngine();
+
+  // Submit the inputs of forward (without self) to the admission queue.
+  std::future<c10::IValue> submit(std::vector<c10::IValue> inputs);
+  c10::IValue run_sync(std::vector<c10::IValue> inputs);
+  const torch::jit::Module& get_module() const;
+  int64_t get_num_instances() const;
+  // Number of requests each instance has finished.
+  std::vector<int64_t> get_num_finished_requests() const;
+  // Finish the queued requests and join the instances.
+  void stop();
+
+ private:
+  void instance_loop(size_t instance_id);
+
+  torch::jit::Module module_;
+  std::vector<std::shared_ptr<CPUPool>> cpu_pools_;
+  std::vector<std::thread> instances_;
+  std::unique_ptr<std::atomic<int64_t>[]> num_finished_requests_;
+
+  // Shared admission queue
+  std::queue<std::function<void()>> requests_;
+  bool stop_{false};
+  std::mutex mutex_;
+  std::condition_variable condition_;
+};
+
+} // namespace runtime
+} // namespace torch_ipex
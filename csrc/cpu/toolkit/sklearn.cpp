@@ -1,5 +1,8 @@
 #include "sklearn.h"
 #include <ATen/Dispatch.h>
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
 #ifdef _WIN32
 #include <ppl.h>
 #define IPEX_PARALLEL_SORT concurrency::parallel_sort
@@ -18,53 +21,58 @@ template <typename T>
 std::vector<double> roc_auc_score_(
     at::Tensor self,
     at::Tensor other,
-    int size,
+    int64_t size,
     bool only_score = true) {
   T* actual = self.data_ptr<T>();
   T* prediction = other.data_ptr<T>();
-  std::vector<T> predictedRank(size, 0.0);
-  int nPos = 0, nNeg = 0;
+  int64_t nPos = 0, nNeg = 0;
 #pragma omp parallel for reduction(+ : nPos)
-  for (int i = 0; i < size; i++)
-    nPos += (int)actual[i];
+  for (int64_t i = 0; i < size; i++)
+    nPos += (int64_t)actual[i];
 
   nNeg = size - nPos;
 
-  std::vector<std::pair<T, int>> v_sort(size);
+  // Sort (prediction, label) pairs, so the ranking doesn't need an index
+  // indirection nor a rank per sample.
+  std::vector<std::pair<T, T>> v_sort(size);
 #pragma omp parallel for
-  for (size_t i = 0; i < size; ++i) {
-    v_sort[i] = std::make_pair(prediction[i], i);
+  for (int64_t i = 0; i < size; ++i) {
+    v_sort[i] = std::make_pair(prediction[i], actual[i]);
   }
 
   IPEX_PARALLEL_SORT(v_sort.begin(), v_sort.end(), [](auto& left, auto& right) {
     return left.first < right.first;
   });
 
-  int r = 1;
-  int n = 1;
-  size_t i = 0;
-  while (i < size) {
-    size_t j = i;
-    while ((j < (v_sort.size() - 1)) &&
-           (v_sort[j].first == v_sort[j + 1].first)) {
-      j++;
-    }
-    n = j - i + 1;
-    for (size_t j = 0; j < n; ++j) {
-      int idx = v_sort[i + j].second;
-      predictedRank[idx] = r + ((n - 1) * 0.5);
-    }
-    r += n;
-    i += n;
-  }
-
+  // Rank the ties in parallel. Samples with the same prediction share the
+  // average of their 1-based ranks [i + 1, j]. Each chunk handles the tie
+  // groups starting inside it, and may run past its end to finish the last
+  // group.
   double filteredRankSum = 0;
+  int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(omp_get_max_threads() * 4, size / 4096));
+  int64_t chunk_size = (size + num_chunks - 1) / num_chunks;
 #pragma omp parallel for reduction(+ : filteredRankSum)
-  for (size_t i = 0; i < size; ++i) {
-    if (actual[i] == 1) {
-      filteredRankSum += predictedRank[i];
+  for (int64_t c = 0; c < num_chunks; c++) {
+    int64_t begin = c * chunk_size;
+    int64_t end = std::min(begin + chunk_size, size);
+    int64_t i = begin;
+    // Skip the tail of the group started in previous chunk.
+    while (i > 0 && i < end && v_sort[i].first == v_sort[i - 1].first) {
+      i++;
+    }
+    while (i < end) {
+      int64_t j = i;
+      int64_t pos_in_group = 0;
+      while (j < size && v_sort[j].first == v_sort[i].first) {
+        pos_in_group += v_sort[j].second == 1;
+        j++;
+      }
+      filteredRankSum += pos_in_group * ((i + 1 + j) * 0.5);
+      i = j;
     }
   }
+
   double score = (filteredRankSum - ((double)nPos * ((nPos + 1.0) / 2.0))) /
       ((double)nPos * nNeg);
   double log_loss = 0.0;
@@ -73,7 +81,7 @@ std::vector<double> roc_auc_score_(
     double acc = 0.0;
     double loss = 0.0;
 #pragma omp parallel for reduction(+ : acc, loss)
-    for (int i = 0; i < size; i++) {
+    for (int64_t i = 0; i < size; i++) {
       auto rpred = std::roundf(prediction[i]);
       if (actual[i] == rpred)
         acc += 1;
@@ -110,4 +118,100 @@ std::vector<double> roc_auc_score_all(at::Tensor self, at::Tensor other) {
       });
 }
 
+StreamingMetrics::StreamingMetrics(int64_t num_bins) : num_bins_(num_bins) {
+  TORCH_CHECK(num_bins > 0, "StreamingMetrics: num_bins should be positive");
+}
+
+template <typename T>
+void StreamingMetrics::update_(
+    const T* actual,
+    const T* prediction,
+    int64_t size) {
+  // Thread local histograms are kept across batches and only merged in
+  // compute(), so an update doesn't touch other threads' cache lines.
+  size_t max_threads = omp_get_max_threads();
+  while (this->pos_hist_.size() < max_threads) {
+    this->pos_hist_.emplace_back(this->num_bins_, 0);
+    this->neg_hist_.emplace_back(this->num_bins_, 0);
+  }
+  double acc = 0.0;
+  double loss = 0.0;
+#pragma omp parallel reduction(+ : acc, loss)
+  {
+    int64_t* pos_hist = this->pos_hist_[omp_get_thread_num()].data();
+    int64_t* neg_hist = this->neg_hist_[omp_get_thread_num()].data();
+#pragma omp for
+    for (int64_t i = 0; i < size; i++) {
+      double pred = prediction[i];
+      int64_t bin = std::min<int64_t>(
+          std::max<int64_t>(pred * this->num_bins_, 0), this->num_bins_ - 1);
+      if (actual[i] == 1) {
+        pos_hist[bin]++;
+      } else {
+        neg_hist[bin]++;
+      }
+      if (actual[i] == std::roundf(prediction[i]))
+        acc += 1;
+      loss += (actual[i] * std::log(prediction[i])) +
+          ((1 - actual[i]) * std::log(1 - prediction[i]));
+    }
+  }
+  this->num_samples_ += size;
+  this->num_correct_ += acc;
+  this->log_loss_sum_ -= loss;
+}
+
+void StreamingMetrics::update(at::Tensor actual, at::Tensor predict) {
+  TORCH_CHECK(
+      actual.numel() == predict.numel(),
+      "StreamingMetrics: actual and predict should have the same size");
+  auto actual_ = actual.contiguous().to(predict.scalar_type());
+  auto predict_ = predict.contiguous();
+  AT_DISPATCH_FLOATING_TYPES(
+      predict_.scalar_type(), "streaming_metrics_update", [&]() {
+        this->update_<scalar_t>(
+            actual_.data_ptr<scalar_t>(),
+            predict_.data_ptr<scalar_t>(),
+            predict_.numel());
+      });
+}
+
+std::vector<double> StreamingMetrics::compute() const {
+  // Each bin is a tie group: a positive sample ranks above all the negative
+  // samples of lower bins and half of the negative samples of its own bin.
+  std::vector<int64_t> pos_hist(this->num_bins_, 0);
+  std::vector<int64_t> neg_hist(this->num_bins_, 0);
+#pragma omp parallel for
+  for (int64_t b = 0; b < this->num_bins_; b++) {
+    for (size_t t = 0; t < this->pos_hist_.size(); t++) {
+      pos_hist[b] += this->pos_hist_[t][b];
+      neg_hist[b] += this->neg_hist_[t][b];
+    }
+  }
+  double nPos = 0, nNeg = 0, pairs = 0;
+  for (int64_t b = 0; b < this->num_bins_; b++) {
+    pairs += pos_hist[b] * (nNeg + 0.5 * neg_hist[b]);
+    nPos += pos_hist[b];
+    nNeg += neg_hist[b];
+  }
+  double score = pairs / (nPos * nNeg);
+  double num_samples = this->num_samples_;
+  return {
+      score,
+      this->log_loss_sum_ / num_samples,
+      this->num_correct_ / num_samples};
+}
+
+void StreamingMetrics::reset() {
+  this->pos_hist_.clear();
+  this->neg_hist_.clear();
+  this->num_samples_ = 0;
+  this->num_correct_ = 0;
+  this->log_loss_sum_ = 0;
+}
+
+int64_t StreamingMetrics::num_samples() const {
+  return this->num_samples_;
+}
+
 } // namespace toolkit
@@ -5,4 +5,31 @@
 namespace toolkit {
 std::vector<double> roc_auc_score(at::Tensor actual, at::Tensor predict);
 std::vector<double> roc_auc_score_all(at::Tensor actual, at::Tensor predict);
+
+// Streaming version of roc_auc_score_all for evaluation sets which don't fit
+// in memory. Each update() accumulates one batch in parallel into fixed-bin
+// histograms of the predictions (expected in [0, 1]) per label, so the memory
+// is O(num_bins) regardless of the number of samples. Samples falling into
+// the same bin are ranked as ties, which bounds the AUC error by the bin
+// width. compute() returns {auc, log_loss, accuracy} as roc_auc_score_all.
+class StreamingMetrics {
+ public:
+  explicit StreamingMetrics(int64_t num_bins = 1 << 16);
+  void update(at::Tensor actual, at::Tensor predict);
+  std::vector<double> compute() const;
+  void reset();
+  int64_t num_samples() const;
+
+ private:
+  template <typename T>
+  void update_(const T* actual, const T* prediction, int64_t size);
+
+  int64_t num_bins_;
+  // Per thread histograms of positive/negative samples.
+  std::vector<std::vector<int64_t>> pos_hist_;
+  std::vector<std::vector<int64_t>> neg_hist_;
+  int64_t num_samples_{0};
+  double num_correct_{0};
+  double log_loss_sum_{0};
+};
 } // namespace toolkit
@@ -0,0 +1,239 @@
+#include "op_instrumentation.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+namespace torch_ipex {
+namespace instrumentation {
+
+namespace {
+
+struct Counters {
+  int64_t calls = 0;
+  int64_t ns = 0;
+  int64_t bytes = 0;
+  int64_t flops = 0;
+};
+
+// (op, shapes) -> counters
+using CounterMap = std::map<std::pair<std::string, std::string>, Counters>;
+
+struct ThreadCounters {
+  // only contended by the report and reset
+  std::mutex mutex;
+  CounterMap counters;
+};
+
+struct Registry {
+  std::mutex mutex;
+  // kept after the thread exits, so that its ops stay in the report
+  std::vector<std::shared_ptr<ThreadCounters>> threads;
+};
+
+// Never destroyed, the report at exit may run after the other statics are
+// gone.
+Registry& get_registry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+ThreadCounters& get_thread_counters() {
+  thread_local std::shared_ptr<ThreadCounters> counters = []() {
+    auto thread_counters = std::make_shared<ThreadCounters>();
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(thread_counters);
+    return thread_counters;
+  }();
+  return *counters;
+}
+
+CounterMap merge_counters() {
+  CounterMap merged;
+  auto& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (auto& thread : registry.threads) {
+    std::lock_guard<std::mutex> thread_lock(thread->mutex);
+    for (const auto& item : thread->counters) {
+      auto& counters = merged[item.first];
+      counters.calls += item.second.calls;
+      counters.ns += item.second.ns;
+      counters.bytes += item.second.bytes;
+      counters.flops += item.second.flops;
+    }
+  }
+  return merged;
+}
+
+bool env_enabled() {
+  auto envar = std::getenv("IPEX_OP_INSTRUMENTATION");
+  return envar != nullptr && std::string(envar) == "1";
+}
+
+// Prints the report at exit when enabled by IPEX_OP_INSTRUMENTATION.
+struct ReportAtExit {
+  ~ReportAtExit() {
+    if (env_enabled()) {
+      fprintf(stderr, "%s", get_report().c_str());
+    }
+  }
+} report_at_exit;
+
+std::string format_double(double value, int precision) {
+  std::ostringstream ss;
+  ss.setf(std::ios::fixed);
+  ss.precision(precision);
+  ss << value;
+  return ss.str();
+}
+
+} // namespace
+
+std::atomic<bool> enabled{env_enabled()};
+
+void set_enabled(bool enable) {
+  enabled.store(enable, std::memory_order_relaxed);
+}
+
+void reset() {
+  auto& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (auto& thread : registry.threads) {
+    std::lock_guard<std::mutex> thread_lock(thread->mutex);
+    thread->counters.clear();
+  }
+}
+
+void record(
+    const char* op,
+    const std::string& shapes,
+    int64_t ns,
+    int64_t bytes,
+    int64_t flops) {
+  auto& thread = get_thread_counters();
+  std::lock_guard<std::mutex> lock(thread.mutex);
+  auto& counters = thread.counters[std::make_pair(std::string(op), shapes)];
+  counters.calls++;
+  counters.ns += ns;
+  counters.bytes += bytes;
+  counters.flops += flops;
+}
+
+void OpScope::add_tensor(const at::Tensor& tensor) {
+  if (!tensor.defined()) {
+    return;
+  }
+  if (!shapes_.empty()) {
+    shapes_ += ", ";
+  }
+  shapes_ += c10::toString(tensor.scalar_type());
+  shapes_ += "[";
+  for (int64_t i = 0; i < tensor.dim(); i++) {
+    if (i > 0) {
+      shapes_ += ",";
+    }
+    shapes_ += std::to_string(tensor.size(i));
+  }
+  shapes_ += "]";
+  bytes_ += tensor.nbytes();
+}
+
+std::string get_report(double peak_gflops, double peak_gbps) {
+  auto merged = merge_counters();
+  std::vector<std::pair<std::pair<std::string, std::string>, Counters>> items(
+      merged.begin(), merged.end());
+  std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) {
+    return a.second.ns > b.second.ns;
+  });
+  int64_t total_ns = 0;
+  for (const auto& item : items) {
+    total_ns += item.second.ns;
+  }
+  bool roofline = peak_gflops > 0 && peak_gbps > 0;
+
+  // op, shapes, calls, total ms, % of total, avg us, GFLOP/s, GB/s,
+  // FLOP/byte, [bound, % of roof]
+  std::vector<std::vector<std::string>> rows;
+  rows.push_back(
+      {"op",
+       "shapes",
+       "calls",
+       "total(ms)",
+       "%",
+       "avg(us)",
+       "GFLOP/s",
+       "GB/s",
+       "FLOP/B"});
+  if (roofline) {
+    rows[0].push_back("bound");
+    rows[0].push_back("%roof");
+  }
+  for (const auto& item : items) {
+    const auto& c = item.second;
+    double seconds = std::max(c.ns, int64_t(1)) * 1e-9;
+    double gflops = c.flops / seconds * 1e-9;
+    double gbps = c.bytes / seconds * 1e-9;
+    bool has_flops = c.flops > 0;
+    bool has_bytes = c.bytes > 0;
+    std::vector<std::string> row = {
+        item.first.first,
+        item.first.second,
+        std::to_string(c.calls),
+        format_double(c.ns * 1e-6, 3),
+        format_double(total_ns > 0 ? 100.0 * c.ns / total_ns : 0, 1),
+        format_double(c.ns * 1e-3 / std::max(c.calls, int64_t(1)), 1),
+        has_flops ? format_double(gflops, 1) : "-",
+        has_bytes ? format_double(gbps, 1) : "-",
+        has_flops && has_bytes
+            ? format_double(double(c.flops) / c.bytes, 2)
+            : "-"};
+    if (roofline) {
+      if (has_flops && has_bytes) {
+        // attainable = min(peak compute, intensity * peak bandwidth)
+        double intensity = double(c.flops) / c.bytes;
+        bool memory_bound = intensity * peak_gbps < peak_gflops;
+        double roof = memory_bound ? intensity * peak_gbps : peak_gflops;
+        row.push_back(memory_bound ? "memory" : "compute");
+        row.push_back(format_double(100.0 * gflops / roof, 1));
+      } else if (has_bytes) {
+        row.push_back("memory");
+        row.push_back(format_double(100.0 * gbps / peak_gbps, 1));
+      } else {
+        row.push_back("-");
+        row.push_back("-");
+      }
+    }
+    rows.push_back(std::move(row));
+  }
+
+  std::vector<size_t> widths(rows[0].size(), 0);
+  for (const auto& row : rows) {
+    for (size_t i = 0; i < row.size(); i++) {
+      widths[i] = std::max(widths[i], row[i].size());
+    }
+  }
+  std::ostringstream ss;
+  ss << "IPEX op instrumentation: " << items.size() << " op/shapes entries, "
+     << format_double(total_ns * 1e-6, 3) << " ms in total\n";
+  for (const auto& row : rows) {
+    for (size_t i = 0; i < row.size(); i++) {
+      // left align the op and the shapes, right align the numbers
+      if (i < 2) {
+        ss << row[i] << std::string(widths[i] - row[i].size(), ' ');
+      } else {
+        ss << std::string(widths[i] - row[i].size(), ' ') << row[i];
+      }
+      ss << (i + 1 < row.size() ? "  " : "\n");
+    }
+  }
+  return ss.str();
+}
+
+} // namespace instrumentation
+} // namespace torch_ipex
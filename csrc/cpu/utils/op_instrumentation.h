@@ -0,0 +1,127 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <Macros.h>
+#include <c10/util/Optional.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace torch_ipex {
+namespace instrumentation {
+
+/*
+Lightweight instrumentation of the IPEX ops: the calls, the inclusive time,
+the bytes of the tensor arguments and the FLOPs, per op and per input shapes.
+It covers the dispatch stubs, the prepacked op contexts and the LLGA kernels,
+and prints a roofline-style report without running the PyTorch profiler.
+
+It is off by default, where an op only pays one relaxed atomic load. Set
+IPEX_OP_INSTRUMENTATION=1 to enable it at startup and print the report to
+stderr at exit, or toggle it with ipex._C._set_op_instrumentation_enabled and
+read the report with ipex._C._get_op_instrumentation_report at runtime. The
+counters are per thread, so the ops never contend for a lock except with the
+report. The time is inclusive, an op calling another instrumented op is
+counted in both.
+*/
+
+IPEX_API extern std::atomic<bool> enabled;
+
+inline bool is_enabled() {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+IPEX_API void set_enabled(bool enable);
+
+// Clear the counters of all the threads.
+IPEX_API void reset();
+
+// Ops sorted by total time. With the peak FLOP/s and bandwidth of the
+// machine, also shows the roofline bound of each op and the achieved
+// percentage of it.
+IPEX_API std::string get_report(double peak_gflops = 0, double peak_gbps = 0);
+
+IPEX_API void record(
+    const char* op,
+    const std::string& shapes,
+    int64_t ns,
+    int64_t bytes,
+    int64_t flops);
+
+// Times the scope and records it on destruction, if the instrumentation was
+// enabled when the scope was entered. Check active() before computing the
+// shapes, bytes and FLOPs.
+class OpScope {
+ public:
+  explicit OpScope(const char* op) : op_(op), active_(is_enabled()) {
+    if (active_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  OpScope(const OpScope&) = delete;
+  OpScope& operator=(const OpScope&) = delete;
+
+  ~OpScope() {
+    if (active_) {
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_)
+                    .count();
+      record(op_, shapes_, ns, bytes_, flops_);
+    }
+  }
+
+  bool active() const {
+    return active_;
+  }
+
+  // Appends the dtype and the sizes of the tensor to the shape key, and
+  // counts its bytes.
+  void add_tensor(const at::Tensor& tensor);
+
+  void add_tensor(const c10::optional<at::Tensor>& tensor) {
+    if (tensor.has_value()) {
+      add_tensor(tensor.value());
+    }
+  }
+
+  void add_tensor(at::TensorList tensors) {
+    for (const auto& tensor : tensors) {
+      add_tensor(tensor);
+    }
+  }
+
+  void add_tensor(const std::vector<at::Tensor>& tensors) {
+    add_tensor(at::TensorList(tensors));
+  }
+
+  // arguments other than tensors are not part of the shape key
+  template <typename T>
+  void add_tensor(const T&) {}
+
+  template <typename... Args>
+  void add_tensors(const Args&... args) {
+    (void)std::initializer_list<int>{(add_tensor(args), 0)...};
+  }
+
+  void add_bytes(int64_t bytes) {
+    bytes_ += bytes;
+  }
+
+  void add_flops(int64_t flops) {
+    flops_ += flops;
+  }
+
+ private:
+  const char* op_;
+  bool active_;
+  std::chrono::steady_clock::time_point start_;
+  std::string shapes_;
+  int64_t bytes_ = 0;
+  int64_t flops_ = 0;
+};
+
+} // namespace instrumentation
+} // namespace torch_ipex
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <omp.h>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+
+#include <ideep.hpp>
+#include "rw_lock.h"
+
+namespace torch_ipex {
+namespace cpu {
+
+// Whether the primitives created with the two attrs are interchangeable.
+inline bool same_primitive_attr(
+    const ideep::attr_t& attr,
+    const ideep::attr_t& other) {
+  return attr.has_same_postop_as(other) &&
+      attr.get_all_scales() == other.get_all_scales() &&
+      attr.get_fpmath_mode() == other.get_fpmath_mode();
+}
+
+// Bounded cache of the oneDNN primitives of one prepacked op context, for the
+// input shapes other than the one the weight was prepacked for, so that the
+// primitives are reused after warm-up instead of being created on every call.
+//
+// Entry holds the primitive with the src_desc_ and attr_ it was created for,
+// and provides the key of the op as
+//   bool matches(const ideep::tensor::desc& src_desc,
+//                const ideep::attr_t& attr) const;
+// The thread count the primitive was created with is part of the key of all
+// the entries. Entries are immutable once inserted, lookups only take the read
+// lock, and the entries are evicted in insertion order.
+template <typename EntryT>
+class PrimitiveCache {
+ public:
+  using Entry = EntryT;
+
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    size_t size;
+  };
+
+  // Returns nullptr on miss.
+  std::shared_ptr<const Entry> find(
+      const ideep::tensor::desc& src_desc,
+      const ideep::attr_t& attr) {
+    int num_threads = omp_get_max_threads();
+    UniqueReadLock<ReadWriteMutex> lock(rwmutex_);
+    for (const auto& cached : entries_) {
+      if (cached.num_threads == num_threads &&
+          cached.entry->matches(src_desc, attr)) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return cached.entry;
+      }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  // Insert the entry created with the current thread count, unless another
+  // thread has inserted the same key in the meantime, and return the entry
+  // that is stored in the cache. An entry with a primitive that can't be used
+  // is cached too, so that its shape goes to the slow path without creating
+  // the primitive again.
+  std::shared_ptr<const Entry> insert(
+      std::shared_ptr<const Entry> entry,
+      size_t capacity) {
+    int num_threads = omp_get_max_threads();
+    UniqueWriteLock<ReadWriteMutex> lock(rwmutex_);
+    for (const auto& cached : entries_) {
+      if (cached.num_threads == num_threads &&
+          cached.entry->matches(entry->src_desc_, entry->attr_)) {
+        return cached.entry;
+      }
+    }
+    if (capacity == 0) {
+      return entry;
+    }
+    while (entries_.size() >= capacity) {
+      entries_.pop_front();
+    }
+    entries_.push_back({num_threads, entry});
+    return entry;
+  }
+
+  void clear() {
+    UniqueWriteLock<ReadWriteMutex> lock(rwmutex_);
+    entries_.clear();
+    hits_ = 0;
+    misses_ = 0;
+  }
+
+  Stats get_stats() {
+    UniqueReadLock<ReadWriteMutex> lock(rwmutex_);
+    return {hits_, misses_, entries_.size()};
+  }
+
+ private:
+  struct CachedEntry {
+    int num_threads;
+    std::shared_ptr<const Entry> entry;
+  };
+
+  ReadWriteMutex rwmutex_;
+  std::deque<CachedEntry> entries_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <ATen/ATen.h>
+#include "utils.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace kernel {
+
+#if defined(CPU_CAPABILITY_AVX2)
+template <typename T>
+std::pair<float, float> _add_and_compute_mean_var(
+    const T* a_ptr,
+    const T* b_ptr,
+    const int& size,
+    float* out) {
+  // compute add and mean/var of the value after add
+  // we should firstly store add value
+  auto vec_acc_mean = _mm256_set1_ps(0.0);
+  auto vec_acc_pow = _mm256_set1_ps(0.0);
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_a = _loadu(a_ptr + i);
+    auto vec_b = _loadu(b_ptr + i);
+    auto vec_add = _mm256_add_ps(vec_a, vec_b);
+    vec_acc_mean = _mm256_add_ps(vec_add, vec_acc_mean);
+    _mm256_storeu_ps(out + i, vec_add);
+    vec_acc_pow = _mm256_fmadd_ps(vec_add, vec_add, vec_acc_pow);
+  }
+
+  if (i < size) {
+    auto vec_a = _maskz_loadu(a_ptr + i, size - i);
+    auto vec_b = _maskz_loadu(b_ptr + i, size - i);
+    auto vec_add = _mm256_add_ps(vec_a, vec_b);
+    vec_acc_mean = _mm256_add_ps(vec_add, vec_acc_mean);
+    _mask_storeu(out + i, vec_add, size - i);
+    vec_acc_pow = _mm256_fmadd_ps(vec_add, vec_add, vec_acc_pow);
+  }
+  float mean_var = _reduce_add_ps(vec_acc_mean) / float(size);
+  float var_val = _reduce_add_ps(vec_acc_pow);
+  return std::make_pair(mean_var, var_val);
+}
+
+template <typename T, typename T1>
+void _normalize_kernel(
+    T* out_ptr,
+    const float* input_ptr,
+    const int& size,
+    float scale,
+    float bias,
+    const T1* gamma_ptr,
+    const T1* beta_ptr) {
+  auto vec_one = _mm256_set1_ps(1.0);
+  auto vec_zero = _mm256_set1_ps(0.0);
+  auto vec_scale = _mm256_set1_ps(scale);
+  auto vec_bias = _mm256_set1_ps(bias);
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_input = _loadu(input_ptr + i);
+    auto vec_gamma = vec_one;
+    auto vec_beta = vec_zero;
+    if (gamma_ptr) {
+      vec_gamma = _loadu(gamma_ptr + i);
+    }
+    if (beta_ptr) {
+      vec_beta = _loadu(beta_ptr + i);
+    }
+    //(a_ptr[i] * scale + bias) * gamma + beta;
+    auto vec_norm = _mm256_fmadd_ps(vec_input, vec_scale, vec_bias);
+    auto vec_res = _mm256_fmadd_ps(vec_norm, vec_gamma, vec_beta);
+    _storeu(out_ptr + i, vec_res);
+  }
+  if (i < size) {
+    auto vec_input = _maskz_loadu(input_ptr + i, size - i);
+    auto vec_gamma = vec_one;
+    auto vec_beta = vec_zero;
+    if (gamma_ptr) {
+      vec_gamma = _maskz_loadu(gamma_ptr + i, size - i);
+    }
+    if (beta_ptr) {
+      vec_beta = _maskz_loadu(beta_ptr + i, size - i);
+    }
+    //(a_ptr[i] * scale + bias) * gamma + beta;
+    auto vec_norm = _mm256_fmadd_ps(vec_input, vec_scale, vec_bias);
+    auto vec_res = _mm256_fmadd_ps(vec_norm, vec_gamma, vec_beta);
+    _mask_storeu(out_ptr + i, vec_res, size - i);
+  }
+}
+#endif
+
+} // namespace kernel
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <ATen/ATen.h>
+#include <limits>
+#include "utils.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace kernel {
+
+#if defined(CPU_CAPABILITY_AVX2)
+inline __m256 _dil_exp_kernel(__m256 vec_src) {
+  auto vec_factorial_1 = _mm256_set1_ps(0.999999701f); // 1/factorial(1)
+  auto vec_factorial_2 = _mm256_set1_ps(0.499991506f); // 1/factorial(2)
+  auto vec_factorial_3 = _mm256_set1_ps(0.166676521f); // 1/factorial(3)
+  auto vec_factorial_4 = _mm256_set1_ps(0.0418978221f); // 1/factorial(4)
+  auto vec_factorial_5 = _mm256_set1_ps(0.00828929059f); // 1/factorial(5)
+  auto vec_exp_log2ef =
+      _mm256_castsi256_ps(_mm256_set1_epi32(0x3fb8aa3b)); // log2(e)
+  auto vec_half = _mm256_set1_ps(0.5f);
+  auto vec_one = _mm256_set1_ps(1.f);
+  auto vec_zero = _mm256_set1_ps(0.f);
+  auto vec_two = _mm256_set1_ps(2.f);
+  auto vec_ln2f = _mm256_castsi256_ps(_mm256_set1_epi32(0x3f317218)); // ln(2)
+  auto vec_ln_flt_min = _mm256_castsi256_ps(_mm256_set1_epi32(0xc2aeac50));
+  auto vec_ln_flt_max = _mm256_castsi256_ps(_mm256_set1_epi32(0x42b17218));
+  auto vec_127 = _mm256_set1_epi32(0x0000007f);
+  const int n_mantissa_bits = 23;
+
+  // exp(x) =
+  // = exp(n * ln(2) + r) // divide x by ln(2) and get quot and rem
+  // = 2^n * exp(r) // simplify the exp(n*ln(2)) expression
+
+  auto less_ln_flt_min_mask =
+      _mm256_cmp_ps(vec_src, vec_ln_flt_min, _CMP_LT_OS);
+  vec_src = _mm256_min_ps(vec_src, vec_ln_flt_max);
+  vec_src = _mm256_max_ps(vec_src, vec_ln_flt_min);
+
+  // fx = floorf(x * log2ef + 0.5)
+  auto vec_fx = _mm256_fmadd_ps(vec_src, vec_exp_log2ef, vec_half);
+  vec_fx = _mm256_floor_ps(vec_fx);
+
+  // x = x - fx * ln2
+  auto vec_exp_poly = _mm256_fnmadd_ps(vec_fx, vec_ln2f, vec_src);
+
+  // compute polynomial
+  auto vec_res =
+      _mm256_fmadd_ps(vec_exp_poly, vec_factorial_5, vec_factorial_4);
+  vec_res = _mm256_fmadd_ps(vec_exp_poly, vec_res, vec_factorial_3);
+  vec_res = _mm256_fmadd_ps(vec_exp_poly, vec_res, vec_factorial_2);
+  vec_res = _mm256_fmadd_ps(vec_exp_poly, vec_res, vec_factorial_1);
+  vec_res = _mm256_fmadd_ps(vec_exp_poly, vec_res, vec_one);
+
+  // compute 2^(n-1)
+  auto vec_exp_number = _mm256_sub_ps(vec_fx, vec_one);
+  auto vec_exp_number_i = _mm256_cvtps_epi32(vec_exp_number);
+  auto vec_two_pow_n_i = _mm256_add_epi32(vec_exp_number_i, vec_127);
+  vec_two_pow_n_i = _mm256_slli_epi32(vec_two_pow_n_i, n_mantissa_bits);
+  auto vec_two_pow_n = _mm256_castsi256_ps(vec_two_pow_n_i);
+  vec_two_pow_n =
+      _mm256_blendv_ps(vec_two_pow_n, vec_zero, less_ln_flt_min_mask);
+
+  // y = y * 2^n
+  vec_res = _mm256_mul_ps(vec_res, vec_two_pow_n);
+  vec_res = _mm256_mul_ps(vec_res, vec_two);
+  return vec_res;
+}
+
+// The max of the valid lanes of the tail, the others keep vec_max.
+inline __m256 _tail_max_ps(__m256 vec_max, __m256 vec_src, int count) {
+  auto mask = _mm256_castsi256_ps(_tail_mask(count));
+  return _mm256_blendv_ps(vec_max, _mm256_max_ps(vec_max, vec_src), mask);
+}
+
+// Initialized with the lowest float rather than FLT_MIN, see the note in
+// vec512/perf_kernel/add_softmax.h.
+template <typename scalar_a, typename scalar_b>
+inline void _dil_div_add_reduce_max_fusion_kernel(
+    const scalar_a* a,
+    const scalar_b* b,
+    const float& dim_per_head,
+    const int& size,
+    float* out,
+    float& max) {
+  auto vec_ps_min = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+  auto vec_r_dim_per_head = _mm256_set1_ps(1.0 / dim_per_head);
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_a = _loadu(a + i);
+    auto vec_b = _loadu(b + i);
+    auto vec_out = _mm256_fmadd_ps(vec_a, vec_r_dim_per_head, vec_b);
+    vec_ps_min = _mm256_max_ps(vec_ps_min, vec_out);
+    _mm256_storeu_ps(out + i, vec_out);
+  }
+
+  if (i < size) {
+    auto vec_a = _maskz_loadu(a + i, size - i);
+    auto vec_b = _maskz_loadu(b + i, size - i);
+    auto vec_out = _mm256_fmadd_ps(vec_a, vec_r_dim_per_head, vec_b);
+    vec_ps_min = _tail_max_ps(vec_ps_min, vec_out, size - i);
+    _mask_storeu(out + i, vec_out, size - i);
+  }
+
+  max = _reduce_max_ps(vec_ps_min);
+}
+
+template <typename scalar_t>
+inline void _dil_maskedfill_div_max_fusion_kernel(
+    const scalar_t* a,
+    const float* b,
+    const float& fill_value,
+    const float& dim_per_head,
+    const int& size,
+    float* out,
+    float& max) {
+  auto vec_fill = _mm256_set1_ps(fill_value);
+  auto vec_ps_min = vec_fill;
+  auto mask_c = _mm256_set1_ps(1.0);
+  auto vec_dim_per_head = _mm256_set1_ps(dim_per_head);
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_a = _loadu(a + i);
+    auto vec_b = _loadu(b + i);
+    auto fill_mask = _mm256_cmp_ps(vec_b, mask_c, _CMP_NEQ_OQ);
+    auto vec_out = _mm256_blendv_ps(
+        vec_fill, _mm256_div_ps(vec_a, vec_dim_per_head), fill_mask);
+    vec_ps_min = _mm256_max_ps(vec_ps_min, vec_out);
+    _mm256_storeu_ps(out + i, vec_out);
+  }
+
+  if (i < size) {
+    auto vec_a = _maskz_loadu(a + i, size - i);
+    auto vec_b = _maskz_loadu(b + i, size - i);
+    auto fill_mask = _mm256_cmp_ps(vec_b, mask_c, _CMP_NEQ_OQ);
+    auto vec_out = _mm256_blendv_ps(
+        vec_fill, _mm256_div_ps(vec_a, vec_dim_per_head), fill_mask);
+    vec_ps_min = _tail_max_ps(vec_ps_min, vec_out, size - i);
+    _mask_storeu(out + i, vec_out, size - i);
+  }
+
+  max = _reduce_max_ps(vec_ps_min);
+}
+
+inline void _dil_exp_reduce_sum_fusion_kernel(
+    float* a,
+    const int& size,
+    float* out,
+    float& val) {
+  auto vec_max = _mm256_set1_ps(val);
+  auto vec_sum = _mm256_set1_ps(0.f);
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_a = _mm256_loadu_ps(a + i);
+    auto vec_out = _mm256_sub_ps(vec_a, vec_max);
+    vec_out = _dil_exp_kernel(vec_out);
+    vec_sum = _mm256_add_ps(vec_sum, vec_out);
+    _mm256_storeu_ps(out + i, vec_out);
+  }
+
+  if (i < size) {
+    auto mask = _mm256_castsi256_ps(_tail_mask(size - i));
+    auto vec_a = _maskz_loadu(a + i, size - i);
+    auto vec_out = _mm256_sub_ps(vec_a, vec_max);
+    vec_out = _dil_exp_kernel(vec_out);
+    vec_sum = _mm256_add_ps(vec_sum, _mm256_and_ps(vec_out, mask));
+    _mask_storeu(out + i, vec_out, size - i);
+  }
+
+  val = _reduce_add_ps(vec_sum);
+}
+
+template <typename scalar_t>
+inline void _dil_normalization_kernel(
+    const float* a,
+    const float& sum,
+    const int& size,
+    scalar_t* out) {
+  auto vec_sum = _mm256_set1_ps(sum);
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_a = _mm256_loadu_ps(a + i);
+    auto vec_out = _mm256_div_ps(vec_a, vec_sum);
+    _storeu(out + i, vec_out);
+  }
+
+  if (i < size) {
+    auto vec_a = _maskz_loadu(a + i, size - i);
+    auto vec_out = _mm256_div_ps(vec_a, vec_sum);
+    _mask_storeu(out + i, vec_out, size - i);
+  }
+}
+
+template <typename scalar_t>
+inline void _dil_add_kernel(const scalar_t* src, float* dst, const int& size) {
+  int j = 0;
+  for (; j <= size - 8; j += 8) {
+    auto vec_a = _loadu(src + j);
+    auto vec_out = _mm256_add_ps(vec_a, _loadu(dst + j));
+    _storeu(dst + j, vec_out);
+  }
+
+  if (j < size) {
+    auto vec_a = _maskz_loadu(src + j, size - j);
+    auto vec_out = _mm256_add_ps(vec_a, _maskz_loadu(dst + j, size - j));
+    _mask_storeu(dst + j, vec_out, size - j);
+  }
+}
+
+inline void _dil_add_reduce_max_fusion_kernel(
+    float* a,
+    const float* b,
+    const int& size,
+    float* out,
+    float& max) {
+  auto vec_ps_min = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_out = _mm256_add_ps(_loadu(a + i), _loadu(b + i));
+    vec_ps_min = _mm256_max_ps(vec_ps_min, vec_out);
+    _mm256_storeu_ps(out + i, vec_out);
+  }
+
+  if (i < size) {
+    auto vec_a = _maskz_loadu(a + i, size - i);
+    auto vec_b = _maskz_loadu(b + i, size - i);
+    auto vec_out = _mm256_add_ps(vec_a, vec_b);
+    vec_ps_min = _tail_max_ps(vec_ps_min, vec_out, size - i);
+    _mask_storeu(out + i, vec_out, size - i);
+  }
+
+  max = _reduce_max_ps(vec_ps_min);
+}
+
+inline void _dil_reduce_max_fusion_kernel(
+    const float* a,
+    const int& size,
+    float* out,
+    float& max) {
+  auto vec_ps_min = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_out = _loadu(a + i);
+    vec_ps_min = _mm256_max_ps(vec_ps_min, vec_out);
+    _mm256_storeu_ps(out + i, vec_out);
+  }
+
+  if (i < size) {
+    auto vec_out = _maskz_loadu(a + i, size - i);
+    vec_ps_min = _tail_max_ps(vec_ps_min, vec_out, size - i);
+    _mask_storeu(out + i, vec_out, size - i);
+  }
+
+  max = _reduce_max_ps(vec_ps_min);
+}
+
+inline void _dil_mul_reduce_max_fusion_kernel(
+    const float* a,
+    const float& scale,
+    const int& size,
+    float* out,
+    float& max) {
+  auto vec_ps_min = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+  auto vec_scale = _mm256_set1_ps(scale);
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_out = _mm256_mul_ps(_loadu(a + i), vec_scale);
+    vec_ps_min = _mm256_max_ps(vec_ps_min, vec_out);
+    _mm256_storeu_ps(out + i, vec_out);
+  }
+
+  if (i < size) {
+    auto vec_a = _maskz_loadu(a + i, size - i);
+    auto vec_out = _mm256_mul_ps(vec_a, vec_scale);
+    vec_ps_min = _tail_max_ps(vec_ps_min, vec_out, size - i);
+    _mask_storeu(out + i, vec_out, size - i);
+  }
+
+  max = _reduce_max_ps(vec_ps_min);
+}
+
+inline void _init_mha_buffer_kernel(float* max, float* sum, const int& size) {
+  auto vec_ps_min = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+  auto vec_zeros = _mm256_setzero_ps();
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    _storeu(max + i, vec_ps_min);
+    _storeu(sum + i, vec_zeros);
+  }
+  if (i < size) {
+    _mask_storeu(max + i, vec_ps_min, size - i);
+    _mask_storeu(sum + i, vec_zeros, size - i);
+  }
+}
+
+/**
+ * This kernel is used to reorder the data type of the MHA output
+ * from FP32 to BF16 with strides.
+ * src: MKL BF16 GEMM output buffer, dtype - FP32
+ * dst: Final MHA output, dtype - BF16
+ */
+template <typename scalar_t>
+inline void _reorder_mha_output_kernel(
+    float* src,
+    scalar_t* dst,
+    const int& rows,
+    const int& cols,
+    const int& dst_stride) {
+  for (int i = 0; i < rows; ++i) {
+    int j = 0;
+    for (; j <= cols - 8; j += 8) {
+      _storeu(dst + i * dst_stride + j, _loadu(src + i * cols + j));
+    }
+    if (j < cols) {
+      _mask_storeu(
+          dst + i * dst_stride + j,
+          _maskz_loadu(src + i * cols + j, cols - j),
+          cols - j);
+    }
+  }
+}
+
+/**
+ * This kernel is used to update the MHA output with the latest MAX
+ * and SUM values block by block, see the vec512 version:
+ * a = a * sum_old / sum_new * exp_val
+ */
+inline void _mha_update_sum_max_kernel(
+    const float* a,
+    const float& sum_old,
+    const float& sum_new,
+    const float& exp_val,
+    const int& size,
+    float* out) {
+  auto vec_sum_old = _mm256_set1_ps(sum_old);
+  auto vec_sum_new = _mm256_set1_ps(sum_new);
+  auto vec_sum_cor = _mm256_div_ps(vec_sum_old, vec_sum_new);
+  auto exp_vec = _mm256_set1_ps(exp_val);
+
+  int i = 0;
+  for (; i <= size - 8; i += 8) {
+    auto vec_a = _mm256_mul_ps(_loadu(a + i), vec_sum_cor);
+    auto vec_out = _mm256_mul_ps(vec_a, exp_vec);
+    _storeu(out + i, vec_out);
+  }
+  if (i < size) {
+    auto vec_a = _mm256_mul_ps(_maskz_loadu(a + i, size - i), vec_sum_cor);
+    auto vec_out = _mm256_mul_ps(vec_a, exp_vec);
+    _mask_storeu(out + i, vec_out, size - i);
+  }
+}
+#endif
+
+} // namespace kernel
+} // namespace cpu
+} // namespace torch_ipex
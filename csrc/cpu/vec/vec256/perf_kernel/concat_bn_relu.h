@@ -0,0 +1,59 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include "utils.h"
+
+#if defined(CPU_CAPABILITY_AVX2)
+// use float as accumulation type for BFloat16
+template <typename scalar_t>
+struct AccType {
+  using type = scalar_t;
+};
+template <>
+struct AccType<at::BFloat16> {
+  using type = float;
+};
+
+namespace torch_ipex {
+namespace cpu {
+namespace kernel {
+
+// The channels of every input are a multiple of 16, see
+// concat_bn_relu_kernel_impl, so there is no tail of the 8-wide vectors.
+template <typename T, typename ACC_T>
+static void _concat_bn_relu_kernel_channels_last(
+    const std::vector<const T*>& in_ptr,
+    const std::vector<int64_t>& in_ch,
+    T* out_ptr,
+    const ACC_T* scale_ptr,
+    const ACC_T* beta_ptr,
+    int64_t total_size_except_channels,
+    int64_t ci,
+    int64_t co) {
+  auto zero = _mm256_set1_ps(0.0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule( \
+    static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
+#endif
+  for (int64_t i = 0; i < total_size_except_channels; ++i) {
+    for (int64_t j = 0; j < in_ptr.size(); ++j) {
+      auto concat_in_ptr = in_ptr[j] + i * in_ch[j + 1] - (i + 1) * in_ch[j];
+      for (int64_t k = in_ch[j]; k < in_ch[j + 1]; k += 8) {
+        auto in = _loadu(concat_in_ptr + k);
+        auto beta = _mm256_loadu_ps(beta_ptr + k);
+        auto scale = _mm256_loadu_ps(scale_ptr + k);
+        auto bn_out = _mm256_fmadd_ps(scale, in, beta);
+        auto out = _mm256_max_ps(zero, bn_out);
+        _storeu(out_ptr + i * co + k, out);
+      }
+    }
+  }
+}
+
+} // namespace kernel
+} // namespace cpu
+} // namespace torch_ipex
+#endif
@@ -0,0 +1,6 @@
+#include "add_layernorm.h"
+#include "add_softmax.h"
+#include "concat_bn_relu.h"
+#include "rmsnorm.h"
+#include "sparse_linear.h"
+#include "update_batch.h"
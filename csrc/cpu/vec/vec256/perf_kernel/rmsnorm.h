@@ -0,0 +1,57 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <immintrin.h>
+#include "utils.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace kernel {
+
+#if defined(CPU_CAPABILITY_AVX2)
+template <typename T, typename T1>
+void _compute_rmsnorm(
+    const T* a_ptr,
+    const int& size,
+    float eps,
+    const T1* gamma_ptr,
+    T* out_ptr) {
+  auto vec_acc_pow = _mm256_set1_ps(0.0);
+  int i;
+  for (i = 0; i <= size - 8; i += 8) {
+    auto vec_a = _loadu(a_ptr + i);
+    vec_acc_pow = _mm256_fmadd_ps(vec_a, vec_a, vec_acc_pow);
+  }
+  if (i < size) {
+    auto vec_a = _maskz_loadu(a_ptr + i, size - i);
+    vec_acc_pow = _mm256_fmadd_ps(vec_a, vec_a, vec_acc_pow);
+  }
+  float var_val = _reduce_add_ps(vec_acc_pow) / static_cast<float>(size);
+  float scale = float(1.0) / std::sqrt(var_val + eps);
+  auto vec_scale = _mm256_set1_ps(scale);
+  for (i = 0; i <= size - 8; i += 8) {
+    auto vec_input = _loadu(a_ptr + i);
+    auto vec_gamma = _mm256_set1_ps(1.0);
+    if (gamma_ptr) {
+      vec_gamma = _loadu(gamma_ptr + i);
+    }
+    auto vec_res =
+        _mm256_mul_ps(_mm256_mul_ps(vec_input, vec_scale), vec_gamma);
+    _storeu(out_ptr + i, vec_res);
+  }
+  if (i < size) {
+    auto vec_input = _maskz_loadu(a_ptr + i, size - i);
+    auto vec_gamma = _mm256_set1_ps(1.0);
+    if (gamma_ptr) {
+      vec_gamma = _maskz_loadu(gamma_ptr + i, size - i);
+    }
+    auto vec_res =
+        _mm256_mul_ps(_mm256_mul_ps(vec_input, vec_scale), vec_gamma);
+    _mask_storeu(out_ptr + i, vec_res, size - i);
+  }
+}
+#endif
+
+} // namespace kernel
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <immintrin.h>
+#include <algorithm>
+#include "utils.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace kernel {
+
+#if defined(CPU_CAPABILITY_AVX2)
+// The rows of the input computed together, so that every load of the weights
+// is used for all of them.
+constexpr int SPARSE_LINEAR_ROWS = 4;
+
+// The output blocks of 16 features are computed as two vectors of 8.
+template <typename T, int ROWS>
+inline void _sparse_linear_block_rows(
+    const float* x,
+    int64_t ldx,
+    int64_t K,
+    const T* values,
+    const int32_t* indices,
+    int64_t begin,
+    int64_t end,
+    int64_t block_k,
+    const float* bias,
+    T* out,
+    int64_t ldo,
+    int64_t n_valid) {
+  __m256 acc_lo[ROWS];
+  __m256 acc_hi[ROWS];
+  auto vec_bias_lo = bias ? _mm256_loadu_ps(bias) : _mm256_setzero_ps();
+  auto vec_bias_hi = bias ? _mm256_loadu_ps(bias + 8) : _mm256_setzero_ps();
+  for (int r = 0; r < ROWS; r++) {
+    acc_lo[r] = vec_bias_lo;
+    acc_hi[r] = vec_bias_hi;
+  }
+  for (int64_t j = begin; j < end; j++) {
+    const int64_t k0 = indices[j] * block_k;
+    const int64_t kc = std::min(block_k, K - k0);
+    const T* w_ptr = values + j * block_k * 16;
+    const float* x_ptr = x + k0;
+    for (int64_t k = 0; k < kc; k++) {
+      auto vec_w_lo = _loadu(w_ptr + k * 16);
+      auto vec_w_hi = _loadu(w_ptr + k * 16 + 8);
+      for (int r = 0; r < ROWS; r++) {
+        auto vec_x = _mm256_set1_ps(x_ptr[r * ldx + k]);
+        acc_lo[r] = _mm256_fmadd_ps(vec_x, vec_w_lo, acc_lo[r]);
+        acc_hi[r] = _mm256_fmadd_ps(vec_x, vec_w_hi, acc_hi[r]);
+      }
+    }
+  }
+  for (int r = 0; r < ROWS; r++) {
+    if (n_valid >= 16) {
+      _storeu(out + r * ldo, acc_lo[r]);
+      _storeu(out + r * ldo + 8, acc_hi[r]);
+    } else if (n_valid > 8) {
+      _storeu(out + r * ldo, acc_lo[r]);
+      _mask_storeu(out + r * ldo + 8, acc_hi[r], n_valid - 8);
+    } else {
+      _mask_storeu(out + r * ldo, acc_lo[r], n_valid);
+    }
+  }
+}
+
+// Each group of 4 inputs is broadcast to both 128 bits lanes and the 2
+// stored slots of each output pick their input with a permute by the
+// position in the group. The two halves of the output block are computed one
+// after the other to keep the weights and the positions in registers.
+template <typename T, int ROWS>
+inline void _sparse_linear_two_four_rows(
+    const float* x,
+    int64_t ldx,
+    int64_t K,
+    const T* values,
+    const uint8_t* indices,
+    const float* bias,
+    T* out,
+    int64_t ldo,
+    int64_t n_valid) {
+  for (int64_t h = 0; h < n_valid; h += 8) {
+    __m256 acc[ROWS];
+    auto vec_bias = bias ? _mm256_loadu_ps(bias + h) : _mm256_setzero_ps();
+    for (int r = 0; r < ROWS; r++) {
+      acc[r] = vec_bias;
+    }
+    for (int64_t g = 0; g < K / 4; g++) {
+      const T* w_ptr = values + g * 2 * 16 + h;
+      const uint8_t* idx_ptr = indices + g * 2 * 16 + h;
+      auto vec_w0 = _loadu(w_ptr);
+      auto vec_w1 = _loadu(w_ptr + 16);
+      auto vec_idx0 = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(idx_ptr)));
+      auto vec_idx1 = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(idx_ptr + 16)));
+      for (int r = 0; r < ROWS; r++) {
+        auto vec_x = _mm256_broadcast_ps(
+            reinterpret_cast<const __m128*>(x + r * ldx + g * 4));
+        acc[r] = _mm256_fmadd_ps(
+            _mm256_permutevar8x32_ps(vec_x, vec_idx0), vec_w0, acc[r]);
+        acc[r] = _mm256_fmadd_ps(
+            _mm256_permutevar8x32_ps(vec_x, vec_idx1), vec_w1, acc[r]);
+      }
+    }
+    for (int r = 0; r < ROWS; r++) {
+      if (n_valid - h >= 8) {
+        _storeu(out + r * ldo + h, acc[r]);
+      } else {
+        _mask_storeu(out + r * ldo + h, acc[r], n_valid - h);
+      }
+    }
+  }
+}
+#endif
+
+} // namespace kernel
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <ATen/ATen.h>
+#include <cstring>
+
+#if defined(CPU_CAPABILITY_AVX2)
+
+// The AVX2 counterparts of the helpers in vec512/perf_kernel/utils.h. A
+// vector holds 8 floats and the tail helpers take the number of valid
+// elements instead of a mask register.
+
+// All the bits set in the first count lanes.
+inline __m256i _tail_mask(int count) {
+  return _mm256_cmpgt_epi32(
+      _mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+inline __m256 cvt_bf16_to_fp32(const __m128i src) {
+  auto y = _mm256_cvtepu16_epi32(src);
+  return _mm256_castsi256_ps(_mm256_slli_epi32(y, 16));
+}
+
+inline __m128i cvt_fp32_to_bf16(const __m256 src) {
+  // round to nearest even, as cvt_fp32_to_bf16 of vec512 does
+  auto value = _mm256_castps_si256(src);
+  auto ones = _mm256_set1_epi32(0x1);
+  auto vec_bias = _mm256_set1_epi32(0x7fff);
+  auto t_value = _mm256_and_si256(_mm256_srli_epi32(value, 16), ones);
+  t_value = _mm256_add_epi32(t_value, vec_bias);
+  t_value = _mm256_add_epi32(t_value, value);
+  t_value = _mm256_srli_epi32(t_value, 16);
+  // keep NaN a NaN
+  auto nan_mask = _mm256_castps_si256(_mm256_cmp_ps(src, src, _CMP_UNORD_Q));
+  t_value = _mm256_blendv_epi8(t_value, _mm256_set1_epi32(0x7fc0), nan_mask);
+  return _mm_packus_epi32(
+      _mm256_castsi256_si128(t_value), _mm256_extracti128_si256(t_value, 1));
+}
+
+inline __m256 cvt_fp16_to_fp32(const __m128i src) {
+  return _mm256_cvtph_ps(src);
+}
+
+inline __m128i cvt_fp32_to_fp16(const __m256 src) {
+  return _mm256_cvtps_ph(src, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+
+// There is no masked load or store of 16-bit elements in AVX2, the tails of
+// the bfloat16 and half data go through a buffer.
+template <typename T>
+inline __m128i _maskz_loadu_epi16(const T* data_base, int count) {
+  alignas(16) uint16_t buffer[8] = {0};
+  std::memcpy(buffer, data_base, count * sizeof(T));
+  return _mm_load_si128((const __m128i*)buffer);
+}
+
+template <typename T>
+inline void _mask_storeu_epi16(T* data_base, __m128i a, int count) {
+  alignas(16) uint16_t buffer[8];
+  _mm_store_si128((__m128i*)buffer, a);
+  std::memcpy(data_base, buffer, count * sizeof(T));
+}
+
+// below is for unaligned data load
+inline __m256 _loadu(const float* data_base) {
+  return _mm256_loadu_ps(data_base);
+}
+
+inline __m256 _loadu(const at::BFloat16* data_base) {
+  return cvt_bf16_to_fp32(_mm_loadu_si128((const __m128i*)data_base));
+}
+
+inline __m256 _loadu(const at::Half* data_base) {
+  return cvt_fp16_to_fp32(_mm_loadu_si128((const __m128i*)data_base));
+}
+
+inline __m256 _maskz_loadu(const float* data_base, int count) {
+  return _mm256_maskload_ps(data_base, _tail_mask(count));
+}
+
+inline __m256 _maskz_loadu(const at::BFloat16* data_base, int count) {
+  return cvt_bf16_to_fp32(_maskz_loadu_epi16(data_base, count));
+}
+
+inline __m256 _maskz_loadu(const at::Half* data_base, int count) {
+  return cvt_fp16_to_fp32(_maskz_loadu_epi16(data_base, count));
+}
+
+// below is for unaligned data store
+inline void _storeu(float* data_base, __m256 a) {
+  _mm256_storeu_ps(data_base, a);
+}
+
+inline void _storeu(at::BFloat16* data_base, __m256 a) {
+  _mm_storeu_si128((__m128i*)data_base, cvt_fp32_to_bf16(a));
+}
+
+inline void _storeu(at::Half* data_base, __m256 a) {
+  _mm_storeu_si128((__m128i*)data_base, cvt_fp32_to_fp16(a));
+}
+
+inline void _mask_storeu(float* data_base, __m256 a, int count) {
+  _mm256_maskstore_ps(data_base, _tail_mask(count), a);
+}
+
+inline void _mask_storeu(at::BFloat16* data_base, __m256 a, int count) {
+  _mask_storeu_epi16(data_base, cvt_fp32_to_bf16(a), count);
+}
+
+inline void _mask_storeu(at::Half* data_base, __m256 a, int count) {
+  _mask_storeu_epi16(data_base, cvt_fp32_to_fp16(a), count);
+}
+
+// below is for the horizontal reductions, which are not instructions in AVX2
+inline float _reduce_add_ps(__m256 a) {
+  auto x = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+  x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+  x = _mm_add_ss(x, _mm_movehdup_ps(x));
+  return _mm_cvtss_f32(x);
+}
+
+inline float _reduce_max_ps(__m256 a) {
+  auto x = _mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+  x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+  x = _mm_max_ss(x, _mm_movehdup_ps(x));
+  return _mm_cvtss_f32(x);
+}
+
+#endif
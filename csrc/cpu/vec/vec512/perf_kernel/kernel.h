@@ -3,4 +3,5 @@
 #include "add_swish.h"
 #include "concat_bn_relu.h"
 #include "rmsnorm.h"
+#include "sparse_linear.h"
 #include "update_batch.h"
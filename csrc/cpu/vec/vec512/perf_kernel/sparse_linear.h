@@ -0,0 +1,102 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <immintrin.h>
+#include <algorithm>
+#include "utils.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace kernel {
+
+// The rows of the input computed together, so that every load of the weights
+// is used for all of them.
+constexpr int SPARSE_LINEAR_ROWS = 4;
+
+// One output block of 16 features for ROWS rows of the float input x, with
+// the stored blocks [begin, end) of the BCSR weight in aten/SparseLinear.h.
+// The blocks of zeros are not stored, so they are skipped.
+template <typename T, int ROWS>
+inline void _sparse_linear_block_rows(
+    const float* x,
+    int64_t ldx,
+    int64_t K,
+    const T* values,
+    const int32_t* indices,
+    int64_t begin,
+    int64_t end,
+    int64_t block_k,
+    const float* bias,
+    T* out,
+    int64_t ldo,
+    int64_t n_valid) {
+  __m512 acc[ROWS];
+  auto vec_bias = bias ? _mm512_loadu_ps(bias) : _mm512_setzero_ps();
+  for (int r = 0; r < ROWS; r++) {
+    acc[r] = vec_bias;
+  }
+  for (int64_t j = begin; j < end; j++) {
+    const int64_t k0 = indices[j] * block_k;
+    const int64_t kc = std::min(block_k, K - k0);
+    const T* w_ptr = values + j * block_k * 16;
+    const float* x_ptr = x + k0;
+    for (int64_t k = 0; k < kc; k++) {
+      auto vec_w = _loadu(w_ptr + k * 16);
+      for (int r = 0; r < ROWS; r++) {
+        acc[r] = _mm512_fmadd_ps(
+            _mm512_set1_ps(x_ptr[r * ldx + k]), vec_w, acc[r]);
+      }
+    }
+  }
+  __mmask16 mask = (1 << n_valid) - 1;
+  for (int r = 0; r < ROWS; r++) {
+    _mask_storeu(out + r * ldo, acc[r], mask);
+  }
+}
+
+// One output block of 16 features for ROWS rows of the float input x, with
+// the 2:4 weight of the block in aten/SparseLinear.h. Each group of 4 inputs
+// is broadcast to the 4 lanes of every 128 bits and the 2 stored slots of
+// each output pick their input with a permute by the position in the group.
+template <typename T, int ROWS>
+inline void _sparse_linear_two_four_rows(
+    const float* x,
+    int64_t ldx,
+    int64_t K,
+    const T* values,
+    const uint8_t* indices,
+    const float* bias,
+    T* out,
+    int64_t ldo,
+    int64_t n_valid) {
+  __m512 acc[ROWS];
+  auto vec_bias = bias ? _mm512_loadu_ps(bias) : _mm512_setzero_ps();
+  for (int r = 0; r < ROWS; r++) {
+    acc[r] = vec_bias;
+  }
+  for (int64_t g = 0; g < K / 4; g++) {
+    const T* w_ptr = values + g * 2 * 16;
+    const uint8_t* idx_ptr = indices + g * 2 * 16;
+    auto vec_w0 = _loadu(w_ptr);
+    auto vec_w1 = _loadu(w_ptr + 16);
+    auto vec_idx0 = _mm512_cvtepu8_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx_ptr)));
+    auto vec_idx1 = _mm512_cvtepu8_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx_ptr + 16)));
+    for (int r = 0; r < ROWS; r++) {
+      auto vec_x = _mm512_broadcast_f32x4(_mm_loadu_ps(x + r * ldx + g * 4));
+      acc[r] = _mm512_fmadd_ps(
+          _mm512_permutexvar_ps(vec_idx0, vec_x), vec_w0, acc[r]);
+      acc[r] = _mm512_fmadd_ps(
+          _mm512_permutexvar_ps(vec_idx1, vec_x), vec_w1, acc[r]);
+    }
+  }
+  __mmask16 mask = (1 << n_valid) - 1;
+  for (int r = 0; r < ROWS; r++) {
+    _mask_storeu(out + r * ldo, acc[r], mask);
+  }
+}
+
+} // namespace kernel
+} // namespace cpu
+} // namespace torch_ipex
@@ -1,9 +1,15 @@
 from .task import Task
-from .cpupool import pin, CPUPool, is_runtime_ext_enabled
+from .cpupool import pin, CPUPool, create_cpu_pools, is_runtime_ext_enabled
 from .multi_stream import (
     MultiStreamModule,
     get_default_num_streams,
     MultiStreamModuleHint,
     _MultiStreamBenchmarkModule,
 )
-from .runtime_utils import get_core_list_of_node_id
+from .multi_instance import MultiInstanceModule
+from .runtime_utils import (
+    get_core_list_of_node_id,
+    get_core_lists_of_l3_cache,
+    get_numa_node_ids,
+    get_physical_core_list,
+)
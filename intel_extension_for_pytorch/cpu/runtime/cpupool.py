@@ -1,7 +1,11 @@
 import functools
 import warnings
 import intel_extension_for_pytorch as ipex
-from .runtime_utils import get_core_list_of_node_id
+from .runtime_utils import (
+    get_core_list_of_node_id,
+    get_core_lists_of_l3_cache,
+    get_numa_node_ids,
+)
 
 
 class CPUPool(object):
@@ -12,13 +16,19 @@ class CPUPool(object):
         core_ids (list): A list of CPU cores' ids used for intra-op parallelism.
         node_id (int): A numa node id with all CPU cores on the numa node.
             ``node_id`` doesn't work if ``core_ids`` is set.
+        bind_memory (bool): Bind the memory allocated by the threads pinned
+            to this CPU pool to the numa node of its cores. All the cores
+            must locate on one numa node. Default: ``False``.
 
     Returns:
         intel_extension_for_pytorch.cpu.runtime.CPUPool: Generated
         intel_extension_for_pytorch.cpu.runtime.CPUPool object.
     """
 
-    def __init__(self, core_ids: list = None, node_id: int = None):
+    def __init__(
+        self, core_ids: list = None, node_id: int = None, bind_memory: bool = False
+    ):
+        self.bind_memory = bind_memory
         if not ipex._C._has_cpu():
             return
         if core_ids is not None:
@@ -42,12 +52,52 @@ class CPUPool(object):
             # The cores available for current process will change with external numactl cmd.
             self.core_ids = ipex._C.get_process_available_cores()
 
-        self.cpu_pool = ipex._C.CPUPool(self.core_ids)
+        self.cpu_pool = ipex._C.CPUPool(self.core_ids, bind_memory)
         # The actual core ids inside CPUPool may be updated in creation of ipex._C.CPUPool.
         # Since ipex._C.CPUPool will filter out core ids which not available for current process.
         self.core_ids = self.cpu_pool.get_core_list()
 
 
+def create_cpu_pools(
+    granularity: str = "numa_node",
+    physical_cores_only: bool = True,
+    bind_memory: bool = True,
+):
+    r"""
+    Create one CPU pool per numa node or per L3 cache domain of the cores
+    available for current process, e.g. one instance per pool for
+    multi-instance serving.
+
+    Args:
+        granularity (str): ``"numa_node"`` or ``"l3_cache"``.
+            Default: ``"numa_node"``.
+        physical_cores_only (bool): Only use the first hardware thread of each
+            physical core. Default: ``True``.
+        bind_memory (bool): Bind the memory of each CPU pool to the numa node
+            of its cores. Default: ``True``.
+
+    Returns:
+        list: List of intel_extension_for_pytorch.cpu.runtime.CPUPool objects.
+    """
+
+    if granularity == "numa_node":
+        core_lists = [
+            get_core_list_of_node_id(node_id, physical_cores_only)
+            for node_id in get_numa_node_ids()
+        ]
+    elif granularity == "l3_cache":
+        core_lists = get_core_lists_of_l3_cache(physical_cores_only)
+    else:
+        raise ValueError(
+            "granularity should be numa_node or l3_cache, but got {}".format(
+                granularity
+            )
+        )
+    return [
+        CPUPool(core_ids=core_list, bind_memory=bind_memory) for core_list in core_lists
+    ]
+
+
 class pin(object):
     r"""
     Apply the given CPU pool to the master thread that runs the scoped code
@@ -95,8 +145,10 @@ def is_runtime_ext_enabled():
 
     Returns:
         bool: Whether the runtime exetension is enabled or not. If the
-            Intel OpenMP Library is preloaded, this API will return True.
-            Otherwise, it will return False.
+            Intel OpenMP Library is preloaded, the runtime extension uses its
+            affinity API. Otherwise on Linux, it falls back to the native
+            pthread affinity API, which works with any OpenMP runtime (e.g.
+            GNU OpenMP). It returns False only when neither is available.
     """
 
     return ipex._C.is_runtime_ext_enabled() == 1
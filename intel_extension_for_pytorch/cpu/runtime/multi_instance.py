@@ -0,0 +1,59 @@
+import torch
+import intel_extension_for_pytorch as ipex
+from .cpupool import CPUPool, create_cpu_pools
+
+
+class MultiInstanceModule(object):
+    r"""
+    Run several inference instances of one TorchScript module inside current
+    process, one instance per CPU pool. All the instances share the
+    parameters and prepacked weights of the module, so the memory footprint
+    stays the one of a single instance. Requests go into one shared queue and
+    are served by the first idle instance.
+
+    Args:
+        model (torch.jit.ScriptModule): The input module, which should be
+            traced or scripted (and preferably frozen) for inference.
+        cpu_pools (list): List of intel_extension_for_pytorch.cpu.runtime.CPUPool
+            objects, one per instance. Default: one CPU pool per numa node
+            created by ``create_cpu_pools``.
+
+    Returns:
+        intel_extension_for_pytorch.cpu.runtime.MultiInstanceModule: Generated
+        intel_extension_for_pytorch.cpu.runtime.MultiInstanceModule object.
+    """
+
+    def __init__(self, model, cpu_pools: list = None):
+        assert isinstance(
+            model, torch.jit.ScriptModule
+        ), "MultiInstanceModule only supports torch.jit.ScriptModule"
+        if cpu_pools is None:
+            cpu_pools = create_cpu_pools()
+        assert len(cpu_pools) > 0 and all(
+            type(cpu_pool) is CPUPool for cpu_pool in cpu_pools
+        ), "Input of cpu_pools must be a list of ipex.cpu.runtime.CPUPool"
+        self.cpu_pools = cpu_pools
+        self._engine = ipex._C.MultiInstanceEngine(
+            model._c, [cpu_pool.cpu_pool for cpu_pool in cpu_pools]
+        )
+
+    def __call__(self, *args, **kwargs):
+        # async execution
+        return self._engine.run_async(*args, **kwargs)
+
+    def run_sync(self, *args, **kwargs):
+        # sync execution
+        return self._engine.run_async(*args, **kwargs).get()
+
+    def get_num_finished_requests(self):
+        r"""
+        Returns:
+            list: Number of requests each instance has finished.
+        """
+        return self._engine.get_num_finished_requests()
+
+    def stop(self):
+        r"""
+        Finish the queued requests and stop all the instances.
+        """
+        self._engine.stop()
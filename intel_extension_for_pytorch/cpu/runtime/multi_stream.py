@@ -154,7 +154,10 @@ class MultiStreamModule(nn.Module):
                 self.tasks.append(
                     Task(
                         model,
-                        CPUPool(self.core_list[start_core_list_idx:end_core_list_idx]),
+                        CPUPool(
+                            self.core_list[start_core_list_idx:end_core_list_idx],
+                            bind_memory=self.cpu_pool.bind_memory,
+                        ),
                     )
                 )
                 start_core_list_idx = end_core_list_idx
@@ -590,7 +593,10 @@ class _MultiStreamBenchmarkModule(nn.Module):
                 self.tasks.append(
                     Task(
                         model,
-                        CPUPool(self.core_list[start_core_list_idx:end_core_list_idx]),
+                        CPUPool(
+                            self.core_list[start_core_list_idx:end_core_list_idx],
+                            bind_memory=self.cpu_pool.bind_memory,
+                        ),
                     )
                 )
                 start_core_list_idx = end_core_list_idx
@@ -1,4 +1,5 @@
 import subprocess
+import intel_extension_for_pytorch as ipex
 
 
 def get_num_nodes():
@@ -17,22 +18,64 @@ def get_num_cores_per_node():
     )
 
 
-def get_core_list_of_node_id(node_id):
+def get_numa_node_ids():
+    r"""
+    Helper function to get the ids of numa nodes which have CPU cores
+    available for current process.
+
+    Returns:
+        list: Sorted list of numa node ids.
+    """
+
+    return ipex._C.get_numa_node_ids()
+
+
+def get_core_list_of_node_id(node_id, physical_cores_only=True):
     r"""
     Helper function to get the CPU cores' ids of the input numa node.
 
     Args:
         node_id (int): Input numa node id.
+        physical_cores_only (bool): Only return the first hardware thread of
+            each physical core. Default: ``True``.
 
     Returns:
-        list: List of CPU cores' ids on this numa node.
+        list: List of CPU cores' ids on this numa node, which are available
+            for current process.
     """
 
-    num_of_nodes = get_num_nodes()
+    node_ids = get_numa_node_ids()
     assert (
-        node_id < num_of_nodes
-    ), "input node_id:{0} must less than system number of nodes:{1}".format(
-        node_id, num_of_nodes
+        node_id in node_ids
+    ), "input node_id:{0} must be one of the available numa nodes:{1}".format(
+        node_id, node_ids
     )
-    num_cores_per_node = get_num_cores_per_node()
-    return list(range(num_cores_per_node * node_id, num_cores_per_node * (node_id + 1)))
+    return ipex._C.get_cores_of_numa_node(node_id, physical_cores_only)
+
+
+def get_core_lists_of_l3_cache(physical_cores_only=True):
+    r"""
+    Helper function to get the CPU cores' ids grouped by the L3 cache they
+    share.
+
+    Args:
+        physical_cores_only (bool): Only return the first hardware thread of
+            each physical core. Default: ``True``.
+
+    Returns:
+        list: One list of CPU cores' ids per L3 cache domain.
+    """
+
+    return ipex._C.get_cores_per_l3_cache(physical_cores_only)
+
+
+def get_physical_core_list():
+    r"""
+    Helper function to get the first hardware thread of each physical core
+    available for current process.
+
+    Returns:
+        list: List of CPU cores' ids.
+    """
+
+    return ipex._C.get_physical_cores()
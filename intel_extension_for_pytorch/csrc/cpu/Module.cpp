@@ -25,6 +25,7 @@
 #include "jit/cpu/tensorexpr/nnc_fuser_register.h"
 #include "utils/fpmath_mode.h"
 #include "utils/onednn_utils.h"
+#include "utils/op_instrumentation.h"
 
 #include <c10/core/DeviceType.h>
 #include <torch/csrc/Exceptions.h>
@@ -36,6 +37,8 @@
 #include "TaskModule.h"
 #include "aten/EmbeddingBag.h"
 #include "runtime/CPUPool.h"
+#include "runtime/CPUTopology.h"
+#include "runtime/MultiInstanceEngine.h"
 #include "runtime/TaskExecutor.h"
 #include "toolkit/sklearn.h"
 #include "tpp/optim.h"
@@ -84,6 +87,47 @@ void InitIpexModuleBindings(py::module m) {
     return get_highest_binary_support_isa_level();
   });
 
+  // per dispatch stub ISA level
+  m.def("_get_dispatch_stubs", []() {
+    using namespace torch_ipex::cpu;
+    py::list stubs;
+    for (const auto& info : get_dispatch_stubs()) {
+      py::list isa_levels;
+      for (auto isa : info.isa_levels) {
+        isa_levels.append(CPUCapabilityToString(isa));
+      }
+      // None when the stub has no implementation for the current ISA level
+      py::object current_isa_level = py::none();
+      if (info.current_isa_level != CPUCapability::NUM_OPTIONS) {
+        current_isa_level =
+            py::str(CPUCapabilityToString(info.current_isa_level));
+      }
+      py::dict stub;
+      stub["name"] = info.name;
+      stub["isa_levels"] = isa_levels;
+      stub["current_isa_level"] = current_isa_level;
+      stub["overridden"] = info.overridden;
+      stubs.append(stub);
+    }
+    return stubs;
+  });
+
+  m.def(
+      "_set_dispatch_stub_isa_level",
+      [](const std::string& name, const std::string& isa) {
+        using namespace torch_ipex::cpu;
+        CPUCapability isa_level = CPUCapabilityFromString(isa);
+        TORCH_CHECK(
+            isa_level != CPUCapability::NUM_OPTIONS,
+            "_set_dispatch_stub_isa_level: unknown ISA level ",
+            isa);
+        set_dispatch_stub_isa_level(name, isa_level);
+      });
+
+  m.def("_reset_dispatch_stub_isa_level", [](const std::string& name) {
+    torch_ipex::cpu::reset_dispatch_stub_isa_level(name);
+  });
+
   m.def("mkldnn_set_verbose", &torch_ipex::utils::onednn_set_verbose);
   m.def("onednn_has_bf16_support", []() {
     return torch_ipex::utils::onednn_has_bf16_type_support();
@@ -105,6 +149,21 @@ void InitIpexModuleBindings(py::module m) {
     torch_ipex::autocast::set_autocast_dtype(target_dtype);
   });
   m.def("clear_autocast_cache", &torch_ipex::autocast::clear_autocast_cache);
+  m.def(
+      "set_autocast_weight_cache_enabled",
+      &torch_ipex::autocast::set_autocast_weight_cache_enabled);
+  m.def(
+      "is_autocast_weight_cache_enabled",
+      &torch_ipex::autocast::is_autocast_weight_cache_enabled);
+  m.def(
+      "clear_autocast_weight_cache",
+      &torch_ipex::autocast::clear_autocast_weight_cache);
+  m.def(
+      "get_autocast_weight_cache_size",
+      &torch_ipex::autocast::get_autocast_weight_cache_size);
+  m.def(
+      "register_autocast_weight",
+      &torch_ipex::autocast::register_autocast_weight);
 
   m.def("set_fp32_math_mode", [](FP32MathMode mode) {
     torch_ipex::setFP32MathModeCpu(mode);
@@ -130,6 +189,27 @@ void InitIpexModuleBindings(py::module m) {
   m.def(
       "_jit_llga_weight_cache_enabled",
       &torch_ipex::jit::fuser::onednn::getLlgaWeightCacheEnabled);
+  m.def(
+      "_jit_set_llga_shared_partition_cache_enabled",
+      &torch_ipex::jit::fuser::onednn::setLlgaSharedPartitionCacheEnabled);
+  m.def(
+      "_jit_llga_shared_partition_cache_enabled",
+      &torch_ipex::jit::fuser::onednn::getLlgaSharedPartitionCacheEnabled);
+  m.def(
+      "_jit_set_llga_shared_partition_cache_capacity",
+      &torch_ipex::jit::fuser::onednn::setLlgaSharedPartitionCacheCapacity);
+  m.def(
+      "_jit_clear_llga_shared_partition_cache",
+      &torch_ipex::jit::fuser::onednn::clearLlgaSharedPartitionCache);
+  m.def(
+      "_jit_llga_shared_partition_cache_stats",
+      &torch_ipex::jit::fuser::onednn::getLlgaSharedPartitionCacheStats);
+  m.def(
+      "_jit_set_llga_persistent_cache_dir",
+      &torch_ipex::jit::fuser::onednn::setLlgaPersistentCacheDir);
+  m.def(
+      "_jit_llga_persistent_cache_dir",
+      &torch_ipex::jit::fuser::onednn::getLlgaPersistentCacheDir);
 
   m.def("enable_jit_opt", []() {
     AutoOptConfig::singleton().set_jit_fuse(true);
@@ -151,6 +231,66 @@ void InitIpexModuleBindings(py::module m) {
     return AutoOptConfig::singleton().get_jit_repack_for_linear();
   });
 
+  m.def("enable_jit_memory_planning", []() {
+    AutoOptConfig::singleton().set_jit_memory_planning(true);
+  });
+  m.def("disable_jit_memory_planning", []() {
+    AutoOptConfig::singleton().set_jit_memory_planning(false);
+  });
+  m.def("get_jit_memory_planning", []() {
+    return AutoOptConfig::singleton().get_jit_memory_planning();
+  });
+
+  m.def("_set_jit_sparse_linear_threshold", [](double threshold) {
+    AutoOptConfig::singleton().set_jit_sparse_linear_threshold(threshold);
+  });
+  m.def("_get_jit_sparse_linear_threshold", []() {
+    return AutoOptConfig::singleton().get_jit_sparse_linear_threshold();
+  });
+
+  m.def("_set_conv_primitive_cache_capacity", [](int64_t capacity) {
+    AutoOptConfig::singleton().set_conv_primitive_cache_capacity(capacity);
+  });
+  m.def("_get_conv_primitive_cache_capacity", []() {
+    return AutoOptConfig::singleton().get_conv_primitive_cache_capacity();
+  });
+  m.def("_set_conv_input_bucket_size", [](int64_t bucket_size) {
+    AutoOptConfig::singleton().set_conv_input_bucket_size(bucket_size);
+  });
+  m.def("_get_conv_input_bucket_size", []() {
+    return AutoOptConfig::singleton().get_conv_input_bucket_size();
+  });
+  m.def("_set_linear_primitive_cache_capacity", [](int64_t capacity) {
+    AutoOptConfig::singleton().set_linear_primitive_cache_capacity(capacity);
+  });
+  m.def("_get_linear_primitive_cache_capacity", []() {
+    return AutoOptConfig::singleton().get_linear_primitive_cache_capacity();
+  });
+  m.def("_set_linear_m_bucket_size", [](int64_t bucket_size) {
+    AutoOptConfig::singleton().set_linear_m_bucket_size(bucket_size);
+  });
+  m.def("_get_linear_m_bucket_size", []() {
+    return AutoOptConfig::singleton().get_linear_m_bucket_size();
+  });
+
+  // per-op instrumentation
+  m.def("_set_op_instrumentation_enabled", [](bool enabled) {
+    torch_ipex::instrumentation::set_enabled(enabled);
+  });
+  m.def("_get_op_instrumentation_enabled", []() {
+    return torch_ipex::instrumentation::is_enabled();
+  });
+  m.def("_reset_op_instrumentation", []() {
+    torch_ipex::instrumentation::reset();
+  });
+  m.def(
+      "_get_op_instrumentation_report",
+      [](double peak_gflops, double peak_gbps) {
+        return torch_ipex::instrumentation::get_report(peak_gflops, peak_gbps);
+      },
+      py::arg("peak_gflops") = 0,
+      py::arg("peak_gbps") = 0);
+
   // BF32
   py::enum_<FP32MathMode>(m, "FP32MathMode")
       .value("FP32", FP32MathMode::FP32)
@@ -172,9 +312,18 @@ void InitIpexModuleBindings(py::module m) {
         return std::make_shared<torch_ipex::runtime::CPUPool>(
             py::cast<std::vector<int32_t>>(core_list));
       }))
-      .def("get_core_list", [](torch_ipex::runtime::CPUPool& self) {
-        return self.get_cpu_core_list();
-      });
+      .def(py::init([](const py::list& core_list, bool bind_memory) {
+        return std::make_shared<torch_ipex::runtime::CPUPool>(
+            py::cast<std::vector<int32_t>>(core_list), bind_memory);
+      }))
+      .def(
+          "get_core_list",
+          [](torch_ipex::runtime::CPUPool& self) {
+            return self.get_cpu_core_list();
+          })
+      .def(
+          "get_memory_numa_node",
+          &torch_ipex::runtime::CPUPool::get_memory_numa_node);
 
   py::class_<
       torch_ipex::runtime::TaskModule,
@@ -209,10 +358,83 @@ void InitIpexModuleBindings(py::module m) {
             return self.run_async(std::move(args), std::move(kwargs));
           });
 
+  py::class_<
+      torch_ipex::runtime::MultiInstanceEngine,
+      std::shared_ptr<torch_ipex::runtime::MultiInstanceEngine>>(
+      m, "MultiInstanceEngine")
+      .def(py::init(
+          [](const torch::jit::Module& module,
+             std::vector<std::shared_ptr<torch_ipex::runtime::CPUPool>>
+                 cpu_pools) {
+            return std::make_shared<torch_ipex::runtime::MultiInstanceEngine>(
+                module, std::move(cpu_pools));
+          }))
+      .def(
+          "run_async",
+          [](torch_ipex::runtime::MultiInstanceEngine& self,
+             py::args& args,
+             py::kwargs& kwargs) {
+            const auto& module = self.get_module();
+            auto& function = module.get_method("forward").function();
+            std::vector<at::IValue> stack = torch::jit::createStackForSchema(
+                function.getSchema(),
+                std::move(args),
+                // NOLINTNEXTLINE(performance-move-const-arg)
+                std::move(kwargs),
+                module._ivalue());
+            // The engine prepends self for each request.
+            stack.erase(stack.begin());
+            auto future_tensor_result =
+                std::make_unique<torch_ipex::runtime::FutureTensor>();
+            future_tensor_result->script_module_initialized_ = true;
+            {
+              pybind11::gil_scoped_release no_gil_guard;
+              future_tensor_result->future_script_tensor =
+                  self.submit(std::move(stack));
+            }
+            return future_tensor_result;
+          })
+      .def(
+          "get_num_instances",
+          &torch_ipex::runtime::MultiInstanceEngine::get_num_instances)
+      .def(
+          "get_num_finished_requests",
+          &torch_ipex::runtime::MultiInstanceEngine::get_num_finished_requests)
+      .def(
+          "stop",
+          &torch_ipex::runtime::MultiInstanceEngine::stop,
+          py::call_guard<py::gil_scoped_release>());
+
   m.def(
       "get_process_available_cores",
       &torch_ipex::runtime::get_process_available_cores);
+  m.def("get_numa_node_ids", []() {
+    return torch_ipex::runtime::CPUTopology::get().get_numa_node_ids();
+  });
+  m.def(
+      "get_cores_of_numa_node",
+      [](int32_t numa_node_id, bool physical_cores_only) {
+        return torch_ipex::runtime::CPUTopology::get().get_cores_of_numa_node(
+            numa_node_id, physical_cores_only);
+      });
+  m.def("get_cores_per_l3_cache", [](bool physical_cores_only) {
+    return torch_ipex::runtime::CPUTopology::get().get_cores_per_l3_cache(
+        physical_cores_only);
+  });
+  m.def("get_physical_cores", []() {
+    return torch_ipex::runtime::CPUTopology::get().get_physical_cores();
+  });
   m.def("is_runtime_ext_enabled", &torch_ipex::runtime::is_runtime_ext_enabled);
+  m.def("get_runtime_ext_backend", []() {
+    switch (torch_ipex::runtime::get_runtime_ext_backend()) {
+      case torch_ipex::runtime::RuntimeExtBackend::IOMP:
+        return "iomp";
+      case torch_ipex::runtime::RuntimeExtBackend::NATIVE:
+        return "native";
+      default:
+        return "none";
+    }
+  });
   m.def("init_runtime_ext", &torch_ipex::runtime::init_runtime_ext);
   m.def(
       "pin_cpu_cores",
@@ -239,6 +461,12 @@ void InitIpexModuleBindings(py::module m) {
 
   m.def("roc_auc_score", &toolkit::roc_auc_score);
   m.def("roc_auc_score_all", &toolkit::roc_auc_score_all);
+  py::class_<toolkit::StreamingMetrics>(m, "StreamingMetrics")
+      .def(py::init<int64_t>(), py::arg("num_bins") = 1 << 16)
+      .def("update", &toolkit::StreamingMetrics::update)
+      .def("compute", &toolkit::StreamingMetrics::compute)
+      .def("reset", &toolkit::StreamingMetrics::reset)
+      .def("num_samples", &toolkit::StreamingMetrics::num_samples);
 
   // libxsmm
   m.def("xsmm_manual_seed", &torch_ipex::tpp::xsmm_manual_seed);
@@ -3,6 +3,7 @@ from ...cpu.nn import _roi_align
 from .merged_embeddingbag import MergedEmbeddingBagWithSGD
 from .merged_embeddingbag import MergedEmbeddingBag
 from .merged_embeddingbag import MergedEmbeddingBagWithCat
+from .merged_embeddingbag import RowwiseQuantizedMergedEmbeddingBagWithCat
 from .merged_embeddingbag import MergedEmbeddingBagWithAdaGrad
 from ...cpu.nn.linear_fuse_eltwise import IPEXLinearEltwise
 from .weight_only_quantization import IpexWoqLinear
@@ -34,6 +34,91 @@ def get_param2(param, params_attr):
     return param2
 
 
+def _fused_grad_scale(self, grad_scaler=None, max_grad_norm=None):
+    r"""First phase of the fused gradient clipping + AMP unscale + step.
+    The gradients of all param groups are read once to get their global norm
+    and to check them for inf/nan, the fused step then multiplies them by the
+    returned grad_scale (inverse AMP scale times clip coefficient) as it
+    updates the params. Returns None if the step has to be skipped.
+    """
+    if grad_scaler is None and max_grad_norm is None:
+        return 1.0
+
+    grads = []
+    has_sparse_grad = False
+    for group in self.param_groups:
+        for p in group["params"]:
+            grad = (
+                get_bf16_grad(p, self.params_attr)
+                if is_master_weight(p, self.params_attr)
+                else p.grad
+            )
+            if grad is not None:
+                has_sparse_grad = has_sparse_grad or grad.is_sparse
+                grads.append(grad)
+
+    inv_scale = 1.0
+    grads_unscaled = True
+    if grad_scaler is not None:
+        from ..cpu.autocast._grad_scaler import OptState
+
+        optimizer_state = grad_scaler._per_optimizer_states[id(self)]
+        if has_sparse_grad and optimizer_state["stage"] is OptState.READY:
+            # sparse grads are unscaled out of place by the non-fused path
+            grad_scaler.unscale_(self)
+        if optimizer_state["stage"] is OptState.UNSCALED:
+            # unscale_ has already checked the grads for inf/nan
+            if any(v.item() for v in optimizer_state["found_inf_per_device"].values()):
+                return None
+        else:
+            grads_unscaled = False
+            inv_scale = grad_scaler._scale.double().reciprocal().item()
+    if grads_unscaled and max_grad_norm is None:
+        return 1.0
+
+    norm, found_inf = torch.ops.torch_ipex.grad_norm_non_finite_check(
+        [grad.coalesce()._values() if grad.is_sparse else grad for grad in grads]
+    )
+    if not grads_unscaled:
+        optimizer_state["found_inf_per_device"] = {
+            grad_scaler._scale.device: torch.full(
+                (1,), float(found_inf), device=grad_scaler._scale.device
+            )
+        }
+        if found_inf:
+            return None
+
+    grad_scale = inv_scale
+    if max_grad_norm is not None:
+        clip_coef = max_grad_norm / (norm * inv_scale + 1e-6)
+        if clip_coef < 1.0:
+            grad_scale *= clip_coef
+    return grad_scale
+
+
+# number of state elements sharing one absmax, keep aligned with
+# kQuantizedStateBlockSize in csrc/cpu/aten/optimizer/optimizer.h
+_QUANTIZED_STATE_BLOCK_SIZE = 256
+
+
+def _init_quantized_state(state, param):
+    # Both moments are kept flattened so that they are never repacked with the
+    # param, exp_avg is linear int8 and exp_avg_sq is the uint8 dynamic
+    # exponent code, each with one float absmax per block
+    numel = param.numel()
+    num_blocks = (
+        numel + _QUANTIZED_STATE_BLOCK_SIZE - 1
+    ) // _QUANTIZED_STATE_BLOCK_SIZE
+    state["exp_avg"] = torch.zeros(numel, dtype=torch.int8, device=param.device)
+    state["exp_avg_absmax"] = torch.zeros(
+        num_blocks, dtype=torch.float, device=param.device
+    )
+    state["exp_avg_sq"] = torch.zeros(numel, dtype=torch.uint8, device=param.device)
+    state["exp_avg_sq_absmax"] = torch.zeros(
+        num_blocks, dtype=torch.float, device=param.device
+    )
+
+
 def _make_sparse(grad, grad_indices, values):
     size = grad.size()
     if grad_indices.numel() == 0 or values.numel() == 0:
@@ -105,7 +190,6 @@ def _single_tensor_adagrad(
                 state_sum = torch.view_as_complex(state_sum)
 
 
-# keep this function here if enable fused_foreach_adagrad_later
 def _multi_tensor_adagrad(
     params: List[Tensor],
     params2: List[Tensor],
@@ -125,24 +209,32 @@ def _multi_tensor_adagrad(
     if len(params) == 0:
         return
 
+    if has_sparse_grad or any(torch.is_complex(param) for param in params):
+        _single_tensor_adagrad(
+            params,
+            params2,
+            grads,
+            state_sums,
+            state_steps,
+            lr=lr,
+            weight_decay=weight_decay,
+            lr_decay=lr_decay,
+            eps=eps,
+            has_sparse_grad=has_sparse_grad,
+            maximize=maximize,
+            fused=fused,
+        )
+        return
+
     if maximize:
-        grads = torch._foreach_neg(grads)
+        grads = torch._foreach_neg(tuple(grads))
 
-    _single_tensor_adagrad(
-        params,
-        params2,
-        grads,
-        state_sums,
-        state_steps,
-        lr=lr,
-        weight_decay=weight_decay,
-        lr_decay=lr_decay,
-        eps=eps,
-        has_sparse_grad=has_sparse_grad,
-        maximize=False,
-        fused=fused,
+    # update steps
+    torch._foreach_add_(state_steps, 1)
+    steps = [step_t.item() for step_t in state_steps]
+    torch.ops.torch_ipex.adagrad_fused_step_multi_tensor(
+        params, grads, state_sums, params2, steps, lr, weight_decay, lr_decay, eps
     )
-    return
 
 
 def adagrad(
@@ -302,10 +394,13 @@ def _single_tensor_sgd(
     nesterov: bool,
     maximize: bool,
     has_sparse_grad: bool,
-    fused: bool
+    fused: bool,
+    grad_scale: float = 1.0
 ):
     for i, param in enumerate(params):
         grad = grads[i] if not maximize else -grads[i]
+        if grad_scale != 1.0:
+            grad = grad * grad_scale
         if not grad.is_sparse:
             momentum_buffer_list[i] = torch.ops.torch_ipex.sgd_fused_step(
                 param,
@@ -382,7 +477,6 @@ def _single_tensor_lars(
         # continue
 
 
-# keep this function here if enable fused_foreach_sgd_later
 def _multi_tensor_sgd(
     params: List[Tensor],
     params2: List[Tensor],
@@ -396,25 +490,48 @@ def _multi_tensor_sgd(
     nesterov: bool,
     maximize: bool,
     has_sparse_grad: bool,
-    fused: bool
+    fused: bool,
+    grad_scale: float = 1.0
 ):
     if len(params) == 0:
         return
 
-    _single_tensor_sgd(
+    if has_sparse_grad or any(grad.is_sparse for grad in grads):
+        _single_tensor_sgd(
+            params,
+            params2,
+            grads,
+            momentum_buffer_list,
+            weight_decay=weight_decay,
+            momentum=momentum,
+            lr=lr,
+            dampening=dampening,
+            nesterov=nesterov,
+            maximize=maximize,
+            has_sparse_grad=has_sparse_grad,
+            fused=fused,
+            grad_scale=grad_scale,
+        )
+        return
+
+    if maximize:
+        grads = torch._foreach_neg(tuple(grads))
+
+    momentum_buffers = torch.ops.torch_ipex.sgd_fused_step_multi_tensor(
         params,
-        params2,
         grads,
         momentum_buffer_list,
-        weight_decay=weight_decay,
-        momentum=momentum,
-        lr=lr,
-        dampening=dampening,
-        nesterov=nesterov,
-        maximize=maximize,
-        has_sparse_grad=has_sparse_grad,
-        fused=fused,
+        params2,
+        momentum,
+        lr,
+        weight_decay,
+        dampening,
+        nesterov,
+        grad_scale,
     )
+    # the caller reads the new momentum buffers back from the list
+    for i, momentum_buffer in enumerate(momentum_buffers):
+        momentum_buffer_list[i] = momentum_buffer
 
 
 def sgd(
@@ -433,7 +550,8 @@ def sgd(
     dampening: float,
     nesterov: bool,
     maximize: bool,
-    fused: bool
+    fused: bool,
+    grad_scale: float = 1.0
 ):
     r"""Functional API that performs SGD algorithm computation.
 
@@ -447,7 +565,8 @@ def sgd(
     if foreach and torch.jit.is_scripting():
         raise RuntimeError("torch.jit.script not supported with foreach optimizers")
 
-    if foreach and not torch.jit.is_scripting():
+    # only the multi-tensor kernel applies grad_scale without an extra pass
+    if (foreach or grad_scale != 1.0) and not torch.jit.is_scripting():
         func = _multi_tensor_sgd
     else:
         func = _single_tensor_sgd
@@ -465,22 +584,31 @@ def sgd(
         has_sparse_grad=has_sparse_grad,
         maximize=maximize,
         fused=fused,
+        grad_scale=grad_scale,
     )
 
 
 @torch.no_grad()
-def sgd_step(self, closure=None):
+def sgd_step(self, closure=None, grad_scaler=None, max_grad_norm=None):
     """Performs a single optimization step.
 
     Args:
         closure (callable, optional): A closure that reevaluates the model
             and returns the loss.
+        grad_scaler (GradScaler, optional): passed by ``GradScaler.step``,
+            the grads are unscaled inside the fused step.
+        max_grad_norm (float, optional): clip the global norm of the grads
+            inside the fused step.
     """
     loss = None
     if closure is not None:
         with torch.enable_grad():
             loss = closure()
 
+    grad_scale = _fused_grad_scale(self, grad_scaler, max_grad_norm)
+    if grad_scale is None:
+        return loss
+
     for group in self.param_groups:
         params_with_grad = []
         params2 = []
@@ -523,6 +651,7 @@ def sgd_step(self, closure=None):
             has_sparse_grad=has_sparse_grad,
             foreach=group["foreach"],
             fused=self.fused,
+            grad_scale=grad_scale,
         )
 
         # update momentum_buffers in state
@@ -680,24 +809,64 @@ def _lamb_fused_impl(
     lr: float,
     weight_decay: float,
     eps: float,
+    grad_scale: float = 1.0,
 ):
     r"""Functional API that performs Lamb algorithm computation.
     See :class:`~torch.optim.Lamb` for details.
     """
 
+    if len(params) == 0:
+        return
+
+    params2 = [get_param2(param, attr) for param in params]
+    # all parameters of the group are updated in a single parallel region
+    torch.ops.torch_ipex.lamb_fused_step_multi_tensor(
+        params,
+        exp_avgs,
+        exp_avg_sqs,
+        grads,
+        params2,
+        state_steps,
+        beta1,
+        beta2,
+        lr,
+        weight_decay,
+        eps,
+        grad_scale,
+    )
+
+
+def _quantized_state_lamb(
+    params: List[Tensor],
+    grads: List[Tensor],
+    exp_avgs: List[Tensor],
+    exp_avg_sqs: List[Tensor],
+    absmaxs: List[tuple],
+    attr: dict,
+    state_steps: List[int],
+    beta1: float,
+    beta2: float,
+    lr: float,
+    weight_decay: float,
+    eps: float,
+    grad_scale: float = 1.0,
+):
+    r"""Lamb with 8-bit block-quantized exp_avg and exp_avg_sq, the states are
+    dequantized block by block inside the fused kernel.
+    """
+    if grad_scale != 1.0:
+        grads = torch._foreach_mul(grads, grad_scale)
     for i, param in enumerate(params):
-        grad = grads[i]
-        exp_avg = exp_avgs[i]
-        exp_avg_sq = exp_avg_sqs[i]
-        step = state_steps[i]
-        param2 = get_param2(param, attr)
-        torch.ops.torch_ipex.lamb_fused_step(
+        exp_avg_absmax, exp_avg_sq_absmax = absmaxs[i]
+        torch.ops.torch_ipex.lamb_fused_step_8bit(
             param,
-            exp_avg,
-            exp_avg_sq,
-            grad,
-            param2,
-            step,
+            exp_avgs[i],
+            exp_avg_absmax,
+            exp_avg_sqs[i],
+            exp_avg_sq_absmax,
+            grads[i],
+            get_param2(param, attr),
+            state_steps[i],
             beta1,
             beta2,
             lr,
@@ -747,17 +916,25 @@ def _lamb_impl(
 
 
 @torch.no_grad()
-def lamb_step(self, closure=None):
+def lamb_step(self, closure=None, grad_scaler=None, max_grad_norm=None):
     """Performs a single optimization step.
     Args:
         closure (callable, optional): A closure that reevaluates the model
             and returns the loss.
+        grad_scaler (GradScaler, optional): passed by ``GradScaler.step``,
+            the grads are unscaled inside the fused step.
+        max_grad_norm (float, optional): clip the global norm of the grads
+            inside the fused step.
     """
     loss = None
     if closure is not None:
         with torch.enable_grad():
             loss = closure()
 
+    grad_scale = _fused_grad_scale(self, grad_scaler, max_grad_norm)
+    if grad_scale is None:
+        return loss
+
     for group in self.param_groups:
         params_with_grad = []
         grads = []
@@ -765,6 +942,7 @@ def lamb_step(self, closure=None):
         exp_avg_sqs = []
         trails = []
         state_steps = []
+        quantized_state = group.get("quantized_state", False)
 
         for p in group["params"]:
             grad = (
@@ -782,16 +960,25 @@ def lamb_step(self, closure=None):
                 # Lazy state initialization
                 if len(state) == 0:
                     state["step"] = 0
-                    buffer_dtype = p.dtype if p.dtype is torch.float64 else torch.float
-                    state["exp_avg"] = torch.zeros(
-                        p.shape, dtype=buffer_dtype, device=p.device
-                    )
-                    state["exp_avg_sq"] = torch.zeros(
-                        p.shape, dtype=buffer_dtype, device=p.device
-                    )
+                    if quantized_state:
+                        _init_quantized_state(state, p)
+                    else:
+                        buffer_dtype = (
+                            p.dtype if p.dtype is torch.float64 else torch.float
+                        )
+                        state["exp_avg"] = torch.zeros(
+                            p.shape, dtype=buffer_dtype, device=p.device
+                        )
+                        state["exp_avg_sq"] = torch.zeros(
+                            p.shape, dtype=buffer_dtype, device=p.device
+                        )
 
                 exp_avgs.append(state["exp_avg"])
                 exp_avg_sqs.append(state["exp_avg_sq"])
+                if quantized_state:
+                    trails.append(
+                        (state["exp_avg_absmax"], state["exp_avg_sq_absmax"])
+                    )
 
                 # update the steps for each param group update
                 state["step"] += 1
@@ -799,6 +986,23 @@ def lamb_step(self, closure=None):
                 state_steps.append(state["step"])
 
         beta1, beta2 = group["betas"]
+        if quantized_state:
+            _quantized_state_lamb(
+                params_with_grad,
+                grads,
+                exp_avgs,
+                exp_avg_sqs,
+                trails,
+                self.params_attr,
+                state_steps,
+                beta1,
+                beta2,
+                group["lr"],
+                group["weight_decay"],
+                group["eps"],
+                grad_scale,
+            )
+            continue
         _lamb_fused_impl(
             params_with_grad,
             grads,
@@ -811,23 +1015,32 @@ def lamb_step(self, closure=None):
             group["lr"],
             group["weight_decay"],
             group["eps"],
+            grad_scale,
         )
     return loss
 
 
 @torch.no_grad()
-def adam_step(self, closure=None):
+def adam_step(self, closure=None, grad_scaler=None, max_grad_norm=None):
     """Performs a single optimization step.
 
     Args:
         closure (callable, optional): A closure that reevaluates the model
             and returns the loss.
+        grad_scaler (GradScaler, optional): passed by ``GradScaler.step``,
+            the grads are unscaled inside the fused step.
+        max_grad_norm (float, optional): clip the global norm of the grads
+            inside the fused step.
     """
     loss = None
     if closure is not None:
         with torch.enable_grad():
             loss = closure()
 
+    grad_scale = _fused_grad_scale(self, grad_scaler, max_grad_norm)
+    if grad_scale is None:
+        return loss
+
     for group in self.param_groups:
         params_with_grad = []
         params2 = []
@@ -836,7 +1049,11 @@ def adam_step(self, closure=None):
         exp_avg_sqs = []
         max_exp_avg_sqs = []
         state_steps = []
+        absmaxs = []
         beta1, beta2 = group["betas"]
+        quantized_state = group.get("quantized_state", False)
+        if quantized_state and group["amsgrad"]:
+            raise RuntimeError("Adam does not support amsgrad with quantized_state")
 
         for p in group["params"]:
             grad = (
@@ -854,7 +1071,10 @@ def adam_step(self, closure=None):
 
                 state = self.state[p]
                 # Lazy state initialization
-                if len(state) == 0:
+                if len(state) == 0 and quantized_state:
+                    state["step"] = torch.tensor(0.0)
+                    _init_quantized_state(state, p)
+                elif len(state) == 0:
                     buffer_dtype = p.dtype if p.dtype is torch.float64 else torch.float
                     state["step"] = torch.tensor(0.0)
                     # Exponential moving average of gradient values
@@ -876,12 +1096,35 @@ def adam_step(self, closure=None):
 
                 if group["amsgrad"]:
                     max_exp_avg_sqs.append(state["max_exp_avg_sq"])
+                if quantized_state:
+                    absmaxs.append(
+                        (state["exp_avg_absmax"], state["exp_avg_sq_absmax"])
+                    )
 
                 state_steps.append(state["step"])
 
                 param2 = get_param2(p, self.params_attr)
                 params2.append(param2)
 
+        if quantized_state:
+            _quantized_state_adam(
+                params_with_grad,
+                params2,
+                grads,
+                exp_avgs,
+                exp_avg_sqs,
+                absmaxs,
+                state_steps,
+                beta1=beta1,
+                beta2=beta2,
+                lr=group["lr"],
+                weight_decay=group["weight_decay"],
+                eps=group["eps"],
+                maximize=group["maximize"],
+                grad_scale=grad_scale,
+            )
+            continue
+
         adam(
             params_with_grad,
             params2,
@@ -898,6 +1141,7 @@ def adam_step(self, closure=None):
             eps=group["eps"],
             maximize=group["maximize"],
             foreach=group["foreach"],
+            grad_scale=grad_scale,
         )
 
     return loss
@@ -921,7 +1165,8 @@ def adam(
     lr: float,
     weight_decay: float,
     eps: float,
-    maximize: bool
+    maximize: bool,
+    grad_scale: float = 1.0
 ):
     r"""Functional API that performs Adam algorithm computation.
     See :class:`~torch.optim.Adam` for details.
@@ -939,7 +1184,8 @@ def adam(
     if foreach and torch.jit.is_scripting():
         raise RuntimeError("torch.jit.script not supported with foreach optimizers")
 
-    if foreach and not torch.jit.is_scripting():
+    # only the multi-tensor kernel applies grad_scale
+    if (foreach or grad_scale != 1.0) and not torch.jit.is_scripting():
         func = _multi_tensor_adam
     else:
         func = _single_tensor_adam
@@ -959,6 +1205,7 @@ def adam(
         weight_decay=weight_decay,
         eps=eps,
         maximize=maximize,
+        grad_scale=grad_scale,
     )
 
 
@@ -977,10 +1224,13 @@ def _single_tensor_adam(
     lr: float,
     weight_decay: float,
     eps: float,
-    maximize: bool
+    maximize: bool,
+    grad_scale: float = 1.0
 ):
     for i, param in enumerate(params):
         grad = grads[i] if not maximize else -grads[i]
+        if grad_scale != 1.0:
+            grad = grad * grad_scale
         exp_avg = exp_avgs[i]
         exp_avg_sq = exp_avg_sqs[i]
         if amsgrad:
@@ -1010,6 +1260,50 @@ def _single_tensor_adam(
         )
 
 
+def _quantized_state_adam(
+    params: List[Tensor],
+    params2: List[Tensor],
+    grads: List[Tensor],
+    exp_avgs: List[Tensor],
+    exp_avg_sqs: List[Tensor],
+    absmaxs: List[tuple],
+    state_steps: List[Tensor],
+    *,
+    beta1: float,
+    beta2: float,
+    lr: float,
+    weight_decay: float,
+    eps: float,
+    maximize: bool,
+    grad_scale: float = 1.0
+):
+    if grad_scale != 1.0:
+        grads = torch._foreach_mul(grads, grad_scale)
+    for i, param in enumerate(params):
+        grad = grads[i] if not maximize else -grads[i]
+        exp_avg_absmax, exp_avg_sq_absmax = absmaxs[i]
+        step_t = state_steps[i]
+        # update step
+        step_t += 1
+        step = step_t.item()
+
+        torch.ops.torch_ipex.adam_fused_step_8bit(
+            param,
+            exp_avgs[i],
+            exp_avg_absmax,
+            exp_avg_sqs[i],
+            exp_avg_sq_absmax,
+            grad,
+            params2[i],
+            step,
+            beta1,
+            beta2,
+            lr,
+            weight_decay,
+            eps,
+        )
+
+
 def _multi_tensor_adam(
     params: List[Tensor],
     params2: List[Tensor],
@@ -1025,7 +1319,8 @@ def _multi_tensor_adam(
     lr: float,
     weight_decay: float,
     eps: float,
-    maximize: bool
+    maximize: bool,
+    grad_scale: float = 1.0
 ):
     if len(params) == 0:
         return
@@ -1033,21 +1328,24 @@ def _multi_tensor_adam(
     if maximize:
         grads = torch._foreach_neg(tuple(grads))  # type: ignore[assignment]
 
-    _single_tensor_adam(
+    # update steps
+    torch._foreach_add_(state_steps, 1)
+    steps = [step_t.item() for step_t in state_steps]
+    torch.ops.torch_ipex.adam_fused_step_multi_tensor(
         params,
-        params2,
-        grads,
         exp_avgs,
         exp_avg_sqs,
         max_exp_avg_sqs,
-        state_steps,
-        amsgrad=amsgrad,
-        beta1=beta1,
-        beta2=beta2,
-        lr=lr,
-        weight_decay=weight_decay,
-        eps=eps,
-        maximize=False,
+        grads,
+        params2,
+        amsgrad,
+        steps,
+        beta1,
+        beta2,
+        lr,
+        weight_decay,
+        eps,
+        grad_scale,
     )
 
 
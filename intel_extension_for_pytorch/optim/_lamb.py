@@ -17,12 +17,22 @@ class Lamb(torch.optim.Optimizer):
         weight_decay (float, optional): weight decay (L2 penalty) (default: 0)
         fused (boolean, optional): whether to use fused kernel to accelerate
             (default: False)
+        quantized_state (boolean, optional): keep exp_avg and exp_avg_sq as
+            8-bit block-quantized tensors, only takes effect with the fused
+            step installed by ``ipex.optimize`` (default: False)
     .. _Large Batch Optimization for Deep Learning: Training BERT in 76 minutes:
         https://arxiv.org/abs/1904.00962
     """
 
     def __init__(
-        self, params, lr=1e-3, betas=(0.9, 0.999), eps=1e-8, weight_decay=0, fused=False
+        self,
+        params,
+        lr=1e-3,
+        betas=(0.9, 0.999),
+        eps=1e-8,
+        weight_decay=0,
+        fused=False,
+        quantized_state=False,
     ):
         if not 0.0 <= lr:
             raise ValueError("Invalid learning rate: {}".format(lr))
@@ -35,7 +45,12 @@ class Lamb(torch.optim.Optimizer):
         if not 0.0 <= weight_decay:
             raise ValueError("Invalid weight_decay value: {}".format(weight_decay))
         defaults = dict(
-            lr=lr, betas=betas, eps=eps, weight_decay=weight_decay, fused=fused
+            lr=lr,
+            betas=betas,
+            eps=eps,
+            weight_decay=weight_decay,
+            fused=fused,
+            quantized_state=quantized_state,
         )
         super(Lamb, self).__init__(params, defaults)
         self.params_attr = {}
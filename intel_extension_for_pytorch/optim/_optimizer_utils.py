@@ -381,6 +381,15 @@ def optimizer_fusion(optimizer, master_weight_split, device_type):
             setattr(optimizer, "_original_step", optimizer.step)  # noqa: B010
         optimizer.step = types.MethodType(step, optimizer)
         setattr(optimizer, "fused", True)  # noqa: B010
+        if (
+            device_type == "cpu"
+            and step in (sgd_step, adam_step, lamb_step)
+            and not hasattr(optimizer, "sync_grad")
+        ):
+            # GradScaler.step passes itself to the fused step, which unscales
+            # (and optionally clips) the grads while updating the params. The
+            # fp16 master weight flow still syncs the grads in unscale_.
+            setattr(optimizer, "_step_supports_amp_scaling", True)  # noqa: B010
     except KeyError:
         warnings.warn(
             "Does not suport fused step for "
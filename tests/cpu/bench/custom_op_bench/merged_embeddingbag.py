@@ -31,13 +31,14 @@ class EmbeddingBagList(torch.nn.Module):
         include_last_offset=False,
         sparse=False,
         mode="sum",
+        num_embeddings=1000,
     ):
         super(EmbeddingBagList, self).__init__()
         self.list = torch.nn.ModuleList()
         for _ in range(ntables):
             self.list.append(
                 torch.nn.EmbeddingBag(
-                    1000,
+                    num_embeddings,
                     num_dim,
                     dtype=dtype,
                     mode=mode,
@@ -86,6 +87,18 @@ class MergedEmb(torch.nn.Module):
         return self.merged_emb(indices, offsets)
 
 
+class MergedEmbDedup(torch.nn.Module):
+    def __init__(self, emblist):
+        super(MergedEmbDedup, self).__init__()
+        self.merged_emb = ipex.nn.modules.MergedEmbeddingBag.from_embeddingbag_list(
+            emblist.list
+        )
+        self.merged_emb.dedup_indices = True
+
+    def forward(self, indices, offsets):
+        return self.merged_emb(indices, offsets)
+
+
 class MergedEmbSGD(torch.nn.Module):
     def __init__(self, emblist, lr=0.01, weight_decay=0):
         super(MergedEmbSGD, self).__init__()
@@ -190,6 +203,27 @@ def merged_emb_cat_bench(args, input):
             )
 
 
+def merged_emb_dedup_bench(args, input):
+    assert args.inference
+    for dtype in [torch.float32, torch.bfloat16]:
+        emblist = EmbeddingBagList(
+            NUM_TABLE, args.vector_size, dtype, num_embeddings=args.num_embeddings
+        )
+        m = MergedEmb(emblist)
+        dedup_m = MergedEmbDedup(emblist)
+        with torch.no_grad():
+            run_bench(
+                f"MergedEmbeddingBag: value_dtype:{dtype}",
+                m,
+                input,
+            )
+            run_bench(
+                f"MergedEmbeddingBag with index dedup: value_dtype:{dtype}",
+                dedup_m,
+                input,
+            )
+
+
 def merged_emb_with_sgd(args, input):
     for dtype in [torch.float32, torch.bfloat16]:
         if dtype == torch.bfloat16:
@@ -272,7 +306,19 @@ def merged_emb_with_adagrad(args, input):
             )
 
 
-def get_data(batch_size):
+def zipf_indices(n, num_embeddings, alpha):
+    r"""
+    Draw `n` row ids in [0, num_embeddings) from a Zipfian distribution
+    P(k) ~ 1 / (k + 1)^alpha, then shuffle the ranks over the rows so hot rows
+    are scattered over the table like real categorical features.
+    """
+    ranks = torch.arange(1, num_embeddings + 1, dtype=torch.double)
+    probs = ranks.pow(-alpha)
+    samples = torch.multinomial(probs / probs.sum(), n, replacement=True)
+    return torch.randperm(num_embeddings)[samples].int()
+
+
+def get_data(batch_size, distribution="unbalance", num_embeddings=1000, alpha=1.05):
     indices = []
     offsets = []
     multi_hot = [
@@ -311,7 +357,13 @@ def get_data(batch_size):
         a = a.floor().int()
         return a
 
-    indices = [unbalance_indices(i) for i in range(26)]
+    if distribution == "zipf":
+        indices = [
+            zipf_indices(batch_size * multi_hot[i], num_embeddings, alpha)
+            for i in range(26)
+        ]
+    else:
+        indices = [unbalance_indices(i) for i in range(26)]
     offsets = [
         torch.arange(0, batch_size * multi_hot[i], multi_hot[i]).int()
         for i in range(26)
@@ -328,6 +380,20 @@ def run():
     parser.add_argument("--batch-size", type=int, default=7168)
     parser.add_argument("--vector-size", type=int, default=128)
     parser.add_argument("--with-cat", action="store_true", default=False)
+    parser.add_argument(
+        "--dedup",
+        action="store_true",
+        default=False,
+        help="compare inference with and without the index dedup pre-pass",
+    )
+    parser.add_argument(
+        "--index-distribution",
+        type=str,
+        default="unbalance",
+        choices=["unbalance", "zipf"],
+    )
+    parser.add_argument("--zipf-alpha", type=float, default=1.05)
+    parser.add_argument("--num-embeddings", type=int, default=1000)
     parser.add_argument(
         "--optimizer",
         type=str,
@@ -335,7 +401,16 @@ def run():
         choices=["sgd", "adagrad"],
     )
     args = parser.parse_args()
-    input_data = get_data(args.batch_size)
+    input_data = get_data(
+        args.batch_size,
+        args.index_distribution,
+        args.num_embeddings,
+        args.zipf_alpha,
+    )
+    if args.dedup:
+        merged_emb_dedup_bench(args, input_data)
+        exit()
+
     if args.with_cat:
         assert args.inference
         merged_emb_cat_bench(args, input_data)
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/stack.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A minimal harness following the Google Benchmark API, so that the kernel
+// benchmarks read the same and could move to it once it is available in
+// third_party:
+//
+//   void BM_Kernel(ipex_bench::State& state) {
+//     auto x = at::rand({state.range(0)});
+//     for (auto _ : state) {
+//       kernel(x);
+//     }
+//     state.SetBytesProcessed(state.iterations() * x.nbytes());
+//     state.SetFlopsProcessed(state.iterations() * x.numel());
+//   }
+//   IPEX_BENCHMARK(BM_Kernel)->Args({1024})->Args({4096});
+//
+// The ISA level is fixed when the library is loaded, so the main runs every
+// level in a child process with ATEN_CPU_CAPABILITY set, see bench_main.cpp.
+
+namespace ipex_bench {
+
+class State {
+ public:
+  State(int64_t max_iterations, std::vector<int64_t> args)
+      : max_iterations_(max_iterations), args_(std::move(args)) {}
+
+  struct Iterator {
+    State* state;
+    int64_t remaining;
+
+    bool operator!=(const Iterator&) const {
+      if (remaining > 0) {
+        return true;
+      }
+      state->finish_running();
+      return false;
+    }
+    void operator++() {
+      --remaining;
+    }
+    int operator*() const {
+      return 0;
+    }
+  };
+
+  Iterator begin() {
+    start_ = std::chrono::steady_clock::now();
+    return {this, max_iterations_};
+  }
+
+  Iterator end() {
+    return {this, 0};
+  }
+
+  int64_t range(size_t index) const {
+    return args_.at(index);
+  }
+
+  int64_t iterations() const {
+    return max_iterations_;
+  }
+
+  // Total over all the iterations, as in Google Benchmark.
+  void SetBytesProcessed(int64_t bytes) {
+    bytes_ = bytes;
+  }
+
+  void SetFlopsProcessed(int64_t flops) {
+    flops_ = flops;
+  }
+
+  void SetLabel(const std::string& label) {
+    label_ = label;
+  }
+
+  // Marks the benchmark as not runnable here, e.g. the op is not built in or
+  // does not support the dtype on this ISA level.
+  void SkipWithError(const std::string& error) {
+    error_ = error;
+  }
+
+  double seconds() const {
+    return seconds_;
+  }
+  int64_t bytes() const {
+    return bytes_;
+  }
+  int64_t flops() const {
+    return flops_;
+  }
+  const std::string& label() const {
+    return label_;
+  }
+  const std::string& error() const {
+    return error_;
+  }
+
+ private:
+  void finish_running() {
+    seconds_ = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start_)
+                   .count();
+  }
+
+  int64_t max_iterations_;
+  std::vector<int64_t> args_;
+  std::chrono::steady_clock::time_point start_;
+  double seconds_ = 0;
+  int64_t bytes_ = 0;
+  int64_t flops_ = 0;
+  std::string label_;
+  std::string error_;
+};
+
+using Function = void (*)(State&);
+
+class Benchmark {
+ public:
+  Benchmark(std::string name, Function function)
+      : name_(std::move(name)), function_(function) {}
+
+  Benchmark* Args(std::vector<int64_t> args) {
+    args_.push_back(std::move(args));
+    return this;
+  }
+
+  const std::string& name() const {
+    return name_;
+  }
+  Function function() const {
+    return function_;
+  }
+  const std::vector<std::vector<int64_t>>& args() const {
+    return args_;
+  }
+
+ private:
+  std::string name_;
+  Function function_;
+  std::vector<std::vector<int64_t>> args_;
+};
+
+Benchmark* RegisterBenchmark(const char* name, Function function);
+
+const std::vector<std::unique_ptr<Benchmark>>& get_benchmarks();
+
+// Calls a registered op through its boxed operation, so the benchmarks only
+// depend on the op schemas and not on the internal headers of the kernels.
+// Also finds the JIT-only ops, e.g. ipex::add_layernorm.
+class Op {
+ public:
+  explicit Op(const char* qualified_name);
+
+  // False when the op is not built in, e.g. the TPP ops without LIBXSMM.
+  bool available() const {
+    return static_cast<bool>(operation_);
+  }
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  template <typename... Args>
+  torch::jit::Stack operator()(Args&&... args) const {
+    torch::jit::Stack stack;
+    stack.reserve(sizeof...(args));
+    (void)std::initializer_list<int>{
+        (stack.emplace_back(std::forward<Args>(args)), 0)...};
+    run(stack);
+    return stack;
+  }
+
+  void run(torch::jit::Stack& stack) const;
+
+ private:
+  std::string name_;
+  torch::jit::Operation operation_;
+};
+
+// 0 for float, 1 for bfloat16, the dtype argument of the benchmarks.
+at::ScalarType dtype_from_arg(int64_t arg);
+
+} // namespace ipex_bench
+
+#define IPEX_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define IPEX_BENCHMARK_CONCAT(a, b) IPEX_BENCHMARK_CONCAT_IMPL(a, b)
+
+#define IPEX_BENCHMARK(function)                          \
+  static ::ipex_bench::Benchmark* C10_UNUSED              \
+      IPEX_BENCHMARK_CONCAT(ipex_benchmark_, __LINE__) =  \
+          ::ipex_bench::RegisterBenchmark(#function, function)
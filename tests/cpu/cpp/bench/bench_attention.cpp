@@ -0,0 +1,95 @@
+#include "bench.h"
+
+#include <cmath>
+
+namespace {
+
+using ipex_bench::dtype_from_arg;
+using ipex_bench::Op;
+using ipex_bench::State;
+
+// One decode step over a KV cache of past_len tokens, with the indirect
+// access cache of the LLM optimizations.
+// args: batch, past_len, heads, head size, dtype
+void BM_MaskedMHADecode(State& state) {
+  static const Op masked_mha("torch_ipex::masked_multihead_self_attention");
+  int64_t batch = state.range(0);
+  int64_t past_len = state.range(1);
+  int64_t heads = state.range(2);
+  int64_t head_size = state.range(3);
+  auto options = at::TensorOptions().dtype(dtype_from_arg(state.range(4)));
+  int64_t max_positions = past_len + 1;
+  auto query = at::randn({batch, 1, heads, head_size}, options);
+  auto key = at::randn({batch, 1, heads, head_size}, options);
+  auto value = at::randn({batch, 1, heads, head_size}, options);
+  auto key_cache = at::randn({max_positions, batch, heads, head_size}, options);
+  auto value_cache =
+      at::randn({max_positions, batch, heads, head_size}, options);
+  auto beam_idx = at::zeros({max_positions, batch}, at::kLong);
+  auto seq_info = at::tensor(past_len, at::kLong);
+  auto attention_mask = at::zeros({batch, 1, 1, past_len + 1}, options);
+  double scale = std::sqrt(static_cast<double>(head_size));
+
+  for (auto _ : state) {
+    // the step writes the same position of the cache every iteration
+    masked_mha(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        beam_idx,
+        seq_info,
+        scale,
+        max_positions,
+        c10::nullopt,
+        attention_mask);
+  }
+  // the step is bound by reading the keys and the values of the cache
+  int64_t kv_bytes = 2 * batch * (past_len + 1) * heads * head_size *
+      key_cache.element_size();
+  int64_t bytes = kv_bytes + 4 * query.nbytes();
+  // q.k and p.v over all the positions
+  int64_t flops = 4 * batch * heads * (past_len + 1) * head_size;
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetFlopsProcessed(state.iterations() * flops);
+  state.SetLabel(c10::toString(query.scalar_type()));
+}
+IPEX_BENCHMARK(BM_MaskedMHADecode)
+    ->Args({1, 1024, 32, 128, 0})
+    ->Args({1, 1024, 32, 128, 1})
+    ->Args({16, 1024, 32, 128, 1})
+    ->Args({16, 2048, 32, 128, 1});
+
+// The first token attention, bfloat16 only.
+// args: batch, sequence length, heads, head size
+void BM_FlashAttention(State& state) {
+  static const Op flash_attention("torch_ipex::flash_attention");
+  int64_t batch = state.range(0);
+  int64_t seq_len = state.range(1);
+  int64_t heads = state.range(2);
+  int64_t head_size = state.range(3);
+  auto options = at::TensorOptions().dtype(at::kBFloat16);
+  auto query = at::randn({batch, seq_len, heads, head_size}, options);
+  auto key = at::randn({batch, seq_len, heads, head_size}, options);
+  auto value = at::randn({batch, seq_len, heads, head_size}, options);
+  auto attention_mask = at::zeros({batch, 1, seq_len, seq_len}, options);
+  double scale = std::sqrt(static_cast<double>(head_size));
+
+  for (auto _ : state) {
+    flash_attention(query, key, value, scale, attention_mask);
+  }
+  // read q, k, v and the mask, write the output
+  int64_t bytes = 4 * query.nbytes() + attention_mask.nbytes();
+  // q.k and p.v
+  int64_t flops = 4 * batch * heads * seq_len * seq_len * head_size;
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetFlopsProcessed(state.iterations() * flops);
+  state.SetLabel(c10::toString(query.scalar_type()));
+}
+IPEX_BENCHMARK(BM_FlashAttention)
+    ->Args({1, 1024, 32, 128})
+    ->Args({1, 2048, 32, 128})
+    ->Args({4, 1024, 16, 64});
+
+} // namespace
@@ -0,0 +1,69 @@
+#include "bench.h"
+
+namespace {
+
+using ipex_bench::dtype_from_arg;
+using ipex_bench::Op;
+using ipex_bench::State;
+
+// Bags of a fixed pooling factor over random rows, sum pooling.
+// args: rows of the table, embedding dim, batch, pooling factor, dtype
+void BM_EmbeddingBag(State& state) {
+  static const Op embedding_bag("torch_ipex::embedding_bag");
+  int64_t rows = state.range(0);
+  int64_t dim = state.range(1);
+  int64_t batch = state.range(2);
+  int64_t pooling = state.range(3);
+  auto options = at::TensorOptions().dtype(dtype_from_arg(state.range(4)));
+  auto weight = at::randn({rows, dim}, options);
+  auto indices = at::randint(rows, {batch * pooling}, at::kLong);
+  auto offsets = at::arange(0, batch * pooling, pooling, at::kLong);
+
+  for (auto _ : state) {
+    embedding_bag(weight, indices, offsets, false, false);
+  }
+  // read the gathered rows, the indices and the offsets, write the bags
+  int64_t row_bytes = dim * weight.element_size();
+  int64_t bytes = batch * pooling * row_bytes + indices.nbytes() +
+      offsets.nbytes() + batch * row_bytes;
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetFlopsProcessed(state.iterations() * batch * pooling * dim);
+  state.SetLabel(c10::toString(weight.scalar_type()));
+}
+IPEX_BENCHMARK(BM_EmbeddingBag)
+    ->Args({1000000, 128, 2048, 1, 0})
+    ->Args({1000000, 128, 2048, 1, 1})
+    ->Args({1000000, 128, 2048, 64, 0})
+    ->Args({1000000, 128, 2048, 64, 1});
+
+// The tables of a DLRM-like model looked up in one op.
+// args: tables, rows per table, embedding dim, batch, dtype
+void BM_MergedEmbeddingBag(State& state) {
+  static const Op merged_embedding_bag(
+      "torch_ipex::merged_embeddingbag_forward");
+  int64_t tables = state.range(0);
+  int64_t rows = state.range(1);
+  int64_t dim = state.range(2);
+  int64_t batch = state.range(3);
+  auto options = at::TensorOptions().dtype(dtype_from_arg(state.range(4)));
+  std::vector<at::Tensor> weights, indices, offsets;
+  for (int64_t i = 0; i < tables; i++) {
+    weights.push_back(at::randn({rows, dim}, options));
+    indices.push_back(at::randint(rows, {batch}, at::kLong));
+    offsets.push_back(at::arange(batch, at::kLong));
+  }
+
+  for (auto _ : state) {
+    merged_embedding_bag(weights, indices, offsets, 0, false);
+  }
+  int64_t row_bytes = dim * weights[0].element_size();
+  // one row per bag, read the row and the index, write the bag
+  int64_t bytes = tables * batch * (2 * row_bytes + 2 * sizeof(int64_t));
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetLabel(c10::toString(weights[0].scalar_type()));
+}
+IPEX_BENCHMARK(BM_MergedEmbeddingBag)
+    ->Args({26, 100000, 128, 2048, 0})
+    ->Args({26, 100000, 128, 2048, 1});
+
+} // namespace
@@ -0,0 +1,98 @@
+#include "bench.h"
+
+#include <torch/custom_class.h>
+
+namespace {
+
+using ipex_bench::dtype_from_arg;
+using ipex_bench::Op;
+using ipex_bench::State;
+
+int64_t get_gemm_flops(int64_t m, int64_t n, int64_t k) {
+  return 2 * m * n * k;
+}
+
+// The weight in the blocked layout of the TPP linear, as
+// TPPLinear_weight_prepack does: [N/16, K/64, 64, 16] for float and
+// [N/16, K/64, 32, 16, 2] for bfloat16.
+at::Tensor block_tpp_weight(const at::Tensor& weight) {
+  int64_t n = weight.size(0);
+  int64_t k = weight.size(1);
+  if (weight.scalar_type() == at::kFloat) {
+    return weight.view({n / 16, 16, k / 64, 64})
+        .permute({0, 2, 3, 1})
+        .contiguous();
+  }
+  return weight.view({n / 16, 16, k / 64, 32, 2})
+      .permute({0, 2, 3, 1, 4})
+      .contiguous();
+}
+
+// args: M, N, K, dtype
+void BM_TPPLinear(State& state) {
+  static const Op tpp_linear("torch_ipex::tpp_linear");
+  int64_t m = state.range(0);
+  int64_t n = state.range(1);
+  int64_t k = state.range(2);
+  auto options = at::TensorOptions().dtype(dtype_from_arg(state.range(3)));
+  auto input = at::randn({1, m, k}, options);
+  auto weight = block_tpp_weight(at::randn({n, k}, options));
+
+  for (auto _ : state) {
+    tpp_linear(input, weight, n);
+  }
+  int64_t bytes =
+      input.nbytes() + weight.nbytes() + m * n * input.element_size();
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetFlopsProcessed(state.iterations() * get_gemm_flops(m, n, k));
+  state.SetLabel(c10::toString(input.scalar_type()));
+}
+IPEX_BENCHMARK(BM_TPPLinear)
+    ->Args({1, 4096, 4096, 0})
+    ->Args({1, 4096, 4096, 1})
+    ->Args({32, 4096, 4096, 1})
+    ->Args({1024, 4096, 4096, 1});
+
+// Int8 weight only quantized linear, the decode GEMM of the LLM
+// optimizations with small M is bound by reading the weight.
+// args: M, N, K, dtype of the activation, lowp_mode
+void BM_WoqLinear(State& state) {
+  static const Op prepack("ipex_prepack::weight_only_qlinear_prepack");
+  static const Op woq_linear("torch_ipex::ipex_woq_linear");
+  int64_t m = state.range(0);
+  int64_t n = state.range(1);
+  int64_t k = state.range(2);
+  auto dtype = dtype_from_arg(state.range(3));
+  int64_t lowp_mode = state.range(4);
+  auto weight = at::randn({n, k});
+  auto scales = weight.abs().amax(1).div(127).clamp_min(1e-6).to(at::kDouble);
+  auto zero_points = at::zeros({n}, at::kLong);
+  auto qweight =
+      at::quantize_per_channel(weight, scales, zero_points, 0, at::kQInt8);
+  auto input = at::randn({m, k}, at::TensorOptions().dtype(dtype));
+
+  auto context = prepack(qweight, c10::nullopt, m, lowp_mode, 1, 0).back();
+  auto& get_data_handle =
+      context.toObject()->type()->getMethod("get_data_handle");
+  auto handle = get_data_handle({context}).toTensor();
+
+  for (auto _ : state) {
+    woq_linear(input, handle);
+  }
+  // one byte per weight element, plus the scales and the zero points
+  int64_t weight_bytes = n * k + scales.numel() * 2 * sizeof(float);
+  int64_t bytes =
+      input.nbytes() + weight_bytes + m * n * input.element_size();
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetFlopsProcessed(state.iterations() * get_gemm_flops(m, n, k));
+  state.SetLabel(
+      std::string(c10::toString(dtype)) + " lowp_mode " +
+      std::to_string(lowp_mode));
+}
+IPEX_BENCHMARK(BM_WoqLinear)
+    ->Args({1, 4096, 4096, 0, 0})
+    ->Args({1, 4096, 4096, 1, 2})
+    ->Args({32, 4096, 4096, 1, 2})
+    ->Args({1024, 4096, 4096, 1, 2});
+
+} // namespace
@@ -0,0 +1,300 @@
+#include "bench.h"
+
+#include "csrc/cpu/dyndisp/DispatchStub.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <regex>
+
+namespace ipex_bench {
+
+namespace {
+
+std::vector<std::unique_ptr<Benchmark>>& get_mutable_benchmarks() {
+  static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+  return benchmarks;
+}
+
+struct Options {
+  std::string filter = ".";
+  double min_time = 0.5;
+  // empty for the ISA level of this process, a level or "all"
+  std::string isa;
+  bool csv = false;
+  bool header = true;
+};
+
+const char* kUsage =
+    "usage: ipex_cpp_bench [--filter=<regex>] [--min_time=<seconds>]\n"
+    "                      [--isa=<default|avx2|...|amx|all>] "
+    "[--format=<console|csv>]\n";
+
+bool parse_options(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto value = [&](const char* flag) -> const char* {
+      auto length = strlen(flag);
+      if (arg.compare(0, length, flag) == 0 && arg.size() > length &&
+          arg[length] == '=') {
+        return argv[i] + length + 1;
+      }
+      return nullptr;
+    };
+    if (auto filter = value("--filter")) {
+      options.filter = filter;
+    } else if (auto min_time = value("--min_time")) {
+      options.min_time = atof(min_time);
+    } else if (auto isa = value("--isa")) {
+      options.isa = isa;
+    } else if (auto format = value("--format")) {
+      options.csv = strcmp(format, "csv") == 0;
+    } else if (arg == "--no_header") {
+      options.header = false;
+    } else {
+      fprintf(stderr, "unknown argument: %s\n%s", argv[i], kUsage);
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string to_lower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+    return std::tolower(c);
+  });
+  return text;
+}
+
+// The levels this process may run, the same ones ATEN_CPU_CAPABILITY
+// accepts.
+std::vector<std::string> get_supported_isa_levels() {
+  using namespace torch_ipex::cpu;
+  auto highest = std::min(
+      _get_highest_cpu_support_isa_level(),
+      _get_highest_binary_support_isa_level());
+  std::vector<std::string> levels;
+  for (int level = 0; level <= static_cast<int>(highest); level++) {
+    levels.push_back(
+        to_lower(CPUCapabilityToString(static_cast<CPUCapability>(level))));
+  }
+  return levels;
+}
+
+// Runs this benchmark binary again with ATEN_CPU_CAPABILITY set, dropping the
+// --isa argument. Returns the exit status of the child.
+int run_with_isa_level(
+    int argc,
+    char** argv,
+    const std::string& level,
+    bool header) {
+  std::vector<char*> args;
+  args.push_back(argv[0]);
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--isa=", 6) != 0 &&
+        strcmp(argv[i], "--no_header") != 0) {
+      args.push_back(argv[i]);
+    }
+  }
+  char no_header[] = "--no_header";
+  if (!header) {
+    args.push_back(no_header);
+  }
+  args.push_back(nullptr);
+
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    setenv("ATEN_CPU_CAPABILITY", level.c_str(), 1);
+    execv("/proc/self/exe", args.data());
+    perror("execv");
+    _exit(1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+State run_benchmark(
+    const Benchmark& benchmark,
+    const std::vector<int64_t>& args,
+    int64_t iterations) {
+  State state(iterations, args);
+  try {
+    benchmark.function()(state);
+  } catch (const std::exception& e) {
+    // the first line of the error, without the C++ stack trace
+    std::string error = e.what();
+    state.SkipWithError(error.substr(0, error.find('\n')));
+  }
+  return state;
+}
+
+// Grows the iterations until the run takes min_time, as Google Benchmark
+// does, after one iteration to warm up.
+State run_until_min_time(
+    const Benchmark& benchmark,
+    const std::vector<int64_t>& args,
+    double min_time) {
+  State state = run_benchmark(benchmark, args, 1);
+  int64_t iterations = 1;
+  while (state.error().empty()) {
+    state = run_benchmark(benchmark, args, iterations);
+    if (!state.error().empty() || state.seconds() >= min_time ||
+        iterations >= 1000000000) {
+      break;
+    }
+    double multiplier = min_time * 1.4 / std::max(state.seconds(), 1e-9);
+    auto next = static_cast<int64_t>(iterations * multiplier);
+    iterations = std::max(iterations + 1, std::min(iterations * 10, next));
+  }
+  return state;
+}
+
+std::string get_case_name(
+    const Benchmark& benchmark,
+    const std::vector<int64_t>& args) {
+  std::string name = benchmark.name();
+  for (auto arg : args) {
+    name += "/" + std::to_string(arg);
+  }
+  return name;
+}
+
+void report(
+    const Options& options,
+    const std::string& isa,
+    const std::string& name,
+    const State& state) {
+  double seconds = std::max(state.seconds(), 1e-12);
+  double us_per_iteration = seconds * 1e6 / state.iterations();
+  double gbps = state.bytes() / seconds * 1e-9;
+  double gflops = state.flops() / seconds * 1e-9;
+  if (options.csv) {
+    printf(
+        "%s,%s,%ld,%.3f,%.2f,%.2f,\"%s\",\"%s\"\n",
+        isa.c_str(),
+        name.c_str(),
+        state.error().empty() ? static_cast<long>(state.iterations()) : 0L,
+        state.error().empty() ? us_per_iteration : 0,
+        gbps,
+        gflops,
+        state.label().c_str(),
+        state.error().c_str());
+  } else if (!state.error().empty()) {
+    printf("%-48s  SKIPPED: %s\n", name.c_str(), state.error().c_str());
+  } else {
+    printf(
+        "%-48s %10ld %12.2f %10.2f %10.2f  %s\n",
+        name.c_str(),
+        static_cast<long>(state.iterations()),
+        us_per_iteration,
+        gbps,
+        gflops,
+        state.label().c_str());
+  }
+  fflush(stdout);
+}
+
+int run_benchmarks(const Options& options) {
+  std::string isa = to_lower(
+      torch_ipex::cpu::CPUCapabilityToString(
+          torch_ipex::cpu::get_cpu_capability()));
+  if (options.csv) {
+    if (options.header) {
+      printf("isa,name,iterations,us_per_iter,GB/s,GFLOP/s,label,error\n");
+    }
+  } else {
+    printf("ISA level: %s\n", isa.c_str());
+    printf(
+        "%-48s %10s %12s %10s %10s  %s\n",
+        "benchmark",
+        "iterations",
+        "us/iter",
+        "GB/s",
+        "GFLOP/s",
+        "label");
+  }
+
+  std::regex filter(options.filter);
+  for (const auto& benchmark : get_benchmarks()) {
+    for (const auto& args : benchmark->args()) {
+      auto name = get_case_name(*benchmark, args);
+      if (!std::regex_search(name, filter)) {
+        continue;
+      }
+      report(
+          options,
+          isa,
+          name,
+          run_until_min_time(*benchmark, args, options.min_time));
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+Benchmark* RegisterBenchmark(const char* name, Function function) {
+  auto& benchmarks = get_mutable_benchmarks();
+  benchmarks.emplace_back(new Benchmark(name, function));
+  return benchmarks.back().get();
+}
+
+const std::vector<std::unique_ptr<Benchmark>>& get_benchmarks() {
+  return get_mutable_benchmarks();
+}
+
+Op::Op(const char* qualified_name) : name_(qualified_name) {
+  auto operators =
+      torch::jit::getAllOperatorsFor(c10::Symbol::fromQualString(name_));
+  if (!operators.empty()) {
+    operation_ = operators.front()->getOperation();
+  }
+}
+
+void Op::run(torch::jit::Stack& stack) const {
+  TORCH_CHECK(available(), name_, " is not registered in this build");
+  operation_(stack);
+}
+
+at::ScalarType dtype_from_arg(int64_t arg) {
+  return arg == 0 ? at::kFloat : at::kBFloat16;
+}
+
+} // namespace ipex_bench
+
+int main(int argc, char** argv) {
+  ipex_bench::Options options;
+  if (!ipex_bench::parse_options(argc, argv, options)) {
+    return 1;
+  }
+  if (options.isa.empty()) {
+    return ipex_bench::run_benchmarks(options);
+  }
+
+  auto levels = ipex_bench::get_supported_isa_levels();
+  if (options.isa != "all") {
+    if (std::find(levels.begin(), levels.end(), options.isa) == levels.end()) {
+      fprintf(
+          stderr,
+          "ISA level %s is not supported by this CPU or binary\n",
+          options.isa.c_str());
+      return 1;
+    }
+    levels = {options.isa};
+  }
+  int status = 0;
+  bool header = options.header;
+  for (const auto& level : levels) {
+    status |= ipex_bench::run_with_isa_level(argc, argv, level, header);
+    // one CSV header for all the levels
+    header = !options.csv;
+  }
+  return status;
+}
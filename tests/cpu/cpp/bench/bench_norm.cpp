@@ -0,0 +1,65 @@
+#include "bench.h"
+
+namespace {
+
+using ipex_bench::dtype_from_arg;
+using ipex_bench::Op;
+using ipex_bench::State;
+
+// args: rows, hidden size, dtype
+void BM_RMSNorm(State& state) {
+  static const Op rmsnorm("torch_ipex::rmsnorm");
+  int64_t rows = state.range(0);
+  int64_t hidden = state.range(1);
+  auto options = at::TensorOptions().dtype(dtype_from_arg(state.range(2)));
+  auto input = at::randn({rows, hidden}, options);
+  auto weight = at::randn({hidden}, options);
+
+  for (auto _ : state) {
+    rmsnorm(input, weight, 1e-6);
+  }
+  // read the input and the weight, write the output
+  int64_t bytes = 2 * input.nbytes() + weight.nbytes();
+  // square, sum, scale by the rms and by the weight
+  int64_t flops = 4 * input.numel();
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetFlopsProcessed(state.iterations() * flops);
+  state.SetLabel(c10::toString(input.scalar_type()));
+}
+IPEX_BENCHMARK(BM_RMSNorm)
+    ->Args({1, 4096, 0})
+    ->Args({1, 4096, 1})
+    ->Args({2048, 4096, 0})
+    ->Args({2048, 4096, 1})
+    ->Args({2048, 8192, 1});
+
+// args: rows, hidden size, dtype
+void BM_AddLayerNorm(State& state) {
+  static const Op add_layernorm("ipex::add_layernorm");
+  int64_t rows = state.range(0);
+  int64_t hidden = state.range(1);
+  auto options = at::TensorOptions().dtype(dtype_from_arg(state.range(2)));
+  auto a = at::randn({rows, hidden}, options);
+  auto b = at::randn({rows, hidden}, options);
+  auto weight = at::randn({hidden}, options);
+  auto bias = at::randn({hidden}, options);
+  std::vector<int64_t> normalized_shape = {hidden};
+
+  for (auto _ : state) {
+    add_layernorm(a, b, 1, normalized_shape, weight, bias, 1e-5, false);
+  }
+  // read a, b, the weight and the bias, write the output
+  int64_t bytes = 3 * a.nbytes() + weight.nbytes() + bias.nbytes();
+  // add, mean, variance, normalize, scale and shift
+  int64_t flops = 8 * a.numel();
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetFlopsProcessed(state.iterations() * flops);
+  state.SetLabel(c10::toString(a.scalar_type()));
+}
+IPEX_BENCHMARK(BM_AddLayerNorm)
+    ->Args({128, 1024, 0})
+    ->Args({128, 1024, 1})
+    ->Args({2048, 4096, 0})
+    ->Args({2048, 4096, 1});
+
+} // namespace
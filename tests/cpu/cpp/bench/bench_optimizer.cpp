@@ -0,0 +1,136 @@
+#include "bench.h"
+
+namespace {
+
+using ipex_bench::Op;
+using ipex_bench::State;
+
+// The parameter of a fused optimizer step, either float or the split
+// bfloat16 of the IPEX optimizers: the bfloat16 top half in param and the
+// bottom half in trail, with a bfloat16 gradient.
+struct Parameter {
+  at::Tensor param;
+  at::Tensor grad;
+  at::Tensor trail;
+
+  Parameter(int64_t numel, bool split_bf16) {
+    auto master = at::randn({numel});
+    if (split_bf16) {
+      param = master.to(at::kBFloat16);
+      trail = master.sub(param.to(at::kFloat)).to(at::kBFloat16);
+      grad = at::randn({numel}, at::kBFloat16);
+    } else {
+      param = master;
+      trail = at::empty({0}, at::kBFloat16);
+      grad = at::randn({numel});
+    }
+  }
+
+  // read and write the parameter, read the gradient
+  int64_t get_bytes() const {
+    return 2 * (param.nbytes() + trail.nbytes()) + grad.nbytes();
+  }
+
+  std::string get_label() const {
+    return trail.numel() > 0 ? "split BFloat16" : "Float";
+  }
+};
+
+// The optimizers are bound by the bandwidth, only the bytes are counted.
+// args: numel, split bfloat16
+void BM_AdamFusedStep(State& state) {
+  static const Op adam("torch_ipex::adam_fused_step");
+  Parameter p(state.range(0), state.range(1));
+  auto exp_avg = at::zeros({state.range(0)});
+  auto exp_avg_sq = at::zeros({state.range(0)});
+  auto max_exp_avg_sq = at::empty({0});
+
+  for (auto _ : state) {
+    adam(
+        p.param,
+        exp_avg,
+        exp_avg_sq,
+        max_exp_avg_sq,
+        p.grad,
+        p.trail,
+        false,
+        1.0,
+        0.9,
+        0.999,
+        1e-3,
+        1e-2,
+        1e-8);
+  }
+  int64_t bytes = p.get_bytes() + 2 * (exp_avg.nbytes() + exp_avg_sq.nbytes());
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetLabel(p.get_label());
+}
+IPEX_BENCHMARK(BM_AdamFusedStep)
+    ->Args({16 * 1024 * 1024, 0})
+    ->Args({16 * 1024 * 1024, 1});
+
+// args: numel, split bfloat16
+void BM_LambFusedStep(State& state) {
+  static const Op lamb("torch_ipex::lamb_fused_step");
+  Parameter p(state.range(0), state.range(1));
+  auto exp_avg = at::zeros({state.range(0)});
+  auto exp_avg_sq = at::zeros({state.range(0)});
+
+  for (auto _ : state) {
+    lamb(
+        p.param,
+        exp_avg,
+        exp_avg_sq,
+        p.grad,
+        p.trail,
+        1,
+        0.9,
+        0.999,
+        1e-3,
+        1e-2,
+        1e-6);
+  }
+  // the tensors only, not the workspace of the trust ratio
+  int64_t bytes = p.get_bytes() + 2 * (exp_avg.nbytes() + exp_avg_sq.nbytes());
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetLabel(p.get_label());
+}
+IPEX_BENCHMARK(BM_LambFusedStep)
+    ->Args({16 * 1024 * 1024, 0})
+    ->Args({16 * 1024 * 1024, 1});
+
+// args: numel, split bfloat16
+void BM_SgdFusedStep(State& state) {
+  static const Op sgd("torch_ipex::sgd_fused_step");
+  Parameter p(state.range(0), state.range(1));
+  auto momentum_buf = at::zeros({state.range(0)});
+
+  for (auto _ : state) {
+    sgd(p.param, p.grad, momentum_buf, p.trail, 0.9, 1e-3, 1e-4, 0.0, false);
+  }
+  int64_t bytes = p.get_bytes() + 2 * momentum_buf.nbytes();
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetLabel(p.get_label());
+}
+IPEX_BENCHMARK(BM_SgdFusedStep)
+    ->Args({16 * 1024 * 1024, 0})
+    ->Args({16 * 1024 * 1024, 1});
+
+// args: numel, split bfloat16
+void BM_AdagradFusedStep(State& state) {
+  static const Op adagrad("torch_ipex::adagrad_fused_step");
+  Parameter p(state.range(0), state.range(1));
+  auto state_sum = at::zeros({state.range(0)});
+
+  for (auto _ : state) {
+    adagrad(p.param, p.grad, state_sum, p.trail, 1.0, 1e-2, 0.0, 0.0, 1e-10);
+  }
+  int64_t bytes = p.get_bytes() + 2 * state_sum.nbytes();
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetLabel(p.get_label());
+}
+IPEX_BENCHMARK(BM_AdagradFusedStep)
+    ->Args({16 * 1024 * 1024, 0})
+    ->Args({16 * 1024 * 1024, 1});
+
+} // namespace
@@ -119,6 +119,67 @@ class TestFunction(TestCase):
                 out_autocast = _conv(_in_cpu)
             self.assertEqual(out_autocast.dtype, torch.float)
 
+    def test_autocast_weight_cache(self):
+        linear = torch.nn.Linear(16, 16)
+        for grad_mode in [torch.no_grad, torch.inference_mode]:
+            core.clear_autocast_weight_cache()
+            with grad_mode():
+                x = torch.randn(4, 16)
+                for _ in range(2):
+                    with torch.cpu.amp.autocast(enabled=True, dtype=torch.bfloat16):
+                        y = linear(x)
+                    # the casts of the weight and the bias outlive autocast
+                    self.assertEqual(core.get_autocast_weight_cache_size(), 2)
+
+                # an in-place update of the weight drops its cast
+                linear.weight.add_(1)
+                with torch.cpu.amp.autocast(enabled=True, dtype=torch.bfloat16):
+                    y = linear(x)
+                y_ref = torch.nn.functional.linear(
+                    x.bfloat16(), linear.weight.bfloat16(), linear.bias.bfloat16()
+                )
+                self.assertEqual(y, y_ref)
+
+        # the inputs are not cached, even if made outside of inference_mode
+        core.clear_autocast_weight_cache()
+        x = torch.randn(4, 16)
+        with torch.inference_mode():
+            with torch.cpu.amp.autocast(enabled=True, dtype=torch.bfloat16):
+                y = torch.nn.functional.linear(x, linear.weight)
+            self.assertEqual(core.get_autocast_weight_cache_size(), 1)
+
+        # a frozen weight is only cached once registered, and dropped with it
+        frozen = torch.randn(16, 16)
+        core.clear_autocast_weight_cache()
+        with torch.no_grad(), torch.cpu.amp.autocast(
+            enabled=True, dtype=torch.bfloat16
+        ):
+            y = torch.nn.functional.linear(x, frozen)
+            self.assertEqual(core.get_autocast_weight_cache_size(), 0)
+            core.register_autocast_weight(frozen)
+            y = torch.nn.functional.linear(x, frozen)
+            self.assertEqual(core.get_autocast_weight_cache_size(), 1)
+            del frozen
+            y = linear(x)
+        self.assertEqual(core.get_autocast_weight_cache_size(), 2)
+
+        # not cached in training
+        core.clear_autocast_weight_cache()
+        x = torch.randn(4, 16)
+        with torch.cpu.amp.autocast(enabled=True, dtype=torch.bfloat16):
+            y = linear(x)
+        self.assertEqual(core.get_autocast_weight_cache_size(), 0)
+
+        core.set_autocast_weight_cache_enabled(False)
+        try:
+            with torch.no_grad(), torch.cpu.amp.autocast(
+                enabled=True, dtype=torch.bfloat16
+            ):
+                y = linear(x)
+            self.assertEqual(core.get_autocast_weight_cache_size(), 0)
+        finally:
+            core.set_autocast_weight_cache_enabled(True)
+
 
 class TestAutocastWithJit(TestCase):
     def setUp(self):
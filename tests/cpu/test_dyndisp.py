@@ -2,6 +2,7 @@ import unittest
 import os
 import subprocess
 
+import torch
 import intel_extension_for_pytorch._C as core
 
 supported_isa_set = [
@@ -117,6 +118,60 @@ class TestDynDisp(unittest.TestCase):
             cur_ipex_isa_1 = str(out[-1], "utf-8").strip()
             self.assertTrue(cur_ipex_isa == cur_ipex_isa_1)
 
+    def test_get_dispatch_stubs(self):
+        stubs = {stub["name"]: stub for stub in core._get_dispatch_stubs()}
+        stub = stubs["get_current_isa_level_kernel_stub"]
+        self.assertIn("DEFAULT", stub["isa_levels"])
+        self.assertEqual(stub["current_isa_level"], core._get_current_isa_level())
+        self.assertFalse(stub["overridden"])
+        for stub in stubs.values():
+            for isa in stub["isa_levels"]:
+                self.assertIn(isa.lower(), supported_isa_set)
+
+    def test_set_dispatch_stub_isa_level(self):
+        name = "get_current_isa_level_kernel_stub"
+        cur_isa = core._get_current_isa_level()
+        max_cpu_isa = get_isa_val(get_highest_cpu_support_isa_level())
+        stub = [s for s in core._get_dispatch_stubs() if s["name"] == name][0]
+        try:
+            for isa in stub["isa_levels"]:
+                if get_isa_val(isa.lower()) > max_cpu_isa:
+                    continue
+                core._set_dispatch_stub_isa_level(name, isa)
+                self.assertEqual(core._get_current_isa_level(), isa)
+                stubs = {s["name"]: s for s in core._get_dispatch_stubs()}
+                self.assertEqual(stubs[name]["current_isa_level"], isa)
+                self.assertTrue(stubs[name]["overridden"])
+        finally:
+            core._reset_dispatch_stub_isa_level(name)
+        self.assertEqual(core._get_current_isa_level(), cur_isa)
+
+    def test_set_dispatch_stub_isa_level_rmsnorm(self):
+        name = "rmsnorm_kernel_stub"
+        max_cpu_isa = get_isa_val(get_highest_cpu_support_isa_level())
+        stub = [s for s in core._get_dispatch_stubs() if s["name"] == name][0]
+        x = torch.randn(4, 35)
+        weight = torch.randn(35)
+        ref = torch.ops.torch_ipex.rmsnorm(x, weight, 1e-6)
+        try:
+            for isa in stub["isa_levels"]:
+                if get_isa_val(isa.lower()) > max_cpu_isa:
+                    continue
+                core._set_dispatch_stub_isa_level(name, isa)
+                out = torch.ops.torch_ipex.rmsnorm(x, weight, 1e-6)
+                torch.testing.assert_close(out, ref, rtol=1e-5, atol=1e-5)
+        finally:
+            core._reset_dispatch_stub_isa_level(name)
+
+    def test_set_dispatch_stub_isa_level_invalid(self):
+        name = "get_current_isa_level_kernel_stub"
+        with self.assertRaises(RuntimeError):
+            core._set_dispatch_stub_isa_level("not_a_stub", "default")
+        with self.assertRaises(RuntimeError):
+            core._set_dispatch_stub_isa_level(name, "sse")
+        with self.assertRaises(RuntimeError):
+            core._reset_dispatch_stub_isa_level("not_a_stub")
+
 
 if __name__ == "__main__":
     unittest.main()
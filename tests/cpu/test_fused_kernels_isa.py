@@ -0,0 +1,148 @@
+import os
+import subprocess
+import sys
+import unittest
+
+import torch
+import intel_extension_for_pytorch  # noqa: F401
+import intel_extension_for_pytorch._C as core
+from common_utils import TestCase
+
+# The ISA levels compiled with the AVX2 kernels, default is built for AVX2
+# as well.
+avx2_isa_levels = ["default", "avx2", "avx2_vnni"]
+
+isa_level_order = [
+    "default",
+    "avx2",
+    "avx2_vnni",
+    "avx512",
+    "avx512_vnni",
+    "avx512_bf16",
+    "amx",
+    "avx512_fp16",
+]
+
+
+def get_supported_avx2_isa_levels():
+    highest = min(
+        isa_level_order.index(core._get_highest_binary_support_isa_level().lower()),
+        isa_level_order.index(core._get_highest_cpu_support_isa_level().lower()),
+    )
+    return [isa for isa in avx2_isa_levels if isa_level_order.index(isa) <= highest]
+
+
+class FusedKernelTester(TestCase):
+    # sizes with and without a tail of the 8 and 16 wide vectors
+    sizes = [7, 16, 35, 4099]
+
+    def test_rmsnorm(self):
+        for size in self.sizes:
+            x = torch.randn(3, size)
+            weight = torch.randn(size)
+            for dtype in [torch.float, torch.bfloat16]:
+                x_ = x.to(dtype)
+                x_fp32 = x_.float()
+                variance = x_fp32.pow(2).mean(-1, keepdim=True)
+                ref = (weight * x_fp32 * torch.rsqrt(variance + 1e-6)).to(dtype)
+                out = torch.ops.torch_ipex.rmsnorm(x_, weight, 1e-6)
+                prec = 2e-2 if dtype == torch.bfloat16 else 1e-5
+                self.assertEqual(out, ref, prec=prec)
+
+    def test_add_layernorm(self):
+        for size in self.sizes:
+            a = torch.randn(3, size)
+            b = torch.randn(3, size)
+            weight = torch.randn(size)
+            bias = torch.randn(size)
+            for dtype in [torch.float, torch.bfloat16]:
+                a_, b_ = a.to(dtype), b.to(dtype)
+                w_, bias_ = weight.to(dtype), bias.to(dtype)
+                ref = torch.nn.functional.layer_norm(
+                    (a_.float() + b_.float()), [size], w_.float(), bias_.float(), 1e-5
+                ).to(dtype)
+                out = torch.ops.ipex.add_layernorm(
+                    a_, b_, 1, [size], w_, bias_, 1e-5, False
+                )
+                prec = 5e-2 if dtype == torch.bfloat16 else 1e-5
+                self.assertEqual(out, ref, prec=prec)
+
+    def test_add_softmax(self):
+        for size in self.sizes:
+            a = torch.randn(4, size)
+            b = torch.randn(size)
+            ref = a.add(b).softmax(-1)
+            out = torch.ops.torch_ipex.add_softmax_(a, b)
+            self.assertEqual(out, ref)
+
+    def test_div_add_softmax(self):
+        for size in self.sizes:
+            q = torch.randn(2, 3, 5, 8)
+            k = torch.randn(2, 3, 8, size)
+            rel_qk = torch.randn(2, 1, 1, size)
+            ref = (q.matmul(k) / 8 + rel_qk).softmax(-1)
+            out = torch.ops.ipex.mha_scores_calc(q, k, rel_qk, 1, 8, -1, None)
+            self.assertEqual(out, ref)
+
+    def test_concat_bn_relu(self):
+        channels = [16, 32, 48]
+        inputs = [
+            torch.randn(2, c, 5, 5).to(memory_format=torch.channels_last)
+            for c in channels
+        ]
+        scale = torch.randn(sum(channels))
+        beta = torch.randn(sum(channels))
+        for dtype in [torch.float, torch.bfloat16]:
+            inputs_ = [x.to(dtype) for x in inputs]
+            ref = torch.relu(
+                torch.cat(inputs_, 1).float() * scale.view(1, -1, 1, 1)
+                + beta.view(1, -1, 1, 1)
+            ).to(dtype)
+            out = torch.ops.ipex.concat_bn_relu(
+                inputs_, scale, beta, None, None, None, None, False, 0.1, 1e-5, False, 1
+            )
+            self.assertEqual(out, ref, prec=2e-2 if dtype == torch.bfloat16 else 1e-5)
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+
+    def test_flash_attention(self):
+        # more than one q and kv block of the kernel, with a tail
+        for seq_len, head_size in [(37, 64), (600, 32)]:
+            q = torch.randn(1, seq_len, 2, head_size).bfloat16()
+            k = torch.randn(1, seq_len, 2, head_size).bfloat16()
+            v = torch.randn(1, seq_len, 2, head_size).bfloat16()
+            mask = torch.randn(1, 1, seq_len, seq_len).bfloat16()
+            scale = head_size**0.5
+            qk = q.float().transpose(1, 2).matmul(k.float().permute(0, 2, 3, 1))
+            probs = (qk / scale + mask.float()).softmax(-1)
+            ref = probs.matmul(v.float().transpose(1, 2))
+            out = torch.ops.torch_ipex.flash_attention(q, k, v, scale, mask)
+            self.assertEqual(out.float(), ref, prec=3e-2)
+
+
+class FusedKernelIsaTester(TestCase):
+    # Runs the fused kernel tests and the RNN-T update batch test again with
+    # every ISA level built with the AVX2 kernels, in a new process since the
+    # level is fixed when the library is loaded.
+    def test_fused_kernels_with_avx2_isa_levels(self):
+        loc = os.path.dirname(os.path.abspath(__file__))
+        for isa in get_supported_avx2_isa_levels():
+            with self.subTest(isa=isa):
+                env = dict(os.environ, ATEN_CPU_CAPABILITY=isa)
+                result = subprocess.run(
+                    [
+                        sys.executable,
+                        "-m",
+                        "unittest",
+                        "test_fused_kernels_isa.FusedKernelTester",
+                        "test_rnnt_custom_kernel.TestRNNTUpdateBatch",
+                    ],
+                    cwd=loc,
+                    env=env,
+                    stdout=subprocess.PIPE,
+                    stderr=subprocess.STDOUT,
+                )
+                self.assertEqual(result.returncode, 0, msg=str(result.stdout, "utf-8"))
+
+
+if __name__ == "__main__":
+    test = unittest.main()
@@ -5456,6 +5456,52 @@ class Tester(TestCase):
             self.test_output_linear_add_relu()
             self.test_output_linear_add()
 
+    def test_jit_memory_planning(self):
+        class ConvLinear(nn.Module):
+            def __init__(self):
+                super(ConvLinear, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = nn.Conv2d(8, 8, 3, padding=1)
+                self.linear1 = nn.Linear(8 * 8 * 8, 32)
+                self.linear2 = nn.Linear(32, 10)
+
+            def forward(self, x):
+                x = F.relu(self.conv1(x))
+                x = self.conv2(x).flatten(1)
+                x = F.relu(self.linear1(x))
+                return self.linear2(x)
+
+        base = ConvLinear().eval()
+        x = torch.randn(2, 3, 8, 8)
+        x2 = torch.randn(4, 3, 8, 8)
+        # the fp32 linear runs the MKL sgemm by default and oneDNN with the
+        # auto kernel selection
+        for auto_kernel_selection, linear_run in [
+            (False, "ipex_prepack::mkl_sgemm_run"),
+            (True, "ipex_prepack::linear_run"),
+        ]:
+            model = ipex.optimize(base, auto_kernel_selection=auto_kernel_selection)
+            ipex._C.enable_jit_memory_planning()
+            try:
+                with torch.no_grad():
+                    trace_model = torch.jit.freeze(torch.jit.trace(model, x))
+                    for _ in range(3):
+                        y = trace_model(x)
+                    trace_graph = trace_model.graph_for(x)
+                    # the plan is for the profiled shape, other shapes allocate
+                    y2 = trace_model(x2)
+            finally:
+                ipex._C.disable_jit_memory_planning()
+            with torch.no_grad():
+                self.assertEqual(y, base(x))
+                self.assertEqual(y2, base(x2))
+            kinds = [n.kind() for n in trace_graph.nodes()]
+            self.assertIn("ipex_prepack::convolution_planned_run", kinds)
+            self.assertIn(linear_run.replace("_run", "_planned_run"), kinds)
+            # the graph output is never planned
+            self.assertIn(linear_run, kinds)
+        self.assertFalse(ipex._C.get_jit_memory_planning())
+
     def test_replace_PythonGELU_with_AtenGELU(self):
         for i in range(5):
             model_v1 = Python_GELU_Tanh_v1().eval()
@@ -1016,6 +1016,81 @@ class TestAPI(JitLlgaTestCase):
         # set the value back to the default one
         ipex._C._jit_set_llga_weight_cache_enabled(weight_cache_enabled_default_value)
 
+    @llga_fp32_bf16_test_env
+    def test_shared_partition_cache(self):
+        import threading
+
+        self.assertTrue(ipex._C._jit_llga_shared_partition_cache_enabled())
+        m = nn.Conv2d(3, 8, kernel_size=3, padding=1)
+        x = torch.rand(1, 3, 16, 16)
+        graph, traced = self.checkTrace(m, [x])
+        self.assertGraphContainsExactly(graph, LLGA_FUSION_GROUP, 1)
+        ipex._C._jit_clear_llga_shared_partition_cache()
+
+        def run():
+            with torch.no_grad():
+                traced(x)
+
+        # every new thread misses its thread local cache, only the first one
+        # should compile the partition
+        for _ in range(3):
+            t = threading.Thread(target=run)
+            t.start()
+            t.join()
+        stats = ipex._C._jit_llga_shared_partition_cache_stats()
+        self.assertEqual(stats["misses"], 1)
+        self.assertEqual(stats["hits"], 2)
+        self.assertEqual(stats["size"], 1)
+
+        # a capacity of 0 flushes the cache and keeps it empty
+        capacity = stats["capacity"]
+        try:
+            ipex._C._jit_set_llga_shared_partition_cache_capacity(0)
+            self.assertEqual(
+                ipex._C._jit_llga_shared_partition_cache_stats()["size"], 0
+            )
+            t = threading.Thread(target=run)
+            t.start()
+            t.join()
+            self.assertEqual(
+                ipex._C._jit_llga_shared_partition_cache_stats()["size"], 0
+            )
+        finally:
+            ipex._C._jit_set_llga_shared_partition_cache_capacity(capacity)
+
+    def test_alternating_input_shapes(self):
+        m = nn.Conv2d(3, 8, kernel_size=3, padding=1)
+        x = torch.rand(1, 3, 16, 16)
+        graph, traced = self.checkTrace(m, [x])
+        self.assertGraphContainsExactly(graph, LLGA_FUSION_GROUP, 1)
+        # a shape change must not reuse the entry of the previous run
+        with torch.no_grad():
+            for shape in [(1, 3, 16, 16), (2, 3, 8, 8), (1, 3, 16, 16), (2, 3, 8, 8)]:
+                y = torch.rand(shape)
+                self.assertEqual(traced(y), m(y))
+
+    def test_persistent_partition_cache(self):
+        import tempfile
+
+        m = nn.Conv2d(3, 8, kernel_size=3, padding=1)
+        x = torch.rand(1, 3, 16, 16)
+        old_dir = ipex._C._jit_llga_persistent_cache_dir()
+        try:
+            with tempfile.TemporaryDirectory() as cache_dir:
+                ipex._C._jit_set_llga_persistent_cache_dir(cache_dir)
+                graph, _ = self.checkTrace(m, [x])
+                self.assertGraphContainsExactly(graph, LLGA_FUSION_GROUP, 1)
+                self.assertEqual(len(os.listdir(cache_dir)), 1)
+
+                # a new kernel for the same partition compiles the recorded
+                # shapes when it is created, so its first run is a cache hit
+                ipex._C._jit_clear_llga_shared_partition_cache()
+                self.checkTrace(m, [x])
+                stats = ipex._C._jit_llga_shared_partition_cache_stats()
+                self.assertGreaterEqual(stats["hits"], 1)
+        finally:
+            ipex._C._jit_set_llga_persistent_cache_dir(old_dir)
+
 
 class TestDebugLog(JitLlgaTestCase):
     def test_fusion_group_name(self):
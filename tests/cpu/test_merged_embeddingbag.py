@@ -2,10 +2,12 @@ import torch
 import unittest
 from torch.testing._internal.common_utils import TestCase
 from bench.custom_op_bench.merged_embeddingbag import (
+    zipf_indices,
     EmbeddingBagList,
     MergedEmb,
     EmbeddingBagListCatDense,
     MergedEmbCatDense,
+    MergedEmbDedup,
     MergedEmbSGD,
     MergedEmbAdaGrad,
 )
@@ -160,6 +162,110 @@ class TestMergedEmbedding(TestCase):
                             dense = torch.randn(B, NUM_DIM, dtype=dtype)
                             self._test_inference(m, ref_m, (indices, offsets, dense))
 
+    def test_dedup_inference(self):
+        B = 1029
+        NUM_TABLE = 26
+        for mode in ["mean", "sum"]:
+            for index_type in [torch.int32, torch.int64]:
+                # power-law indices have many repeated rows across bags
+                indices = [
+                    zipf_indices(B * self.multi_hot[i], 1000, 1.05).to(index_type)
+                    for i in range(NUM_TABLE)
+                ]
+                for include_last_offset in [True, False]:
+                    n_offset = B + 1 if include_last_offset else B
+                    offsets = [
+                        torch.arange(
+                            0, n_offset * self.multi_hot[i], self.multi_hot[i]
+                        ).to(index_type)
+                        for i in range(NUM_TABLE)
+                    ]
+                    for dtype in [torch.float32, torch.bfloat16, torch.float16]:
+                        for NUM_DIM in [128, 129]:
+                            emb_list = EmbeddingBagList(
+                                NUM_TABLE,
+                                NUM_DIM,
+                                dtype,
+                                include_last_offset=include_last_offset,
+                                mode=mode,
+                            )
+                            m = MergedEmbDedup(emb_list)
+                            ref_m = copy.deepcopy(emb_list)
+                            self._test_inference(m, ref_m, (indices, offsets))
+
+    def _rowwise_dequantize(self, qweight, bits, dim):
+        packed = (dim + 1) // 2 if bits == 4 else dim
+        scale = qweight[:, packed : packed + 4].contiguous().view(torch.float32)
+        bias = qweight[:, packed + 4 : packed + 8].contiguous().view(torch.float32)
+        q = qweight[:, :packed]
+        if bits == 4:
+            q = torch.stack([q & 0x0F, q >> 4], dim=2).reshape(q.size(0), -1)
+            q = q[:, :dim]
+        return q.float() * scale + bias
+
+    def test_rowwise_quantized_cat(self):
+        B = 1029
+        NUM_TABLE = 26
+        # mixed precision: per table 4 or 8 bits
+        weight_bits = [4 if i % 3 == 0 else 8 for i in range(NUM_TABLE)]
+        for index_type in [torch.int32, torch.int64]:
+            indices = [
+                torch.randint(1000, (B * self.multi_hot[i],)).to(index_type)
+                for i in range(NUM_TABLE)
+            ]
+            for include_last_offset in [True, False]:
+                n_offset = B + 1 if include_last_offset else B
+                offsets = [
+                    torch.arange(0, n_offset * self.multi_hot[i], self.multi_hot[i]).to(
+                        index_type
+                    )
+                    for i in range(NUM_TABLE)
+                ]
+                for NUM_DIM in [128, 129]:
+                    emb_list = EmbeddingBagList(
+                        NUM_TABLE,
+                        NUM_DIM,
+                        torch.float32,
+                        include_last_offset=include_last_offset,
+                    )
+                    merged = ipex.nn.modules.MergedEmbeddingBagWithCat.from_embeddingbag_list(
+                        emb_list.list
+                    )
+                    m = ipex.nn.modules.RowwiseQuantizedMergedEmbeddingBagWithCat.from_float(
+                        merged, weight_bits
+                    )
+                    # reference runs on the dequantized tables
+                    ref_list = copy.deepcopy(emb_list)
+                    for i, qweight in enumerate(m.qweights):
+                        self.assertEqual(
+                            qweight.size(1),
+                            (
+                                (NUM_DIM + 1) // 2 + 8
+                                if weight_bits[i] == 4
+                                else NUM_DIM + 8
+                            ),
+                        )
+                        deq = self._rowwise_dequantize(qweight, weight_bits[i], NUM_DIM)
+                        w = emb_list.list[i].weight.detach()
+                        max_err = (w.max(1)[0] - w.min(1)[0]) / (
+                            2 * (2 ** weight_bits[i] - 1)
+                        )
+                        self.assertTrue(
+                            ((deq - w).abs().max(1)[0] <= max_err + 1e-6).all()
+                        )
+                        ref_list.list[i].weight.data.copy_(deq)
+                    ref_m = EmbeddingBagListCatDense(ref_list)
+                    for dtype in [torch.float32, torch.bfloat16]:
+                        dense = torch.randn(B, NUM_DIM, dtype=dtype)
+                        with torch.no_grad():
+                            out = m(indices, offsets, dense)
+                            ref_out = ref_m(indices, offsets, dense.float())
+                        self.assertEqual(out.dtype, dtype)
+                        if dtype == torch.float32:
+                            self.assertEqual(out, ref_out, rtol=1e-4, atol=1e-4)
+                        else:
+                            self.assertEqual(out.float(), ref_out, rtol=1e-2, atol=1e-2)
+
     def test_training(self):
         B = 1029
         NUM_TABLE = 26
@@ -801,6 +801,37 @@ class TransFreeMHATester(TestCase):
                     )
                 )
 
+    def test_linear_qkv_split_heads_fp32(self):
+        mat = torch.randn(3, 24, 64)
+        mask = torch.randn(3, 1, 1, 24)
+        for auto_kernel_selection, fused_op in [
+            (False, "ipex_prepack::mkl_sgemm_qkv_run"),
+            (True, "ipex_prepack::linear_qkv_run"),
+        ]:
+            mha_model = MHA_Model_BERT(8, 4, 16, [0, 2, 1, 3], -1, -2).eval()
+            mha_ipex = ipex.optimize(
+                mha_model,
+                dtype=torch.float,
+                level="O1",
+                auto_kernel_selection=auto_kernel_selection,
+            )
+            with torch.no_grad():
+                mha_ipex = torch.jit.trace(mha_ipex, (mat, mask))
+                mha_ipex = torch.jit.freeze(mha_ipex)
+
+                for _ in range(2):
+                    mha_jit = mha_ipex(mat, mask)
+                mha_ref = mha_model(mat, mask)
+                self.assertEqual(mha_ref, mha_jit, prec=1e-5)
+
+                # the concatenated qkv linear writes the head-major q/k/v
+                # directly, without the split and the per-head view/permute
+                mha_graph = mha_ipex.graph_for(mat, mask)
+                self.assertTrue(any(n.kind() == fused_op for n in mha_graph.nodes()))
+                self.assertFalse(
+                    any(n.kind() == "aten::split_with_sizes" for n in mha_graph.nodes())
+                )
+
     def test_fake_mha_fp32(self):
         mat = torch.randn(16, 16, 256)
         mask_base = torch.randn(16, 1, 1, 16)
@@ -238,6 +238,31 @@ class TestNMS(TestCase):
         self.assertEqual(output2_raw_double, output2_raw)
         self.assertTrue(output2_raw_double[0].dtype == torch.float64)
 
+    def test_batch_nms_multi_batch(self):
+        criteria = 0.50
+        max_output = 200
+        torch.manual_seed(0)
+        batch_size, number_boxes, class_number = 3, 2000, 11
+        xy = torch.rand(batch_size, number_boxes, 2)
+        wh = torch.rand(batch_size, number_boxes, 2) * 0.3
+        bboxes = torch.cat([xy, xy + wh], dim=2)
+        probs = torch.rand(batch_size, number_boxes, class_number).softmax(-1)
+        # The last image has no score above the score threshold.
+        probs[-1] = 0.01
+        output_raw = batch_score_nms(bboxes, probs, criteria, max_output)
+        self.assertEqual(output_raw[3].tolist()[-1], 0)
+        idx = 0
+        for i in range(batch_size):
+            length = output_raw[3][i]
+            if length > 0:
+                loc, label, prob = self.decode_single(
+                    bboxes[i], probs[i], criteria, max_output
+                )
+                self.assertEqual(loc, output_raw[0][idx : idx + length])
+                self.assertEqual(label, output_raw[1][idx : idx + length])
+                self.assertEqual(prob, output_raw[2][idx : idx + length])
+            idx += length
+
     def test_jit_trace_batch_nms(self):
         class Batch_NMS(nn.Module):
             def __init__(self, criteria, max_output):
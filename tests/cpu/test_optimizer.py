@@ -280,6 +280,65 @@ class TestOptimizers(TestCase):
                 M, adam, dtype, split_master_weight_for_bf16, set_to_none, fused
             )
 
+    def test_fused_clip_unscale_step(self):
+        grad_norm_non_finite_check = torch.ops.torch_ipex.grad_norm_non_finite_check
+        grads = [torch.randn(7), torch.randn(31, 33), torch.randn(300, 300).bfloat16()]
+        norm, found_inf = grad_norm_non_finite_check(grads)
+        ref_norm = torch.stack([g.float().norm() for g in grads]).norm()
+        self.assertEqual(norm, ref_norm.item(), rtol=1e-4, atol=1e-4)
+        self.assertFalse(found_inf)
+        for non_finite in [float("inf"), float("nan")]:
+            grads[1][3, 4] = non_finite
+            self.assertTrue(grad_norm_non_finite_check(grads)[1])
+
+        scale = 1024.0
+        max_norm = 0.1
+        for optimizer_class, kwargs in [
+            (torch.optim.SGD, {"lr": 0.1, "momentum": 0.9}),
+            (torch.optim.Adam, {"lr": 0.01, "weight_decay": 0.1}),
+            (ipex.optim._lamb.Lamb, {"lr": 0.01}),
+        ]:
+            M = TestModule()
+            optimizer = optimizer_class(M.parameters(), **kwargs)
+            ipex_module, ipex_optimizer = ipex.optimize(
+                M, optimizer=optimizer_class(M.parameters(), **kwargs)
+            )
+            self.assertTrue(ipex_optimizer._step_supports_amp_scaling)
+            scaler = torch.cpu.amp.GradScaler(init_scale=scale)
+            for _ in range(2):
+                # unscale and clip_grad_norm_ as separate passes
+                optimizer.zero_grad()
+                (M(*M.input).sum() * scale).backward()
+                for p in M.parameters():
+                    if p.grad is not None:
+                        p.grad.div_(scale)
+                torch.nn.utils.clip_grad_norm_(M.parameters(), max_norm)
+                optimizer.step()
+                # fused into the step
+                ipex_optimizer.zero_grad()
+                scaler.scale(ipex_module(*ipex_module.input).sum()).backward()
+                scaler.step(ipex_optimizer, max_grad_norm=max_norm)
+                scaler.update()
+            self.assertEqual(scaler.get_scale(), scale)
+            origin_model_state = M.state_dict()
+            ipex_model_state = {
+                k: v.clone() for k, v in ipex_module.state_dict().items()
+            }
+            for var_name in origin_model_state:
+                self.assertEqual(
+                    origin_model_state[var_name], ipex_model_state[var_name]
+                )
+
+            # the step is skipped on inf/nan grads and the scale backs off
+            ipex_optimizer.zero_grad()
+            loss = ipex_module(*ipex_module.input).sum() * float("inf")
+            scaler.scale(loss).backward()
+            scaler.step(ipex_optimizer, max_grad_norm=max_norm)
+            scaler.update()
+            self.assertEqual(scaler.get_scale(), scale / 2)
+            for var_name, value in ipex_module.state_dict().items():
+                self.assertEqual(value, ipex_model_state[var_name])
+
 
 class TestFusedSteps(TestCase):
     def test_lamb_step(self):
@@ -965,6 +1024,185 @@ class TestFusedSteps(TestCase):
         grad2 = base_grad.bfloat16()[10:20, 10:20]
         self._test_packed_add(param, grad, param2, trail, grad2)
 
+    def test_multi_tensor_steps(self):
+        # small parameters share one parallel region, the large one is split
+        shapes = [(7,), (31, 33), (64,), (300, 300), (3, 5, 5)]
+        params = [torch.randn(shape) for shape in shapes]
+        grads = [torch.randn(shape) for shape in shapes]
+        # mixed fp32 and split bf16 parameters
+        split = [torch.ops.torch_ipex.split_float_bfloat16(p) for p in params]
+        ref_params = [
+            p.clone() if i % 2 == 0 else split[i][0].clone()
+            for i, p in enumerate(params)
+        ]
+        ref_params2 = [
+            torch.Tensor() if i % 2 == 0 else split[i][1].clone()
+            for i in range(len(params))
+        ]
+        ref_grads = [g if i % 2 == 0 else g.bfloat16() for i, g in enumerate(grads)]
+        multi_params = [p.clone() for p in ref_params]
+        multi_params2 = [p.clone() for p in ref_params2]
+        exp_avgs = [torch.randn(shape).abs() for shape in shapes]
+        exp_avg_sqs = [torch.randn(shape).abs() for shape in shapes]
+        multi_exp_avgs = [t.clone() for t in exp_avgs]
+        multi_exp_avg_sqs = [t.clone() for t in exp_avg_sqs]
+        steps = [float(i + 1) for i in range(len(params))]
+
+        for i in range(len(params)):
+            torch.ops.torch_ipex.adam_fused_step(
+                ref_params[i],
+                exp_avgs[i],
+                exp_avg_sqs[i],
+                torch.Tensor(),
+                ref_grads[i],
+                ref_params2[i],
+                False,
+                steps[i],
+                0.8,
+                0.9,
+                0.1,
+                0.3,
+                0.001,
+            )
+        torch.ops.torch_ipex.adam_fused_step_multi_tensor(
+            multi_params,
+            multi_exp_avgs,
+            multi_exp_avg_sqs,
+            [],
+            ref_grads,
+            multi_params2,
+            False,
+            steps,
+            0.8,
+            0.9,
+            0.1,
+            0.3,
+            0.001,
+        )
+        self.assertEqual(ref_params, multi_params)
+        self.assertEqual(ref_params2, multi_params2)
+        self.assertEqual(exp_avgs, multi_exp_avgs)
+        self.assertEqual(exp_avg_sqs, multi_exp_avg_sqs)
+
+        ref_bufs = [None] * len(params)
+        for i in range(len(params)):
+            ref_bufs[i] = torch.ops.torch_ipex.sgd_fused_step(
+                ref_params[i],
+                ref_grads[i],
+                ref_bufs[i],
+                ref_params2[i],
+                0.9,
+                0.1,
+                0.3,
+                0.0,
+                True,
+            )
+        multi_bufs = torch.ops.torch_ipex.sgd_fused_step_multi_tensor(
+            multi_params,
+            ref_grads,
+            [None] * len(params),
+            multi_params2,
+            0.9,
+            0.1,
+            0.3,
+            0.0,
+            True,
+        )
+        self.assertEqual(ref_params, multi_params)
+        self.assertEqual(ref_params2, multi_params2)
+        self.assertEqual(ref_bufs, multi_bufs)
+
+    def test_quantized_state_steps(self):
+        quantize = torch.ops.torch_ipex.quantize_optimizer_state
+        dequantize = torch.ops.torch_ipex.dequantize_optimizer_state
+        # the last block is partial
+        param = torch.randn(31, 33)
+        grad = torch.randn(31, 33)
+        exp_avg = torch.randn(31, 33) * 0.1
+        exp_avg_sq = torch.randn(31, 33).abs() * 0.01
+
+        q_avg, avg_absmax = quantize(exp_avg, False)
+        q_avg_sq, avg_sq_absmax = quantize(exp_avg_sq, True)
+        self.assertEqual(q_avg.dtype, torch.int8)
+        self.assertEqual(q_avg_sq.dtype, torch.uint8)
+        self.assertEqual(avg_absmax.numel(), (param.numel() + 255) // 256)
+        # roundtrip error is bounded by the block absmax
+        ref_avg = dequantize(q_avg, avg_absmax, False).view(31, 33)
+        ref_avg_sq = dequantize(q_avg_sq, avg_sq_absmax, True).view(31, 33)
+        self.assertEqual(ref_avg, exp_avg, rtol=0, atol=0.1 / 127 * 4)
+        self.assertEqual(ref_avg_sq, exp_avg_sq, rtol=0.1, atol=1e-4)
+
+        hyper_params = (0.8, 0.9, 0.1, 0.3, 0.001)
+        for is_adam in [True, False]:
+            # fp32 reference starts from the dequantized states
+            ref_param = param.clone()
+            ref_exp_avg = ref_avg.clone()
+            ref_exp_avg_sq = ref_avg_sq.clone()
+            if is_adam:
+                step = 10.0
+                fused_8bit = torch.ops.torch_ipex.adam_fused_step_8bit
+                torch.ops.torch_ipex.adam_fused_step(
+                    ref_param,
+                    ref_exp_avg,
+                    ref_exp_avg_sq,
+                    torch.Tensor(),
+                    grad,
+                    torch.Tensor(),
+                    False,
+                    step,
+                    *hyper_params
+                )
+            else:
+                step = 10
+                fused_8bit = torch.ops.torch_ipex.lamb_fused_step_8bit
+                torch.ops.torch_ipex.lamb_fused_step(
+                    ref_param,
+                    ref_exp_avg,
+                    ref_exp_avg_sq,
+                    grad,
+                    torch.Tensor(),
+                    step,
+                    *hyper_params
+                )
+
+            # fp32 and split bf16 params
+            split_param, trail = torch.ops.torch_ipex.split_float_bfloat16(param)
+            for p, p2, g in [
+                (param.clone(), torch.Tensor(), grad),
+                (split_param, trail, grad.bfloat16()),
+            ]:
+                q1, a1 = q_avg.clone(), avg_absmax.clone()
+                q2, a2 = q_avg_sq.clone(), avg_sq_absmax.clone()
+                fused_8bit(p, q1, a1, q2, a2, g, p2, step, *hyper_params)
+                if p.dtype == torch.bfloat16:
+                    p = torch.ops.torch_ipex.cat_bfloat16_float(p, p2)
+                self.assertEqual(p, ref_param, rtol=1e-2, atol=1e-2)
+                self.assertEqual(
+                    dequantize(q1, a1, False).view(31, 33),
+                    ref_exp_avg,
+                    rtol=0.05,
+                    atol=1e-2,
+                )
+                self.assertEqual(
+                    dequantize(q2, a2, True).view(31, 33),
+                    ref_exp_avg_sq,
+                    rtol=0.1,
+                    atol=1e-3,
+                )
+
+        # quantized optimizer states through the patched step
+        model = torch.nn.Linear(33, 31)
+        optimizer = torch.optim.Adam(model.parameters(), lr=0.01)
+        optimizer.param_groups[0]["quantized_state"] = True
+        model, optimizer = ipex.optimize(model, optimizer=optimizer)
+        for _ in range(3):
+            optimizer.zero_grad()
+            model(torch.randn(4, 33)).sum().backward()
+            optimizer.step()
+        for state in optimizer.state.values():
+            self.assertEqual(state["exp_avg"].dtype, torch.int8)
+            self.assertEqual(state["exp_avg_sq"].dtype, torch.uint8)
+
 
 class TestPatchedMethod(TestCase):
     def test_zero_grad(self):
@@ -2,6 +2,8 @@ import unittest
 from common_utils import TestCase
 import os
 import subprocess
+import torch
+import intel_extension_for_pytorch as ipex
 
 
 class TestProfiler(TestCase):
@@ -21,6 +23,41 @@ class TestProfiler(TestCase):
                     num = num + 1
         assert num == 2, "IPEX op profiling info not found."
 
+    def test_op_instrumentation(self):
+        model = torch.nn.Linear(64, 32).eval()
+        # the fp32 linear runs the prepacked MKL sgemm by default
+        model = ipex.optimize(model, dtype=torch.float32)
+        linear_scope = "MKLOpContext::run"
+        x = torch.randn(8, 64)
+        weight = torch.ones(64)
+        self.assertFalse(ipex._C._get_op_instrumentation_enabled())
+        ipex._C._reset_op_instrumentation()
+        ipex._C._set_op_instrumentation_enabled(True)
+        try:
+            with torch.no_grad():
+                for _ in range(3):
+                    model(x)
+                    torch.ops.torch_ipex.rmsnorm(x, weight, 1e-6)
+        finally:
+            ipex._C._set_op_instrumentation_enabled(False)
+        report = ipex._C._get_op_instrumentation_report(1000.0, 100.0)
+        lines = report.splitlines()
+        linear = [line for line in lines if line.startswith(linear_scope)]
+        self.assertEqual(len(linear), 1)
+        # op, shapes, calls, ..., GFLOP/s, GB/s, FLOP/B, bound, %roof
+        fields = linear[0].split()
+        self.assertEqual(fields[1], "Float[8,64]")
+        self.assertEqual(fields[2], "3")
+        self.assertIn(fields[-2], ["memory", "compute"])
+        self.assertTrue(any(line.startswith("rmsnorm_kernel_stub") for line in lines))
+
+        # nothing is recorded while disabled
+        ipex._C._reset_op_instrumentation()
+        with torch.no_grad():
+            model(x)
+        report = ipex._C._get_op_instrumentation_report()
+        self.assertNotIn(linear_scope, report)
+
 
 if __name__ == "__main__":
     test = unittest.main()
@@ -250,5 +250,78 @@ class TestRNNTEmbedding(TestCase):
             self.assertEqual(y_embed_org, y_embed)
 
 
+class TestRNNTGreedyDecode(TestCase):
+    def _test_org(self, x, out_lens, embedding, lstm, joint_pred, joint, blank_id):
+        # Greedy decode of each sample alone, as the reference RNN-T decoder
+        labels_list = []
+        for i in range(x.size(0)):
+            hidden = None
+            label = self._SOS
+            labels = []
+            for t in range(out_lens[i]):
+                f = x[i, t, :].unsqueeze(0)
+                symbols_added = 0
+                while symbols_added < self.max_symbols:
+                    y = torch.tensor([[label]], dtype=torch.long)
+                    y_embed = embedding(y.clamp(min=0)) * (y != self._SOS)
+                    g, hidden_prime = lstm(y_embed, hidden)
+                    logits = joint(torch.relu(f + joint_pred(g.squeeze(1))))
+                    k = logits.argmax(1).item()
+                    if k == blank_id:
+                        break
+                    labels.append(k)
+                    label = k
+                    hidden = hidden_prime
+                    symbols_added += 1
+            labels_list.append(labels)
+        return labels_list
+
+    def test_rnnt_greedy_decode(self):
+        self._SOS = -1
+        vocab_size = 29
+        blank_id = vocab_size - 1
+        pred_n_hidden = 32
+        joint_n_hidden = 48
+        batch_size = 5
+        time_step = 12
+        for num_layers, max_symbols in product([1, 2], [1, 3, 30]):
+            self.max_symbols = max_symbols
+            embedding = torch.nn.Embedding(vocab_size - 1, pred_n_hidden)
+            lstm = torch.nn.LSTM(
+                pred_n_hidden, pred_n_hidden, num_layers, batch_first=True
+            )
+            joint_pred = torch.nn.Linear(pred_n_hidden, joint_n_hidden)
+            joint = torch.nn.Linear(joint_n_hidden, vocab_size)
+            # x from the encoder in [time_step, batch_size, feature] layout
+            x = torch.randn(time_step, batch_size, joint_n_hidden).transpose(0, 1)
+            x_org = x.clone()
+            out_lens = torch.tensor([12, 1, 7, 0, 12], dtype=torch.int)
+
+            with torch.no_grad():
+                expected = self._test_org(
+                    x, out_lens, embedding, lstm, joint_pred, joint, blank_id
+                )
+                label_tensor, label_len = torch.ops.torch_ipex.rnnt_greedy_decode(
+                    x,
+                    out_lens,
+                    embedding.weight,
+                    lstm._flat_weights,
+                    True,
+                    num_layers,
+                    joint_pred.weight,
+                    joint_pred.bias,
+                    joint.weight,
+                    joint.bias,
+                    max_symbols,
+                    blank_id,
+                    self._SOS,
+                )
+            for i in range(batch_size):
+                labels = label_tensor[i, 1 : label_len[i] + 1].tolist()
+                self.assertEqual(labels, expected[i])
+            # the input is not modified
+            self.assertEqual(x, x_org)
+
+
 if __name__ == "__main__":
     test = unittest.main()
@@ -213,6 +213,62 @@ class RoIAlignTester(TestCase):
                 torch.allclose(gt_x.grad.to(x4.dtype), x4.grad, rtol=1e-5, atol=1e-5)
             )
 
+    def test_multi_level_roialign(self):
+        pool_size = 7
+        n_channels = 20
+        spatial_scales = [1 / 4, 1 / 8, 1 / 16, 1 / 32]
+        sizes = [64, 32, 16, 8]
+        rois = torch.tensor(
+            [
+                [0, 0, 0, 31, 31],  # format is (xyxy)
+                [0, 10, 20, 120, 100],
+                [1, 0, 0, 255, 255],
+                [1, 50, 60, 250, 200],
+                [0, 3, 3, 3, 3],
+                [1, 100, 30, 130, 60],
+            ],
+            dtype=torch.float32,
+        )
+        # Same level assignment as torchvision LevelMapper
+        area = (rois[:, 3] - rois[:, 1]) * (rois[:, 4] - rois[:, 2])
+        levels = torch.floor(4 + torch.log2(torch.sqrt(area) / 224) + 1e-6)
+        levels = torch.clamp(levels, min=2, max=5).to(torch.int64) - 2
+        for datatype in [torch.double, torch.float32, torch.bfloat16]:
+            features = [
+                torch.rand(2, n_channels, size, size).to(datatype) for size in sizes
+            ]
+            for aligned in [True, False]:
+                expected = torch.zeros(
+                    rois.size(0), n_channels, pool_size, pool_size, dtype=datatype
+                )
+                for level, scale in enumerate(spatial_scales):
+                    idx = torch.nonzero(levels == level).squeeze(1)
+                    if idx.numel() == 0:
+                        continue
+                    expected[idx] = fn(
+                        features[level],
+                        rois[idx].to(datatype),
+                        pool_size,
+                        pool_size,
+                        spatial_scale=scale,
+                        sampling_ratio=2,
+                        aligned=aligned,
+                    )
+                for memory_format in [torch.contiguous_format, torch.channels_last]:
+                    y = torch.ops.torch_ipex.multi_level_roi_align(
+                        [f.to(memory_format=memory_format) for f in features],
+                        rois,
+                        spatial_scales,
+                        pool_size,
+                        pool_size,
+                        2,
+                        aligned,
+                    )
+                    self.assertTrue(y.dtype == datatype)
+                    # box head layout, ready to flatten
+                    self.assertTrue(y.is_contiguous())
+                    self.assertEqual(y, expected, prec=1e-2)
+
     @skipIfNoTorchVision
     def test_torchvision_roialign(self):
         pool_size = 5
@@ -97,6 +97,48 @@ class TestCPUPool(TestCase):
         cpu_pool = ipex.cpu.runtime.CPUPool(core_list)
         self.assertEqual(cpu_pool.cpu_pool.get_core_list(), core_list)
 
+    @unittest.skipIf(
+        not ipex.cpu.runtime.is_runtime_ext_enabled(),
+        "Skip when IPEX Runtime extension is not enabled",
+    )
+    @runtime_thread_affinity_test_env
+    def test_cpupool_pin_affinity(self):
+        self.assertIn(ipex._C.get_runtime_ext_backend(), ["iomp", "native"])
+        core_list = ipex._C.get_process_available_cores()[:1]
+        with ipex.cpu.runtime.pin(ipex.cpu.runtime.CPUPool(core_list)):
+            self.assertTrue(ipex._C.is_same_core_affinity_setting(core_list))
+            self.assertEqual(os.sched_getaffinity(0), set(core_list))
+
+    def test_cpu_topology_pools(self):
+        available_cores = sorted(ipex._C.get_process_available_cores())
+        node_ids = ipex.cpu.runtime.get_numa_node_ids()
+        self.assertTrue(len(node_ids) > 0)
+        node_cores = []
+        for node_id in node_ids:
+            node_cores += ipex.cpu.runtime.get_core_list_of_node_id(
+                node_id, physical_cores_only=False
+            )
+        self.assertEqual(sorted(node_cores), available_cores)
+
+        physical_cores = ipex.cpu.runtime.get_physical_core_list()
+        self.assertTrue(set(physical_cores).issubset(available_cores))
+        l3_cores = sum(
+            ipex.cpu.runtime.get_core_lists_of_l3_cache(physical_cores_only=True), []
+        )
+        self.assertEqual(sorted(l3_cores), physical_cores)
+
+        cpu_pools = ipex.cpu.runtime.create_cpu_pools("numa_node")
+        self.assertEqual(len(cpu_pools), len(node_ids))
+        for node_id, cpu_pool in zip(node_ids, cpu_pools):
+            self.assertEqual(cpu_pool.cpu_pool.get_memory_numa_node(), node_id)
+            self.assertEqual(
+                cpu_pool.core_ids, ipex.cpu.runtime.get_core_list_of_node_id(node_id)
+            )
+        for cpu_pool in ipex.cpu.runtime.create_cpu_pools(
+            "l3_cache", bind_memory=False
+        ):
+            self.assertEqual(cpu_pool.cpu_pool.get_memory_numa_node(), -1)
+
 
 class TestCoreBinding(TestCase):
     @unittest.skipIf(
@@ -175,6 +175,41 @@ class TestJitRuntimeAPI(JitTestCase):
         self.assertEqual(y, y_runtime2)
 
 
+class TestJITMultiInstanceModule(JitTestCase):
+    @unittest.skipIf(
+        not ipex.cpu.runtime.is_runtime_ext_enabled(),
+        "Skip when IPEX Runtime extension is not enabled",
+    )
+    @runtime_thread_affinity_test_env
+    def test_multi_instance_module_shared_weight(self):
+        model = SimpleNet()
+        model.eval()
+        model = ipex.optimize(model, dtype=torch.float32)
+        x = torch.rand(16, 64, 3, 3)
+        with torch.no_grad():
+            trace_model = torch.jit.freeze(torch.jit.trace(model, x))
+            # warm up
+            y = trace_model(x)
+
+            core_list = ipex._C.get_process_available_cores()
+            cpu_pools = [
+                ipex.cpu.runtime.CPUPool(core_list[i : i + 1])
+                for i in range(min(2, len(core_list)))
+            ]
+            multi_instance_model = ipex.cpu.runtime.MultiInstanceModule(
+                trace_model, cpu_pools
+            )
+            inputs = [torch.rand(16, 64, 3, 3) for _ in range(8)]
+            futures = [multi_instance_model(input) for input in inputs]
+            for input, future in zip(inputs, futures):
+                self.assertEqual(future.get(), trace_model(input))
+            self.assertEqual(multi_instance_model.run_sync(x), y)
+            multi_instance_model.stop()
+            self.assertEqual(sum(multi_instance_model.get_num_finished_requests()), 9)
+            with self.assertRaises(RuntimeError):
+                multi_instance_model(x)
+
+
 class TestJITMultiStreamModule(JitTestCase):
     @unittest.skipIf(
         not ipex.cpu.runtime.is_runtime_ext_enabled(),
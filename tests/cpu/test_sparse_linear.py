@@ -0,0 +1,108 @@
+import itertools
+import unittest
+
+import torch
+import intel_extension_for_pytorch as ipex  # noqa: F401
+import intel_extension_for_pytorch._C as core
+from torch.testing._internal.jit_utils import JitTestCase
+
+SPARSE_LINEAR_RUN = "ipex_prepack::sparse_linear_run"
+
+
+def block_sparse_weight(out_features, in_features, sparsity):
+    # zero the 16 x 64 blocks of the packed format
+    weight = torch.randn(out_features, in_features)
+    out_blocks = (out_features + 15) // 16
+    in_blocks = (in_features + 63) // 64
+    num_zero_blocks = round(sparsity * out_blocks * in_blocks)
+    keep = torch.ones(out_blocks * in_blocks)
+    keep[torch.randperm(keep.numel())[:num_zero_blocks]] = 0
+    keep = keep.view(out_blocks, in_blocks)
+    mask = keep.repeat_interleave(16, 0).repeat_interleave(64, 1)
+    return weight * mask[:out_features, :in_features]
+
+
+def two_four_weight(out_features, in_features):
+    # keep the 2 largest of every 4 consecutive inputs
+    weight = torch.randn(out_features, in_features // 4, 4)
+    index = weight.abs().topk(2, dim=-1).indices
+    mask = torch.zeros_like(weight).scatter_(-1, index, 1)
+    return (weight * mask).reshape(out_features, in_features)
+
+
+class SparseLinear(torch.nn.Module):
+    def __init__(self, weight, bias):
+        super().__init__()
+        self.linear = torch.nn.Linear(weight.size(1), weight.size(0), bias)
+        with torch.no_grad():
+            self.linear.weight.copy_(weight)
+
+    def forward(self, x):
+        return torch.relu(self.linear(x))
+
+
+class TestSparseLinear(JitTestCase):
+    def _test_prepack(self, weight, sparse_format):
+        for dtype, use_bias, input_shape in itertools.product(
+            [torch.float, torch.bfloat16], [True, False], [(3,), (2, 7)]
+        ):
+            w = weight.to(dtype)
+            b = torch.randn(weight.size(0)) if use_bias else None
+            x = torch.randn(input_shape + (weight.size(1),)).to(dtype)
+            ctx = torch.ops.ipex_prepack.sparse_linear_prepack(w, b, sparse_format)
+            self.assertEqual(ctx.to_public(ctx.get_weight()), w)
+            y = torch.ops.ipex_prepack.sparse_linear_run(x, ctx)
+            ref = torch.nn.functional.linear(x.float(), w.float(), b)
+            self.assertEqual(y.dtype, dtype)
+            if dtype == torch.bfloat16:
+                self.assertEqual(y.float(), ref, rtol=1e-2, atol=1e-2)
+            else:
+                self.assertEqual(y, ref, rtol=1e-5, atol=1e-5)
+
+    def test_block_prepack(self):
+        # tails of the 16 outputs and 64 inputs of the blocks
+        for sparsity in [0.0, 0.5, 1.0]:
+            self._test_prepack(block_sparse_weight(40, 200, sparsity), "block")
+
+    def test_two_four_prepack(self):
+        self._test_prepack(two_four_weight(40, 72), "2:4")
+        with self.assertRaises(RuntimeError):
+            torch.ops.ipex_prepack.sparse_linear_prepack(
+                torch.randn(16, 64), None, "2:4"
+            )
+        with self.assertRaises(RuntimeError):
+            torch.ops.ipex_prepack.sparse_linear_prepack(
+                torch.randn(16, 64), None, "csr"
+            )
+
+    def test_jit_sparse_linear(self):
+        origin_threshold = core._get_jit_sparse_linear_threshold()
+        weights = [
+            (block_sparse_weight(48, 256, 0.75), 1),
+            (two_four_weight(48, 256), 1),
+            (torch.randn(48, 256), 0),
+        ]
+        x = torch.randn(5, 256)
+        try:
+            for threshold in [0.0, 0.5]:
+                core._set_jit_sparse_linear_threshold(threshold)
+                for (weight, num_sparse), bias in itertools.product(
+                    weights, [True, False]
+                ):
+                    model = SparseLinear(weight, bias).eval()
+                    with torch.no_grad():
+                        traced = torch.jit.freeze(torch.jit.trace(model, x))
+                        for _ in range(2):
+                            y = traced(x)
+                        self.assertEqual(y, model(x), rtol=1e-5, atol=1e-5)
+                    self.assertGraphContainsExactly(
+                        traced.graph_for(x),
+                        SPARSE_LINEAR_RUN,
+                        num_sparse if threshold > 0 else 0,
+                    )
+        finally:
+            core._set_jit_sparse_linear_threshold(origin_threshold)
+
+
+if __name__ == "__main__":
+    test = unittest.main()
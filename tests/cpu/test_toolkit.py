@@ -21,3 +21,24 @@ class ToolkitTester(TestCase):
         self.assertEqual(roc_auc_st, roc_auc_mt)
         self.assertEqual(roc_auc_st, roc_auc_mt_2)
         self.assertEqual(accuracy_st, accuracy_mt)
+
+    def test_streaming_metrics(self):
+        targets = torch.randint(0, 2, (10000,)).float()
+        # Quantize the scores so the histogram bins hold exact ties.
+        scores = torch.randint(1, 1024, (10000,)).float() / 1024
+        roc_auc, log_loss, accuracy = ipex._C.roc_auc_score_all(targets, scores)
+        metrics = ipex._C.StreamingMetrics(num_bins=1024)
+        for target, score in zip(targets.split(999), scores.split(999)):
+            metrics.update(target, score)
+        self.assertEqual(metrics.num_samples(), 10000)
+        roc_auc_s, log_loss_s, accuracy_s = metrics.compute()
+        self.assertEqual(roc_auc, roc_auc_s)
+        self.assertEqual(log_loss, log_loss_s)
+        self.assertEqual(accuracy, accuracy_s)
+
+        # Finer bins approximate the exact AUC of continuous scores.
+        scores = torch.rand(10000)
+        roc_auc = sklearn.metrics.roc_auc_score(targets.numpy(), scores.numpy())
+        metrics.reset()
+        metrics.update(targets, scores)
+        self.assertEqual(roc_auc, metrics.compute()[0], prec=1e-3)
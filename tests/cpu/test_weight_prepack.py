@@ -627,6 +627,99 @@ class TestPrepackCases(TestCase):
     def test_conv3d_nc11(self):
         self._test_conv_nc11_base(dim=3)
 
+    def test_conv2d_dynamic_input_shape(self):
+        class Conv2d(torch.nn.Module):
+            def __init__(self):
+                super(Conv2d, self).__init__()
+                self.conv = torch.nn.Conv2d(
+                    3, 16, kernel_size=3, stride=2, padding=1, bias=True
+                )
+
+            def forward(self, x):
+                return torch.relu(self.conv(x))
+
+        origin_capacity = core._get_conv_primitive_cache_capacity()
+        origin_bucket_size = core._get_conv_input_bucket_size()
+        input_shapes = [(1, 3, 32, 32), (1, 3, 41, 29), (2, 3, 40, 30), (1, 3, 41, 29)]
+        try:
+            for bucket_size, memory_format in itertools.product(
+                [0, 8], [torch.contiguous_format, torch.channels_last]
+            ):
+                core._set_conv_primitive_cache_capacity(2)
+                core._set_conv_input_bucket_size(bucket_size)
+                model = Conv2d().eval().to(memory_format=memory_format)
+                sample_input = torch.randn(input_shapes[0]).to(
+                    memory_format=memory_format
+                )
+                ipex_model = ipex.optimize(
+                    model, dtype=torch.float, level="O1", sample_input=sample_input
+                )
+                ctx = ipex_model.conv.ctx
+                ctx.clear_primitive_cache()
+                with torch.no_grad():
+                    for _ in range(2):
+                        for shape in input_shapes:
+                            x = torch.randn(shape).to(memory_format=memory_format)
+                            self.assertEqual(model(x), ipex_model(x))
+                # the prepacked shape doesn't take a cache entry, and the cache
+                # is bounded by its capacity
+                self.assertTrue(ctx.get_primitive_cache_size() <= 2)
+                core._set_conv_primitive_cache_capacity(0)
+                ctx.clear_primitive_cache()
+                with torch.no_grad():
+                    x = torch.randn(input_shapes[1]).to(memory_format=memory_format)
+                    self.assertEqual(model(x), ipex_model(x))
+                self.assertEqual(ctx.get_primitive_cache_size(), 0)
+        finally:
+            core._set_conv_primitive_cache_capacity(origin_capacity)
+            core._set_conv_input_bucket_size(origin_bucket_size)
+
+    def test_linear_dynamic_batch_size(self):
+        class L(torch.nn.Module):
+            def __init__(self):
+                super(L, self).__init__()
+                self.linear = torch.nn.Linear(16, 8, bias=True)
+
+            def forward(self, x):
+                return torch.relu(self.linear(x))
+
+        origin_capacity = core._get_linear_primitive_cache_capacity()
+        origin_bucket_size = core._get_linear_m_bucket_size()
+        input_shapes = [(3, 16), (5, 16), (2, 7, 16), (3, 16)]
+        try:
+            for bucket_size in [0, 8]:
+                core._set_linear_primitive_cache_capacity(8)
+                core._set_linear_m_bucket_size(bucket_size)
+                model = L().eval()
+                ipex_model = ipex.optimize(
+                    copy.deepcopy(model),
+                    dtype=torch.float,
+                    level="O1",
+                    auto_kernel_selection=True,
+                )
+                ctx = ipex_model.linear.ctx
+                ctx.clear_primitive_cache()
+                with torch.no_grad():
+                    for _ in range(2):
+                        for shape in input_shapes:
+                            x = torch.randn(shape)
+                            self.assertEqual(model(x), ipex_model(x))
+                hits, misses, size = ctx.get_primitive_cache_stats()
+                # M of 3 and 5 share the bucket of 8 rows
+                expected_size = 3 if bucket_size == 0 else 2
+                self.assertEqual(size, expected_size)
+                self.assertEqual(misses, expected_size)
+                self.assertEqual(hits, 2 * len(input_shapes) - expected_size)
+                core._set_linear_primitive_cache_capacity(0)
+                ctx.clear_primitive_cache()
+                with torch.no_grad():
+                    x = torch.randn(input_shapes[0])
+                    self.assertEqual(model(x), ipex_model(x))
+                self.assertEqual(ctx.get_primitive_cache_stats(), (0, 0, 0))
+        finally:
+            core._set_linear_primitive_cache_capacity(origin_capacity)
+            core._set_linear_m_bucket_size(origin_bucket_size)
+
     def _test_conv_serialization_base(self, dim):
         channels_last = torch.channels_last if dim == 2 else torch.channels_last_3d
         optimizer_options = [